@@ -522,6 +522,8 @@ typedef struct
 
   void (*Release)(stm_display_output_t *);
 
+  int  (*FlushMetadataRange)(stm_display_output_t*, stm_meta_data_type_t, TIME64 startTime, TIME64 endTime);
+
 } stm_display_output_ops_t;
 
 
@@ -848,6 +850,26 @@ static inline int stm_display_output_flush_metadata(stm_display_output_t *o, stm
 }
 
 
+/*
+ * int stm_display_output_flush_metadata_range(stm_display_output_t *o,
+ *                                             stm_meta_data_type_t t,
+ *                                             TIME64 start,
+ *                                             TIME64 end)
+ *
+ * Flush the entries of metadata type t with presentation times from start
+ * to end inclusive from the output's queue, leaving the others queued. For
+ * example a seek can drop the data queued for the stream it left without
+ * losing what has already been queued for the new position.
+ *
+ * Returns: -1 if the device lock cannot be obtained, otherwise it returns 0.
+ *
+ */
+static inline int stm_display_output_flush_metadata_range(stm_display_output_t *o, stm_meta_data_type_t t, TIME64 start, TIME64 end)
+{
+  return o->ops->FlushMetadataRange(o, t, start, end);
+}
+
+
 /*
  * int stm_display_output_set_filter_coefficients(stm_display_output_t *o,
  *                                                const stm_display_filter_setup_t *f);
@@ -45,16 +45,19 @@ HavanaDemux_c::~HavanaDemux_c(void)
 /// \brief Create and initialise all of the necessary player components for a new player stream
 /// \param Player The player
 /// \param PlayerPlayback The player playback to which the stream will be added
+/// \param Demultiplexor The demultiplexor owning the context.
 /// \param DemultiplexorContext Context variable used to manipulate the demultiplexor (TS).
 /// \return Havana status code, HavanaNoError indicates success.
 //}}}
 HavanaStatus_t HavanaDemux_c::Init(class Player_c *Player,
 				   PlayerPlayback_t PlayerPlayback,
+				   class Demultiplexor_c *Demultiplexor,
 				   DemultiplexorContext_t DemultiplexorContext)
 {
 	DEMUX_DEBUG("\n");
 	this->Player = Player;
 	this->PlayerPlayback = PlayerPlayback;
+	this->Demultiplexor = Demultiplexor;
 	this->DemuxContext = DemultiplexorContext;
 	if (OS_InitializeMutex(&InputLock) != OS_NO_ERROR)
 	{
@@ -73,7 +76,11 @@ HavanaStatus_t HavanaDemux_c::InjectData(const unsigned char *Data,
 	//OS_LockMutex (&InputLock);
 	Player->GetInjectBuffer(&Buffer);
 	Buffer->ObtainMetaDataReference(Player->MetaDataInputDescriptorType, (void **)&InputDescriptor);
-	InputDescriptor->MuxType = MuxTypeTransportStream;
+	// Same rule as the dvr uses to split BluRay packets for the kernel demux
+	if (((DataLength % 188) != 0) && ((DataLength % 192) == 0))
+		InputDescriptor->MuxType = MuxTypeBluRayTransportStream;
+	else
+		InputDescriptor->MuxType = MuxTypeTransportStream;
 	InputDescriptor->DemultiplexorContext = DemuxContext;
 	InputDescriptor->PlaybackTimeValid = false;
 	InputDescriptor->DecodeTimeValid = false;
@@ -85,4 +92,20 @@ HavanaStatus_t HavanaDemux_c::InjectData(const unsigned char *Data,
 	return HavanaNoError;
 }
 //}}}
-
+//{{{ SetClockRecoveryPid
+//{{{ doxynote
+/// \brief Nominate the pid whose PCRs the demultiplexor feeds to clock recovery
+/// \param Pid The PCR pid, DEMUX_INVALID_ID to stop
+/// \return Havana status code, HavanaNoError indicates success.
+//}}}
+HavanaStatus_t HavanaDemux_c::SetClockRecoveryPid(unsigned int Pid)
+{
+	DEMUX_DEBUG("%x\n", Pid);
+	if (Demultiplexor->SetClockRecoveryIdentifier(DemuxContext, Pid) != DemultiplexorNoError)
+	{
+		DEMUX_ERROR("Unable to set clock recovery pid %x\n", Pid);
+		return HavanaError;
+	}
+	return HavanaNoError;
+}
+//}}}
@@ -60,6 +60,7 @@ class HavanaDemux_c
 		class Player_c *Player;
 		PlayerPlayback_t PlayerPlayback;
 
+		class Demultiplexor_c *Demultiplexor;
 		DemultiplexorContext_t DemuxContext;
 
 	public:
@@ -69,9 +70,11 @@ class HavanaDemux_c
 
 		HavanaStatus_t Init(class Player_c *Player,
 				    PlayerPlayback_t PlayerPlayback,
+				    class Demultiplexor_c *Demultiplexor,
 				    DemultiplexorContext_t DemultiplexorContext);
 		HavanaStatus_t InjectData(const unsigned char *Data,
 					  unsigned int DataLength);
+		HavanaStatus_t SetClockRecoveryPid(unsigned int Pid);
 };
 
 #endif
@@ -33,6 +33,8 @@ HavanaPlayback_c::HavanaPlayback_c(void)
 	PlayerPlayback = NULL;
 	OutputCoordinator = NULL;
 	LockInitialised = false;
+	ClockRecoveryInitialized = false;
+	ClockRecoveryFormat = TimeFormatUs;
 }
 //}}}
 //{{{ ~HavanaPlayback_c
@@ -144,6 +146,7 @@ HavanaStatus_t HavanaPlayback_c::AddDemux(unsigned int DemuxId,
 	}
 	Status = Demux[DemuxId]->Init(Player,
 				      PlayerPlayback,
+				      Demultiplexor,
 				      DemuxContext);
 	if (Status != HavanaNoError)
 	{
@@ -420,6 +423,10 @@ HavanaStatus_t HavanaPlayback_c::SetOption(play_option_t Option,
 			PlayerPolicy = PolicySyncStartImmediate;
 			PolicyValue = Value;
 			break;
+		case PLAY_OPTION_SYNC_START_FAST:
+			PlayerPolicy = PolicySyncStartFast;
+			PolicyValue = Value;
+			break;
 		default:
 			PLAYBACK_ERROR("Unknown option %d\n", Option);
 			return HavanaError;
@@ -438,7 +445,18 @@ HavanaStatus_t HavanaPlayback_c::SetClockDataPoint(clock_data_point_t *DataPoint
 {
 	PlayerStatus_t Status;
 	PlayerTimeFormat_t SourceTimeFormat = (DataPoint->time_format == DVB_TIME_FORMAT_US) ? TimeFormatUs : TimeFormatPts;
-	Status = Player->ClockRecoveryInitialize(PlayerPlayback, SourceTimeFormat);
+	/* Initializing restarts the fit, so only do it for the first point or a change of format */
+	if (!ClockRecoveryInitialized || (ClockRecoveryFormat != SourceTimeFormat))
+	{
+		Status = Player->ClockRecoveryInitialize(PlayerPlayback, SourceTimeFormat);
+		if (Status != PlayerNoError)
+		{
+			PLAYBACK_ERROR("Unable to initialize clock recovery\n");
+			return HavanaError;
+		}
+		ClockRecoveryInitialized = true;
+		ClockRecoveryFormat = SourceTimeFormat;
+	}
 	Status = Player->ClockRecoveryDataPoint(PlayerPlayback, DataPoint->source_time, DataPoint->system_time);
 	if (Status != PlayerNoError)
 	{
@@ -81,6 +81,9 @@ class HavanaPlayback_c
 		class Player_c *Player;
 		PlayerPlayback_t PlayerPlayback;
 
+		bool ClockRecoveryInitialized; /* Application data points, initialized once per format */
+		PlayerTimeFormat_t ClockRecoveryFormat;
+
 	public:
 
 		HavanaPlayback_c(void);
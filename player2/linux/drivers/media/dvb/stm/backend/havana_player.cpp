@@ -631,6 +631,9 @@ void HavanaPlayer_c::EventSignalThread(void)
 					case EventNumberOfSamplesProcessedCreated:
 						Event.code = PLAYER_EVENT_NUMBER_OF_SAMPLES_PROCESSED;
 						break;
+					case EventDemuxStatisticsCreated:
+						Event.code = PLAYER_EVENT_DEMUX_STATISTICS_CREATED;
+						break;
 					case EventInputFormatChanged:
 						Event.code = PLAYER_EVENT_INPUT_FORMAT_CHANGED;
 						break;
@@ -859,6 +859,9 @@ HavanaStatus_t HavanaStream_c::MapOption(play_option_t Option,
 		case PLAY_OPTION_SYNC_START_IMMEDIATE:
 			*PlayerPolicy = PolicySyncStartImmediate;
 			break;
+		case PLAY_OPTION_SYNC_START_FAST:
+			*PlayerPolicy = PolicySyncStartFast;
+			break;
 		case PLAY_OPTION_EXTERNAL_TIME_MAPPING:
 			*PlayerPolicy = PolicyExternalTimeMapping;
 			break;
@@ -958,6 +961,12 @@ HavanaStatus_t HavanaStream_c::MapOption(play_option_t Option,
 		case PLAY_OPTION_USE_PTS_DEDUCED_DEFAULT_FRAME_RATES:
 			*PlayerPolicy = PolicyUsePTSDeducedDefaultFrameRates;
 			break;
+		case PLAY_OPTION_DISPLAY_QUEUE_TARGET_DEPTH:
+			*PlayerPolicy = PolicyDisplayQueueTargetDepth;
+			break;
+		case PLAY_OPTION_DISPLAY_QUEUE_MARGIN_THRESHOLD:
+			*PlayerPolicy = PolicyDisplayQueueMarginThreshold;
+			break;
 		case PLAY_OPTION_LOWER_CODEC_DECODE_LIMITS_ON_FRAME_DECODE_LATE:
 			STREAM_ERROR("Option PLAY_OPTION_LOWER_CODEC_DECODE_LIMITS_ON_FRAME_DECODE_LATE no longer supported\n");
 			return HavanaNoError;
@@ -1396,6 +1405,10 @@ HavanaStatus_t HavanaStream_c::CheckEvent(struct PlayerEventRecord_s *PlayerEven
 				StreamEvent.code = STREAM_EVENT_FATAL_HARDWARE_FAILURE;
 				StreamEvent.u.longlong = PlayerEvent->Value[0].LongLong;
 				break;
+			case EventDisplayQueueMarginLow:
+				StreamEvent.code = STREAM_EVENT_DISPLAY_QUEUE_MARGIN_LOW;
+				StreamEvent.u.longlong = PlayerEvent->Value[0].LongLong;
+				break;
 			default:
 				STREAM_DEBUG("Unexpected event %llx\n", PlayerEvent->Code);
 				StreamEvent.code = STREAM_EVENT_INVALID;
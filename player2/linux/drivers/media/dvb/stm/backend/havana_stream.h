@@ -58,7 +58,8 @@ Date Modification Name
 				EventFailedToDecodeInTime | EventFailedToDeliverDataInTime | \
 				EventTrickModeDomainChange | EventVsyncOffsetMeasured | \
 				EventFirstFrameManifested | EventStreamUnPlayable | \
-				EventOutputSizeChangeManifest | EventFatalHardwareFailure)
+				EventOutputSizeChangeManifest | EventFatalHardwareFailure | \
+				EventDisplayQueueMarginLow)
 
 #define MAX_SOURCE_WIDTH 1920
 #define MAX_SOURCE_HEIGHT 1088
@@ -72,6 +72,16 @@ int DemuxInjectData(demux_handle_t Demux,
 	return DataLength;
 }
 //}}}
+//{{{ DemuxSetClockRecoveryPid
+int DemuxSetClockRecoveryPid(demux_handle_t Demux,
+			     unsigned int Pid)
+{
+	class HavanaDemux_c *HavanaDemux = (class HavanaDemux_c *)Demux;
+	if (HavanaDemux->SetClockRecoveryPid(Pid) != HavanaNoError)
+		return -EINVAL;
+	return 0;
+}
+//}}}
 
 //{{{ PlaybackCreate
 int PlaybackCreate(playback_handle_t *Playback)
@@ -734,6 +744,8 @@ int ComponentGetAttribute(player_component_handle_t Component,
 	PlayerStatus_t Status;
 	PlayerAttributeDescriptor_t AttributeDescriptor;
 	//PLAYER_DEBUG("\n");
+	AttributeDescriptor.u.CharBuffer.Buffer = Value->CharBuffer.Buffer;
+	AttributeDescriptor.u.CharBuffer.Size = Value->CharBuffer.Size;
 	Status = PlayerComponent->GetAttribute(Attribute, &AttributeDescriptor);
 	if (Status != PlayerNoError)
 		return -EINVAL;
@@ -751,6 +763,9 @@ int ComponentGetAttribute(player_component_handle_t Component,
 		case SYSFS_ATTRIBUTE_ID_CONSTCHARPOINTER:
 			Value->ConstCharPointer = (char *)AttributeDescriptor.u.ConstCharPointer;
 			break;
+		case SYSFS_ATTRIBUTE_ID_CHARBUFFER:
+			Value->CharBuffer.Size = AttributeDescriptor.u.CharBuffer.Size;
+			break;
 		default:
 			PLAYER_ERROR("This attribute does not exist.\n");
 			return -EINVAL;
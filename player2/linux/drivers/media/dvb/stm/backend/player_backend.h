@@ -70,6 +70,8 @@ int PlaybackSetClockDataPoint(playback_handle_t Playback,
 int DemuxInjectData(demux_handle_t demux,
 		    const unsigned char *data,
 		    unsigned int data_length);
+int DemuxSetClockRecoveryPid(demux_handle_t demux,
+			     unsigned int pid);
 
 int StreamInjectData(stream_handle_t stream,
 		     const unsigned char *data,
@@ -84,6 +84,7 @@ static struct dvb_backend_operations DvbBackendOps =
 	.playback_set_clock_data_point = PlaybackSetClockDataPoint,
 
 	.demux_inject_data = DemuxInjectData,
+	.demux_set_clock_recovery_pid = DemuxSetClockRecoveryPid,
 
 	.stream_inject_data = StreamInjectData,
 	.stream_inject_data_packet = StreamInjectDataPacket,
@@ -382,6 +382,25 @@ int DvbPlaybackSetClockDataPoint(struct PlaybackContext_s *Playback,
 	return Result;
 }
 /*}}}*/
+/*{{{ DvbDemuxSetClockRecoveryPid*/
+/*
+ The player demultiplexor feeds the PCRs it finds on this pid to clock
+ recovery itself, DEMUX_INVALID_ID stops it.
+*/
+int DvbDemuxSetClockRecoveryPid(struct StreamContext_s *Demux,
+				unsigned int Pid)
+{
+	int Result = 0;
+	if (Backend->Ops == NULL)
+		return -ENODEV;
+	if ((Demux == NULL) || (Demux->Handle == NULL))
+		return -EINVAL;
+	Result = Backend->Ops->demux_set_clock_recovery_pid(Demux->Handle, Pid);
+	if (Result < 0)
+		BACKEND_ERROR("Unable to set clock recovery pid\n");
+	return Result;
+}
+/*}}}*/
 
 /*{{{ DvbStreamEnable*/
 int DvbStreamEnable(struct StreamContext_s *Stream,
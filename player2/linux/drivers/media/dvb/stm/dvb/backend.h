@@ -157,6 +157,8 @@ int DvbPlaybackGetPlayerEnvironment(struct PlaybackContext_s *Playback,
 				    playback_handle_t *playerplayback);
 int DvbPlaybackSetClockDataPoint(struct PlaybackContext_s *Playback,
 				 dvb_clock_data_point_t *ClockData);
+int DvbDemuxSetClockRecoveryPid(struct StreamContext_s *Demux,
+				unsigned int Pid);
 
 int DvbStreamEnable(struct StreamContext_s *Stream,
 		    unsigned int Enable);
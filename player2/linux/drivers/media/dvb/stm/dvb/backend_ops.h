@@ -150,6 +150,7 @@ typedef enum play_option_e
 	PLAY_OPTION_EXTERNAL_TIME_MAPPING_VSYNC_LOCKED = DVB_OPTION_EXTERNAL_TIME_MAPPING_VSYNC_LOCKED,
 	PLAY_OPTION_AV_SYNC = DVB_OPTION_AV_SYNC,
 	PLAY_OPTION_SYNC_START_IMMEDIATE = DVB_OPTION_SYNC_START_IMMEDIATE,
+	PLAY_OPTION_SYNC_START_FAST = DVB_OPTION_SYNC_START_FAST,
 	PLAY_OPTION_DISPLAY_FIRST_FRAME_EARLY = DVB_OPTION_DISPLAY_FIRST_FRAME_EARLY,
 	PLAY_OPTION_VIDEO_BLANK = DVB_OPTION_VIDEO_BLANK,
 	PLAY_OPTION_STREAM_ONLY_KEY_FRAMES = DVB_OPTION_STREAM_ONLY_KEY_FRAMES,
@@ -219,6 +220,9 @@ typedef enum play_option_e
 
 	PLAY_OPTION_USE_PTS_DEDUCED_DEFAULT_FRAME_RATES = DVB_OPTION_USE_PTS_DEDUCED_DEFAULT_FRAME_RATES,
 
+	PLAY_OPTION_DISPLAY_QUEUE_TARGET_DEPTH = DVB_OPTION_DISPLAY_QUEUE_TARGET_DEPTH,
+	PLAY_OPTION_DISPLAY_QUEUE_MARGIN_THRESHOLD = DVB_OPTION_DISPLAY_QUEUE_MARGIN_THRESHOLD,
+
 	PLAY_OPTION_MAX = DVB_OPTION_MAX
 
 } play_option_t;
@@ -285,6 +289,8 @@ struct picture_rectangle_s
 #define STREAM_EVENT_VSYNC_OFFSET_MEASURED VIDEO_EVENT_VSYNC_OFFSET_MEASURED /* Normally intercepted by DVP code */
 #define STREAM_EVENT_FATAL_ERROR VIDEO_EVENT_FATAL_ERROR
 #define STREAM_EVENT_FATAL_HARDWARE_FAILURE VIDEO_EVENT_FATAL_HARDWARE_FAILURE
+#define STREAM_EVENT_SCRAMBLING_CHANGED VIDEO_EVENT_SCRAMBLING_CHANGED /* Raised by the demux, not the player */
+#define STREAM_EVENT_DISPLAY_QUEUE_MARGIN_LOW VIDEO_EVENT_DISPLAY_QUEUE_MARGIN_LOW
 #define STREAM_EVENT_INVALID 0xffffffff
 
 struct stream_event_s
@@ -298,6 +304,7 @@ struct stream_event_s
 		unsigned int frame_rate; /* in frames per 1000sec */
 		reason_code_t reason;
 		unsigned int trick_mode_domain;
+		unsigned int scrambling;
 		unsigned long long longlong;
 	} u;
 };
@@ -374,6 +381,8 @@ struct dvb_backend_operations
 	int (*demux_inject_data)(demux_handle_t demux,
 				 unsigned const char *data,
 				 unsigned int data_length);
+	int (*demux_set_clock_recovery_pid)(demux_handle_t demux,
+					    unsigned int pid);
 	int (*stream_inject_data)(stream_handle_t stream,
 				  unsigned const char *data,
 				  unsigned int data_length);
@@ -457,6 +457,33 @@ static int AudioIoctlGetStatus(struct DeviceContext_s *Context, struct audio_sta
 	return 0;
 }
 /*}}}*/
+#ifdef __TDT__
+/*{{{ AudioIoctlGetScrambling*/
+static int AudioIoctlGetScrambling(struct DeviceContext_s *Context, unsigned int *Scrambling)
+{
+	unsigned long Flags;
+	spin_lock_irqsave(&Context->DvbContext->ScramblingLock, Flags);
+	*Scrambling = Context->AudioScrambling;
+	Context->AudioScramblingPending = 0;
+	spin_unlock_irqrestore(&Context->DvbContext->ScramblingLock, Flags);
+	return 0;
+}
+/*}}}*/
+/*{{{ AudioScramblingChanged*/
+/* Called by the demux when the scrambling state of an audio decoder pid
+ changes. The audio device has no event queue, so the state is kept for
+ AUDIO_GET_SCRAMBLING and pollers see POLLPRI until it has been read. */
+void AudioScramblingChanged(struct DeviceContext_s *Context, unsigned int Pid, unsigned int Scrambled)
+{
+	unsigned long Flags;
+	spin_lock_irqsave(&Context->DvbContext->ScramblingLock, Flags);
+	Context->AudioScrambling = (Pid & 0x1fff) | (Scrambled ? (1 << 16) : 0);
+	Context->AudioScramblingPending = 1;
+	spin_unlock_irqrestore(&Context->DvbContext->ScramblingLock, Flags);
+	wake_up_interruptible(&Context->AudioScramblingWait);
+}
+/*}}}*/
+#endif
 /*{{{ AudioIoctlGetCapabilities*/
 static int AudioIoctlGetCapabilities(struct DeviceContext_s *Context, int *Capabilities)
 {
@@ -910,8 +937,17 @@ static int AudioIoctl(struct inode *Inode,
 	int Result = 0;
 
 	/*DVB_DEBUG("AudioIoctl : Ioctl %08x\n", IoctlCode); */
-	if (((File->f_flags & O_ACCMODE) == O_RDONLY) && (IoctlCode != AUDIO_GET_STATUS))
+	if (((File->f_flags & O_ACCMODE) == O_RDONLY) && (IoctlCode != AUDIO_GET_STATUS)
+#ifdef __TDT__
+			&& (IoctlCode != AUDIO_GET_SCRAMBLING)
+#endif
+	   )
 		return -EPERM;
+#ifdef __TDT__
+	/* the scrambling state is kept by the demux, it needs no writer */
+	if (IoctlCode == AUDIO_GET_SCRAMBLING)
+		return AudioIoctlGetScrambling(Context, (unsigned int *)Parameter);
+#endif
 	if (!Context->AudioOpenWrite) /* Check to see that somebody has the device open for write */
 		return -EBADF;
 	mutex_lock(&(DvbContext->Lock));
@@ -1111,8 +1147,14 @@ static unsigned int AudioPoll(struct file *File, poll_table *Wait)
 	struct dvb_device *DvbDevice = (struct dvb_device *)File->private_data;
 	struct DeviceContext_s *Context = (struct DeviceContext_s *)DvbDevice->priv;
 	unsigned int Mask = 0;
+#ifdef __TDT__
+	/* scrambling changes are reported to readers too */
+	poll_wait(File, &Context->AudioScramblingWait, Wait);
+	if (Context->AudioScramblingPending)
+		Mask |= POLLPRI;
+#endif
 	if (((File->f_flags & O_ACCMODE) == O_RDONLY) || (Context->AudioStream == NULL))
-		return 0;
+		return Mask;
 #ifdef __TDT__
 	//TODO: Why is this true after seeking and never becomes false again?
 	// Is beeing reset at the end after nonblocking flush ioctl
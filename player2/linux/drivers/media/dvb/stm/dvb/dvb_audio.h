@@ -40,5 +40,8 @@ int AudioIoctlSetId(struct DeviceContext_s *Context,
 		    int Id);
 int AudioIoctlSetPlayInterval(struct DeviceContext_s *Context,
 			      audio_play_interval_t *PlayInterval);
+#ifdef __TDT__
+void AudioScramblingChanged(struct DeviceContext_s *Context, unsigned int Pid, unsigned int Scrambled);
+#endif
 
 #endif
@@ -46,6 +46,7 @@ Date Modification Name
 #include "dvb_audio.h"
 #include "dvb_video.h"
 #include "dvb_dmux.h"
+#include "dvb_section.h"
 #include "backend.h"
 
 #ifdef __TDT__
@@ -82,6 +83,9 @@ enum
 
 extern void stm_tsm_init(int cfg);
 extern int reset_tsm;
+#ifdef __TDT__
+extern int bulkDemux;
+#endif
 
 /* >>> DVB-T USB */
 /* j00zek comment: To enable DVB-T USB we need to integrate it with player2. take demuxes from it and inject data through SWTS
@@ -240,6 +244,23 @@ int StartFeed(struct dvb_demux_feed *Feed)
 				break;
 			}
 #endif
+			/* The player demux recovers the clock from the PCRs itself, the
+			 system clock only follows it with PolicyMasterClock set to the
+			 system clock (DVB_OPTION_MASTER_CLOCK) */
+			if (Feed->pes_type == DMX_TS_PES_PCR)
+			{
+				mutex_lock(&(DvbContext->Lock));
+#ifdef __TDT__
+				/* collect the pid, writeToDecoder() passes it to the player */
+				Context->numRunningFeeds++;
+				stpti_start_feed(Feed, Context);
+#endif
+				Context->PcrPid = Feed->pid;
+				if (Context->DemuxStream != NULL)
+					DvbDemuxSetClockRecoveryPid(Context->DemuxStream, Context->PcrPid);
+				mutex_unlock(&(DvbContext->Lock));
+				return 0;
+			}
 			if (!Audio && !Video)
 			{
 #ifdef __TDT__
@@ -305,6 +326,8 @@ int StartFeed(struct dvb_demux_feed *Feed)
 					mutex_unlock(&(DvbContext->Lock));
 					return Result;
 				}
+				if (Context->PcrPid != DEMUX_INVALID_ID)
+					DvbDemuxSetClockRecoveryPid(Context->DemuxStream, Context->PcrPid);
 			}
 #ifdef __TDT__
 			if (Video)
@@ -420,6 +443,14 @@ int StopFeed(struct dvb_demux_feed *Feed)
 	switch (Feed->type)
 	{
 		case DMX_TYPE_TS:
+			if ((Feed->pes_type == DMX_TS_PES_PCR) && (Feed->pid == Context->PcrPid))
+			{
+				mutex_lock(&(DvbContext->Lock));
+				Context->PcrPid = DEMUX_INVALID_ID;
+				if (Context->DemuxStream != NULL)
+					DvbDemuxSetClockRecoveryPid(Context->DemuxStream, DEMUX_INVALID_ID);
+				mutex_unlock(&(DvbContext->Lock));
+			}
 #ifdef __TDT__
 			for (i = 0; i < DVB_MAX_DEVICES_PER_ADAPTER; i++)
 			{
@@ -469,7 +500,15 @@ int StopFeed(struct dvb_demux_feed *Feed)
 					break;
 				}
 				else if (Feed->pes_type == DMX_TS_PES_PCR)
+				{
+					mutex_lock(&(DvbContext->Lock));
+					stpti_stop_feed(Feed, Context);
+					Context->numRunningFeeds--;
+					mutex_unlock(&(DvbContext->Lock));
+					if (Context->numRunningFeeds < 0)
+						printk(KERN_ERR "%s: numRunningFeeds < 0: %d\n", __func__, Context->numRunningFeeds);
 					break;
+				}
 			}
 			if (i >= DVB_MAX_DEVICES_PER_ADAPTER)
 			{
@@ -592,6 +631,13 @@ void demultiplexDvbPackets(struct dvb_demux *demux, const u8 *buf, int count)
 	dvb_dmx_swfilter_packets(demux, buf, count);
 }
 
+void demultiplexDvbPacketVector(struct dvb_demux *demux, const u8 **packets, int count)
+{
+	int n;
+	for (n = 0; n < count; n++)
+		dvb_dmx_swfilter_packets(demux, packets[n], 1);
+}
+
 #else
 
 /*{{{ WriteToDecoder*/
@@ -612,55 +658,183 @@ int WriteToDecoder(struct dvb_demux_feed *Feed, const u8 *buf, size_t count)
 		Context->provideToDecoder = 1;
 		Context->feedPesType = Feed->pes_type;
 	}
+	/* A pcr on a pid of its own goes to the player demux for clock
+	 recovery, unless an audio or video feed already takes the packets */
+	else if ((Feed->type == DMX_TYPE_TS) && (Feed->pes_type == (enum dmx_ts_pes)DMX_TS_PES_PCR) &&
+			(Feed->pid == Context->PcrPid) && !Context->provideToDecoder)
+	{
+		Context->provideToDecoder = 1;
+		Context->feedPesType = Feed->pes_type;
+	}
 	return 0;
 }
 /*}}} */
 
-int writeToDecoder(struct dvb_demux *demux, int pes_type, const u8 *buf, size_t count)
+static inline u16 ts_pid(const u8 *buf)
+{
+	return ((buf[1] & 0x1f) << 8) + buf[2];
+}
+
+static inline int ts_scrambled(const u8 *buf)
+{
+	return (buf[3] & 0xc0) != 0;
+}
+
+/* The caller works out whether any of the packets is scrambled while it
+ walks them to group them, so the payload is not touched a second time.
+ All the packets carry the same pid. */
+int writeToDecoder(struct dvb_demux *demux, int pes_type, const u8 *buf, size_t count, int scrambled)
 {
 	struct DeviceContext_s *Context = (struct DeviceContext_s *)demux->priv;
-	int j = 3;
+	unsigned long flags;
+	int video;
+	u16 pid = ts_pid(buf);
+	/* pcr packets go to the demux stream the pcr pid was nominated on */
+	if (pes_type == DMX_TS_PES_PCR)
+	{
+		if (scrambled || (Context->DemuxStream == NULL))
+			return count;
+		return DvbStreamInject(Context->DemuxStream, buf, count);
+	}
 	/* select the context */
 	/* no more than two output devices supported */
-	/* don't inject if playback is stopped */
 	switch (pes_type)
 	{
 		case DMX_PES_AUDIO0:
-			Context = &Context->DvbContext->DeviceContext[0];
-			if (Context->AudioState.play_state == AUDIO_STOPPED)
-				return count;
-			break;
 		case DMX_PES_VIDEO0:
 			Context = &Context->DvbContext->DeviceContext[0];
-			if (Context->VideoState.play_state == VIDEO_STOPPED)
-				return count;
 			break;
 		case DMX_PES_AUDIO1:
-			Context = &Context->DvbContext->DeviceContext[1];
-			if (Context->AudioState.play_state == AUDIO_STOPPED)
-				return count;
-			break;
 		case DMX_PES_VIDEO1:
 			Context = &Context->DvbContext->DeviceContext[1];
-			if (Context->VideoState.play_state == VIDEO_STOPPED)
-				return count;
 			break;
 		default:
 			return 0;
 	}
-	/* injecting scrambled data crashes the player */
-	while (j < count)
+	video = ((pes_type == DMX_PES_VIDEO0) || (pes_type == DMX_PES_VIDEO1));
+	/* tell the application when the decoder input becomes scrambled or
+	 clear, by reportScramblingChanges() once the inject mutex is dropped */
+	spin_lock_irqsave(&Context->DvbContext->ScramblingLock, flags);
+	if ((Context->Scrambling[video].pid != pid) || (Context->Scrambling[video].scrambled != scrambled))
 	{
-		if ((buf[j] & 0xc0) > 0)
-			return count;
-		j += 188;
+		Context->Scrambling[video].pid = pid;
+		Context->Scrambling[video].scrambled = scrambled;
+		Context->Scrambling[video].changed = 1;
 	}
+	spin_unlock_irqrestore(&Context->DvbContext->ScramblingLock, flags);
+	/* don't inject if playback is stopped */
+	if (video ? (Context->VideoState.play_state == VIDEO_STOPPED) : (Context->AudioState.play_state == AUDIO_STOPPED))
+		return count;
+	/* injecting scrambled data crashes the player */
+	if (scrambled)
+		return count;
 	return DvbStreamInject(Context->DemuxContext->DemuxStream, buf, count);
 }
 
-static inline u16 ts_pid(const u8 *buf)
+/* Raise the scrambling events recorded by writeToDecoder(), on the video
+ device for video and the audio device for audio. Called without the
+ inject mutex, from the PTI injector thread, DvrWrite() and the dvr
+ worker, which may all run at once. Each change is taken, with its
+ pid and state, under the ScramblingLock so it is reported only once. */
+static void reportScramblingChanges(struct DeviceContext_s *Context)
 {
-	return ((buf[1] & 0x1f) << 8) + buf[2];
+	struct DvbContext_s *DvbContext = Context->DvbContext;
+	struct DeviceContext_s *Device;
+	unsigned long flags;
+	int changed[2];
+	u16 pid[2];
+	int scrambled[2];
+	int d, v;
+	for (d = 0; d < 2; d++)
+	{
+		Device = &DvbContext->DeviceContext[d];
+		spin_lock_irqsave(&DvbContext->ScramblingLock, flags);
+		for (v = 0; v < 2; v++)
+		{
+			changed[v] = Device->Scrambling[v].changed;
+			pid[v] = Device->Scrambling[v].pid;
+			scrambled[v] = Device->Scrambling[v].scrambled;
+			Device->Scrambling[v].changed = 0;
+		}
+		spin_unlock_irqrestore(&DvbContext->ScramblingLock, flags);
+		if (changed[1])
+			VideoScramblingChanged(Device, pid[1], scrambled[1]);
+		if (changed[0])
+			AudioScramblingChanged(Device, pid[0], scrambled[0]);
+	}
+}
+
+/* Bulk mode: the whole block goes through the kernel demuxer at once, then
+ the packets of each running decoder feed are gathered and injected with a
+ single call. The decoder feeds are looked up in the demuxer's feed list
+ rather than signalled by the callback, which cannot tell which packets it
+ was called for. */
+static void demultiplexDvbPacketsBulk(struct dvb_demux *demux, const u8 *buf, int count)
+{
+	struct DeviceContext_s *Context = (struct DeviceContext_s *)demux->priv;
+	struct dvb_demux_feed *Feed;
+	struct
+	{
+		u16 pid;
+		int pesType;
+	} decoder[5];
+	int decoders, d, n, cnt, len, scrambled;
+	unsigned long flags;
+	while (count > 0)
+	{
+		cnt = (count > DVB_BULK_DEMUX_PACKETS) ? DVB_BULK_DEMUX_PACKETS : count;
+		mutex_lock_interruptible(&Context->injectMutex);
+		dvb_dmx_swfilter_packets(demux, buf, cnt);
+		decoders = 0;
+		spin_lock_irqsave(&demux->lock, flags);
+		list_for_each_entry(Feed, &demux->feed_list, list_head)
+		{
+			if ((Feed->type == DMX_TYPE_TS) && (Feed->state == DMX_STATE_GO) && (decoders < 4) &&
+					((Feed->pes_type == (enum dmx_ts_pes)DMX_PES_AUDIO0) ||
+					 (Feed->pes_type == (enum dmx_ts_pes)DMX_PES_VIDEO0) ||
+					 (Feed->pes_type == (enum dmx_ts_pes)DMX_PES_AUDIO1) ||
+					 (Feed->pes_type == (enum dmx_ts_pes)DMX_PES_VIDEO1)))
+			{
+				decoder[decoders].pid = Feed->pid;
+				decoder[decoders].pesType = Feed->pes_type;
+				decoders++;
+			}
+		}
+		spin_unlock_irqrestore(&demux->lock, flags);
+		/* and the pcr pid, unless it is one of the decoder pids */
+		if (Context->PcrPid != DEMUX_INVALID_ID)
+		{
+			for (d = 0; d < decoders; d++)
+				if (decoder[d].pid == Context->PcrPid)
+					break;
+			if (d == decoders)
+			{
+				decoder[decoders].pid = Context->PcrPid;
+				decoder[decoders].pesType = DMX_TS_PES_PCR;
+				decoders++;
+			}
+		}
+		for (d = 0; d < decoders; d++)
+		{
+			len = 0;
+			scrambled = 0;
+			for (n = 0; n < cnt; n++)
+			{
+				if (ts_pid(&buf[n * 188]) == decoder[d].pid)
+				{
+					scrambled |= ts_scrambled(&buf[n * 188]);
+					memcpy(&Context->bulkBuffer[len], &buf[n * 188], 188);
+					len += 188;
+				}
+			}
+			if (len > 0)
+				writeToDecoder(demux, decoder[d].pesType, Context->bulkBuffer, len, scrambled);
+		}
+		mutex_unlock(&Context->injectMutex);
+		reportScramblingChanges(Context);
+		buf += cnt * 188;
+		count -= cnt;
+	}
 }
 
 void demultiplexDvbPackets(struct dvb_demux *demux, const u8 *buf, int count)
@@ -668,8 +842,22 @@ void demultiplexDvbPackets(struct dvb_demux *demux, const u8 *buf, int count)
 	int first = 0;
 	int next = 0;
 	int cnt = 0;
+	int scrambled;
 	u16 pid, firstPid;
 	struct DeviceContext_s *Context = (struct DeviceContext_s *)demux->priv;
+	struct DvbSectionPid_s *SectionPid = NULL;
+	int n;
+	if (bulkDemux && (Context->bulkBuffer != NULL))
+	{
+		demultiplexDvbPacketsBulk(demux, buf, count);
+		return;
+	}
+	if (Context->SectionEngine != NULL)
+	{
+		mutex_lock_interruptible(&Context->injectMutex);
+		DvbSectionScan(Context->SectionEngine, demux);
+		mutex_unlock(&Context->injectMutex);
+	}
 	/* Group the packets by the PIDs and feed them into the kernel demuxer.
 	 If there is data for the decoder we will be informed via the callback.
 	 After the demuxer finished its work on the packet block that block is
@@ -680,17 +868,32 @@ void demultiplexDvbPackets(struct dvb_demux *demux, const u8 *buf, int count)
 	{
 		first = next;
 		cnt = 0;
+		scrambled = 0;
 		firstPid = ts_pid(&buf[first]);
 		while (count > 0)
 		{
 			count--;
+			scrambled |= ts_scrambled(&buf[next]);
 			next += 188;
 			cnt++;
+			/* don't look past the last packet */
+			if ((count == 0) || (cnt > 8))
+				break;
 			pid = ts_pid(&buf[next]);
-			if ((pid != firstPid) || (cnt > 8))
+			if (pid != firstPid)
 				break;
 		}
-		if ((next - first) > 0)
+		if (Context->SectionEngine != NULL)
+			SectionPid = DvbSectionLookup(Context->SectionEngine, firstPid);
+		if (SectionPid != NULL)
+		{
+			/* sections only, assembled and filtered by the engine */
+			mutex_lock_interruptible(&Context->injectMutex);
+			for (n = 0; n < cnt; n++)
+				DvbSectionPacket(Context->SectionEngine, demux, SectionPid, buf + first + (n * 188));
+			mutex_unlock(&Context->injectMutex);
+		}
+		else if ((next - first) > 0)
 		{
 			mutex_lock_interruptible(&Context->injectMutex);
 			/* reset the flag (to be set by the callback */
@@ -699,11 +902,83 @@ void demultiplexDvbPackets(struct dvb_demux *demux, const u8 *buf, int count)
 			if (Context->provideToDecoder)
 			{
 				/* the demuxer indicated that the packets are for the decoder */
-				writeToDecoder(demux, Context->feedPesType, buf + first, next - first);
+				writeToDecoder(demux, Context->feedPesType, buf + first, next - first, scrambled);
 			}
 			mutex_unlock(&Context->injectMutex);
+			reportScramblingChanges(Context);
 		}
 	}
+	if (Context->SectionEngine != NULL)
+	{
+		mutex_lock_interruptible(&Context->injectMutex);
+		DvbSectionFlush(Context->SectionEngine, demux);
+		mutex_unlock(&Context->injectMutex);
+	}
+}
+
+/* As above, but the packets are left where the PTI put them and are
+ passed as a vector of pointers. Only a group the demuxer hands on to
+ the decoder is gathered into a contiguous block, everything else
+ (sections, recordings) is filtered in place.
+ Called from the PTI injector thread and from the dvr (DvrWrite() and the
+ async worker) at the same time, so each device gathers into its own
+ buffer, under its inject mutex. */
+void demultiplexDvbPacketVector(struct dvb_demux *demux, const u8 **packets, int count)
+{
+	int first = 0;
+	int next = 0;
+	int n;
+	int scrambled;
+	u16 firstPid;
+	struct DeviceContext_s *Context = (struct DeviceContext_s *)demux->priv;
+	struct DvbSectionPid_s *SectionPid = NULL;
+	if (Context->SectionEngine != NULL)
+	{
+		mutex_lock_interruptible(&Context->injectMutex);
+		DvbSectionScan(Context->SectionEngine, demux);
+		mutex_unlock(&Context->injectMutex);
+	}
+	while (next < count)
+	{
+		first = next;
+		firstPid = ts_pid(packets[first]);
+		do
+			next++;
+		while ((next < count) && ((next - first) < 9) && (ts_pid(packets[next]) == firstPid));
+		if (Context->SectionEngine != NULL)
+			SectionPid = DvbSectionLookup(Context->SectionEngine, firstPid);
+		if (SectionPid != NULL)
+		{
+			mutex_lock_interruptible(&Context->injectMutex);
+			for (n = first; n < next; n++)
+				DvbSectionPacket(Context->SectionEngine, demux, SectionPid, packets[n]);
+			mutex_unlock(&Context->injectMutex);
+			continue;
+		}
+		mutex_lock_interruptible(&Context->injectMutex);
+		/* reset the flag (to be set by the callback */
+		Context->provideToDecoder = 0;
+		for (n = first; n < next; n++)
+			dvb_dmx_swfilter_packets(demux, packets[n], 1);
+		if (Context->provideToDecoder)
+		{
+			scrambled = 0;
+			for (n = first; n < next; n++)
+			{
+				scrambled |= ts_scrambled(packets[n]);
+				memcpy(&Context->gatherBuffer[(n - first) * 188], packets[n], 188);
+			}
+			writeToDecoder(demux, Context->feedPesType, Context->gatherBuffer, (next - first) * 188, scrambled);
+		}
+		mutex_unlock(&Context->injectMutex);
+		reportScramblingChanges(Context);
+	}
+	if (Context->SectionEngine != NULL)
+	{
+		mutex_lock_interruptible(&Context->injectMutex);
+		DvbSectionFlush(Context->SectionEngine, demux);
+		mutex_unlock(&Context->injectMutex);
+	}
 }
 #endif
 #endif
@@ -43,8 +43,13 @@ Date Modification Name
 
 #ifdef __TDT__
 #include <linux/delay.h>
+#include <linux/kthread.h>
+#include <linux/mm.h>
+#include <linux/vmalloc.h>
+#include <linux/poll.h>
 
 extern void demultiplexDvbPackets(struct dvb_demux *demux, const u8 *buf, int count);
+extern void demultiplexDvbPacketVector(struct dvb_demux *demux, const u8 **packets, int count);
 extern int stm_tsm_inject_user_data(const char __user *data, off_t size);
 #endif
 
@@ -57,6 +62,11 @@ static ssize_t DvrWrite(struct file *File,
 			size_t Count,
 			loff_t *ppos);
 
+#ifdef __TDT__
+static unsigned int DvrPoll(struct file *File,
+			    poll_table *Wait);
+#endif
+
 static struct file_operations OriginalDvrFops;
 static struct file_operations DvrFops;
 
@@ -73,6 +83,44 @@ static struct dvb_device DvrDevice =
 
 #ifdef __TDT__
 extern int swts;
+
+/*
+ * Asynchronous injection. When the dvr is opened non blocking for writing
+ * and dvrAsync is set, a write pins the user pages, hands them to the
+ * device's dvr worker and returns at once. The worker feeds the demux in
+ * packet aligned chunks, holding DmxDevice->mutex for one chunk at a time,
+ * and waits itself while the video is frozen. BluRay chunks are also
+ * injected into the player demux, as the synchronous write does. The
+ * buffer belongs to the driver until poll() reports POLLOUT again; a
+ * further write before that returns -EAGAIN.
+ */
+#define DVR_ASYNC_MAX_PAGES 64
+#define DVR_ASYNC_CHUNK_PACKETS 64
+#define DVR_ASYNC_FREEZE_WAIT 40 /* ms, one full frame */
+
+/* Async->State, claimed by a writer with atomic_cmpxchg */
+#define DVR_ASYNC_IDLE 0
+#define DVR_ASYNC_FILLING 1 /* a writer is pinning a buffer */
+#define DVR_ASYNC_QUEUED 2 /* the pinned buffer is owned by the worker */
+
+static int dvrAsync = 0;
+module_param(dvrAsync, int, S_IRUGO | S_IWUSR);
+MODULE_PARM_DESC(dvrAsync, "Inject non blocking dvr writes from a worker thread without copying.\n");
+
+struct DvrAsync_s
+{
+	struct task_struct *Thread;
+	wait_queue_head_t WaitQueue; /* the worker waits for a buffer, writers and poll for it to be consumed */
+	atomic_t State;
+	struct page *Pages[DVR_ASYNC_MAX_PAGES];
+	int NumPages;
+	void *Mapping; /* kernel mapping of the pinned pages */
+	const u8 *Data;
+	size_t Size;
+	int PacketSize; /* 188, or 192 for BluRay (M2TS) */
+	struct dmxdev *DmxDevice;
+	struct dvb_demux *DvbDemux;
+};
 #endif
 
 struct dvb_device *DvrInit(const struct file_operations *KernelDvrFops)
@@ -88,9 +136,195 @@ struct dvb_device *DvrInit(const struct file_operations *KernelDvrFops)
 	DvrFops.open = DvrOpen;
 	DvrFops.release = DvrRelease;
 	DvrFops.write = DvrWrite;
+#ifdef __TDT__
+	DvrFops.poll = DvrPoll;
+#endif
 	return &DvrDevice;
 }
 
+#ifdef __TDT__
+/*{{{ DvrAsyncUnpin*/
+static void DvrAsyncUnpin(struct DvrAsync_s *Async)
+{
+	int n;
+	if (Async->Mapping != NULL)
+		vunmap(Async->Mapping);
+	Async->Mapping = NULL;
+	for (n = 0; n < Async->NumPages; n++)
+		put_page(Async->Pages[n]);
+	Async->NumPages = 0;
+}
+/*}}}*/
+
+/*{{{ DvrAsyncVideoFrozen*/
+/* The video is paused and already holds enough decoded frames, injecting
+ more would only fill the decode buffers (first timeshift start) */
+static int DvrAsyncVideoFrozen(struct DeviceContext_s *Context)
+{
+	struct DeviceContext_s *Context0 = &Context->DvbContext->DeviceContext[0];
+	int NumberOfBuffers = 0;
+	int BuffersInUse = 0;
+	if ((Context0->VideoStream == NULL) || (Context0->VideoState.play_state != VIDEO_FREEZED))
+		return 0;
+	DvbStreamGetDecodeBufferPoolStatus(Context0->VideoStream, &NumberOfBuffers, &BuffersInUse);
+	return (BuffersInUse > 5);
+}
+/*}}}*/
+
+/*{{{ DvrAsyncInject*/
+static void DvrAsyncInject(struct DeviceContext_s *Context, struct DvrAsync_s *Async)
+{
+	const u8 *Packets[DVR_ASYNC_CHUNK_PACKETS];
+	size_t Offset = 0;
+	int Count, n;
+	while ((Offset < Async->Size) && !kthread_should_stop())
+	{
+		if (DvrAsyncVideoFrozen(Context))
+		{
+			wait_event_interruptible_timeout(Async->WaitQueue, kthread_should_stop(),
+							 msecs_to_jiffies(DVR_ASYNC_FREEZE_WAIT));
+			continue;
+		}
+		Count = min((int)((Async->Size - Offset) / Async->PacketSize), DVR_ASYNC_CHUNK_PACKETS);
+		mutex_lock(&Async->DmxDevice->mutex);
+		if (Async->PacketSize == TRANSPORT_PACKET_SIZE)
+			demultiplexDvbPackets(Async->DvbDemux, Async->Data + Offset, Count);
+		else
+		{
+			/* skip the four byte arrival time stamp of each packet by stride */
+			for (n = 0; n < Count; n++)
+				Packets[n] = Async->Data + Offset + (n * BLUERAY_PACKET_SIZE) + 4;
+			demultiplexDvbPacketVector(Async->DvbDemux, Packets, Count);
+		}
+		mutex_unlock(&Async->DmxDevice->mutex);
+		if ((Async->PacketSize == BLUERAY_PACKET_SIZE) && (Context->DemuxStream != NULL))
+		{
+			mutex_lock(&(Context->VideoWriteLock));
+			DvbStreamInject(Context->DemuxStream, Async->Data + Offset, Count * BLUERAY_PACKET_SIZE);
+			mutex_unlock(&(Context->VideoWriteLock));
+		}
+		Offset += Count * Async->PacketSize;
+	}
+}
+/*}}}*/
+
+/*{{{ DvrAsyncThread*/
+static int DvrAsyncThread(void *Data)
+{
+	struct DeviceContext_s *Context = (struct DeviceContext_s *)Data;
+	struct DvrAsync_s *Async = Context->DvrAsync;
+	while (!kthread_should_stop())
+	{
+		wait_event_interruptible(Async->WaitQueue,
+					 (atomic_read(&Async->State) == DVR_ASYNC_QUEUED) || kthread_should_stop());
+		if (atomic_read(&Async->State) != DVR_ASYNC_QUEUED)
+			continue;
+		smp_rmb();
+		DvrAsyncInject(Context, Async);
+		DvrAsyncUnpin(Async);
+		smp_wmb();
+		atomic_set(&Async->State, DVR_ASYNC_IDLE);
+		wake_up_interruptible(&Async->WaitQueue);
+	}
+	return 0;
+}
+/*}}}*/
+
+/*{{{ DvrAsyncWrite*/
+static ssize_t DvrAsyncWrite(struct DeviceContext_s *Context, struct dmxdev *DmxDevice, struct dvb_demux *DvbDemux,
+			     const char __user *Buffer, size_t Count, int PacketSize)
+{
+	struct DvrAsync_s *Async = Context->DvrAsync;
+	unsigned long Start = (unsigned long)Buffer;
+	int NumPages;
+	int Result;
+	if (atomic_cmpxchg(&Async->State, DVR_ASYNC_IDLE, DVR_ASYNC_FILLING) != DVR_ASYNC_IDLE)
+		return -EAGAIN;
+	/* take as many whole packets as the pinning window allows */
+	Count = min(Count, (size_t)((DVR_ASYNC_MAX_PAGES - 1) * PAGE_SIZE));
+	Count -= Count % PacketSize;
+	NumPages = (PAGE_ALIGN(Start + Count) - (Start & PAGE_MASK)) >> PAGE_SHIFT;
+	down_read(&current->mm->mmap_sem);
+	Result = get_user_pages(current, current->mm, Start, NumPages, READ, 0, Async->Pages, NULL);
+	up_read(&current->mm->mmap_sem);
+	Async->NumPages = (Result > 0) ? Result : 0;
+	if (Result < NumPages)
+	{
+		DvrAsyncUnpin(Async);
+		atomic_set(&Async->State, DVR_ASYNC_IDLE);
+		return -EFAULT;
+	}
+	Async->Mapping = vmap(Async->Pages, NumPages, VM_MAP, PAGE_KERNEL);
+	if (Async->Mapping == NULL)
+	{
+		DvrAsyncUnpin(Async);
+		atomic_set(&Async->State, DVR_ASYNC_IDLE);
+		return -ENOMEM;
+	}
+	Async->Data = (const u8 *)Async->Mapping + (Start & ~PAGE_MASK);
+	Async->Size = Count;
+	Async->PacketSize = PacketSize;
+	Async->DmxDevice = DmxDevice;
+	Async->DvbDemux = DvbDemux;
+	//sylvester: wenn der stream vom user kommt soll WriteToDecoder nix
+	//tun, da das ja hier schon passiert.
+	Context->dvr_write = 1;
+	smp_wmb();
+	atomic_set(&Async->State, DVR_ASYNC_QUEUED);
+	wake_up_interruptible(&Async->WaitQueue);
+	return Count;
+}
+/*}}}*/
+
+/*{{{ DvrAsyncStart*/
+static void DvrAsyncStart(struct DeviceContext_s *Context)
+{
+	struct DvrAsync_s *Async = kzalloc(sizeof(struct DvrAsync_s), GFP_KERNEL);
+	if (Async == NULL)
+		return;
+	init_waitqueue_head(&Async->WaitQueue);
+	atomic_set(&Async->State, DVR_ASYNC_IDLE);
+	Context->DvrAsync = Async;
+	Async->Thread = kthread_run(DvrAsyncThread, Context, "dvr-inject%d", Context->Id);
+	if (IS_ERR(Async->Thread))
+	{
+		DVB_ERROR("Unable to start dvr worker, writing synchronously\n");
+		Context->DvrAsync = NULL;
+		kfree(Async);
+	}
+}
+/*}}}*/
+
+/*{{{ DvrAsyncStop*/
+static void DvrAsyncStop(struct DeviceContext_s *Context)
+{
+	struct DvrAsync_s *Async = Context->DvrAsync;
+	if (Async == NULL)
+		return;
+	kthread_stop(Async->Thread);
+	/* the worker may have stopped before taking the last buffer */
+	DvrAsyncUnpin(Async);
+	Context->DvrAsync = NULL;
+	kfree(Async);
+}
+/*}}}*/
+
+/*{{{ DvrPoll*/
+static unsigned int DvrPoll(struct file *File, poll_table *Wait)
+{
+	struct dvb_device *DvbDevice = (struct dvb_device *)File->private_data;
+	struct dmxdev *DmxDevice = (struct dmxdev *)DvbDevice->priv;
+	struct dvb_demux *DvbDemux = (struct dvb_demux *)DmxDevice->demux->priv;
+	struct DeviceContext_s *Context = (struct DeviceContext_s *)DvbDemux->priv;
+	struct DvrAsync_s *Async = Context->DvrAsync;
+	if (((File->f_flags & O_ACCMODE) != O_WRONLY) || (Async == NULL))
+		return OriginalDvrFops.poll(File, Wait);
+	poll_wait(File, &Async->WaitQueue, Wait);
+	return (atomic_read(&Async->State) == DVR_ASYNC_IDLE) ? (POLLOUT | POLLWRNORM) : 0;
+}
+/*}}}*/
+#endif
+
 static int DvrOpen(struct inode *Inode,
 		   struct file *File)
 {
@@ -125,11 +359,18 @@ static int DvrOpen(struct inode *Inode,
 	//tun, da das ja hier schon passiert. keine ahnung wie man das ansonsten
 	//verhindern soll;-)
 	Context->dvr_write = 0;
+	{
+		int Result = OriginalDvrFops.open(Inode, File);
+		if ((Result == 0) && dvrAsync &&
+				((File->f_flags & O_ACCMODE) == O_WRONLY) && (File->f_flags & O_NONBLOCK))
+			DvrAsyncStart(Context);
+		return Result;
+	}
 #else
 	Context->StartOffset = -1;
 	Context->EndOffset = -1;
-#endif
 	return OriginalDvrFops.open(Inode, File);
+#endif
 }
 
 static int DvrRelease(struct inode *Inode,
@@ -174,6 +415,8 @@ static int DvrRelease(struct inode *Inode,
 		Context->StreamType = STREAM_TYPE_TRANSPORT;
 	}
 #endif
+	if ((File->f_flags & O_ACCMODE) == O_WRONLY)
+		DvrAsyncStop(Context);
 	Result = OriginalDvrFops.release(Inode, File);
 	//sylvester: wenn der stream vom user kommt soll WriteToDecoder nix
 	//tun, da das ja hier schon passiert. keine ahnung wie man das ansonsten
@@ -232,6 +475,13 @@ static ssize_t DvrWrite(struct file *File, const char __user *Buffer, size_t Cou
 	if ((File->f_flags & O_ACCMODE) != O_WRONLY)
 		return -EINVAL;
 #ifdef __TDT__
+	if ((Context->DvrAsync != NULL) && !swts && !Context->EncryptionOn)
+	{
+		int PacketSize = (((Count % TRANSPORT_PACKET_SIZE) == 0) || ((Count % BLUERAY_PACKET_SIZE) != 0)) ?
+				 TRANSPORT_PACKET_SIZE : BLUERAY_PACKET_SIZE;
+		if (Count >= PacketSize)
+			return DvrAsyncWrite(Context, DmxDevice, DvbDemux, Buffer, Count, PacketSize);
+	}
 	while (1)
 	{
 		// Check whether a video stream is available and in FREEZED state.
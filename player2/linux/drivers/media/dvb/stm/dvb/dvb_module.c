@@ -53,6 +53,7 @@ Date Modification Name
 #include "dvb_video.h"
 #include "dvb_dmux.h"
 #include "dvb_dvr.h"
+#include "dvb_section.h"
 #include "dvb_ca.h"
 #include "backend.h"
 
@@ -88,6 +89,14 @@ MODULE_PARM_DESC(highSR, "Start Driver with support for Symbol Rates 30000.\nIf
 module_param(swts, int, 0444);
 MODULE_PARM_DESC(swts, "Do not route injected data through the tsm/pti.\n");
 
+int bulkDemux = 0;
+module_param(bulkDemux, int, S_IRUGO);
+MODULE_PARM_DESC(bulkDemux, "Filter whole DMA chunks and inject each decoder's packets at once.\n");
+
+int sectionFilter = 0;
+module_param(sectionFilter, int, S_IRUGO);
+MODULE_PARM_DESC(sectionFilter, "Assemble and filter the sections of section only pids outside the kernel demux.\n");
+
 #if defined(SAGEMCOM88)
 int hasdvbt = 1;
 module_param(hasdvbt, int, 0444);
@@ -148,6 +157,9 @@ long DvbGenericUnlockedIoctl(struct file *file, unsigned int foo, unsigned long
 		return -ENOMEM;
 	}
 	mutex_init(&(DvbContext->Lock));
+#ifdef __TDT__
+	spin_lock_init(&DvbContext->ScramblingLock);
+#endif
 	mutex_lock(&(DvbContext->Lock));
 	/*{{{ Register devices*/
 	for (i = 0; i < DVB_MAX_DEVICES_PER_ADAPTER; i++)
@@ -272,11 +284,30 @@ long DvbGenericUnlockedIoctl(struct file *file, unsigned int foo, unsigned long
 		DeviceContext->dvr_in = kmalloc(65536, GFP_KERNEL); // 128Kbytes is quite a lot per device.
 		DeviceContext->dvr_out = kmalloc(65536, GFP_KERNEL); // However allocating on each write is expensive.
 		DeviceContext->EncryptionOn = 0;
+		DeviceContext->PcrPid = DEMUX_INVALID_ID;
 #ifdef __TDT__
 		DeviceContext->VideoPlaySpeed = DVB_SPEED_NORMAL_PLAY;
 		DeviceContext->provideToDecoder = 0;
+		DeviceContext->Scrambling[0].pid = 0xffff;
+		DeviceContext->Scrambling[0].scrambled = 0;
+		DeviceContext->Scrambling[0].changed = 0;
+		DeviceContext->Scrambling[1].pid = 0xffff;
+		DeviceContext->Scrambling[1].scrambled = 0;
+		DeviceContext->Scrambling[1].changed = 0;
+		DeviceContext->AudioScrambling = 0xffff;
+		DeviceContext->AudioScramblingPending = 0;
+		init_waitqueue_head(&DeviceContext->AudioScramblingWait);
+		DeviceContext->DvrAsync = NULL;
 		DeviceContext->feedPesType = 0;
 		mutex_init(&DeviceContext->injectMutex);
+		DeviceContext->bulkBuffer = NULL;
+		if (bulkDemux)
+		{
+			DeviceContext->bulkBuffer = kmalloc(DVB_BULK_DEMUX_PACKETS * 188, GFP_KERNEL);
+			if (DeviceContext->bulkBuffer == NULL)
+				DVB_ERROR("Unable to allocate the bulk demux buffer, using the per pid demux\n");
+		}
+		DeviceContext->SectionEngine = sectionFilter ? DvbSectionCreate() : NULL;
 		if (i < 4)
 		{
 			ptiInit(DeviceContext);
@@ -337,6 +368,10 @@ static void __exit StmUnloadModule(void)
 		DeviceContext->Playback = NULL;
 		kfree(DeviceContext->dvr_in);
 		kfree(DeviceContext->dvr_out);
+#ifdef __TDT__
+		kfree(DeviceContext->bulkBuffer);
+		DvbSectionDelete(DeviceContext->SectionEngine);
+#endif
 	}
 	if (DvbContext != NULL)
 	{
@@ -81,6 +81,7 @@ struct DeviceContext_s;
 							 __FUNCTION__, #x, __FILE__, __LINE__); while(0)
 
 #define DVB_MAX_DEVICES_PER_ADAPTER 4
+#define DVB_BULK_DEMUX_PACKETS 64
 
 struct DemuxBuffer_s
 {
@@ -151,6 +152,7 @@ struct DeviceContext_s
 	unsigned char *dvr_in;
 	unsigned char *dvr_out;
 	unsigned int EncryptionOn;
+	unsigned int PcrPid; /* clock recovered from this pid by the player demux, DEMUX_INVALID_ID if none */
 
 	unsigned int StartOffset;
 	unsigned int EndOffset;
@@ -164,6 +166,19 @@ struct DeviceContext_s
 	int provideToDecoder;
 	int feedPesType;
 	struct mutex injectMutex;
+	unsigned char *bulkBuffer; /* decoder packets gathered by the bulk demux */
+	unsigned char gatherBuffer[9 * 188]; /* a group of vectored packets for the decoder, under the inject mutex */
+	struct DvbSectionEngine_s *SectionEngine; /* NULL unless sections are filtered by the engine */
+	struct
+	{
+		u16 pid;
+		int scrambled;
+		int changed; /* reported once the inject mutex is dropped */
+	} Scrambling[2]; /* last seen state of the audio and video decoder input, under ScramblingLock */
+	unsigned int AudioScrambling; /* read with AUDIO_GET_SCRAMBLING */
+	int AudioScramblingPending;
+	wait_queue_head_t AudioScramblingWait;
+	struct DvrAsync_s *DvrAsync; /* worker state when the dvr is written asynchronously */
 #endif
 };
 
@@ -175,6 +190,9 @@ struct DvbContext_s
 	struct dvb_adapter DvbAdapter;
 
 	struct mutex Lock;
+#ifdef __TDT__
+	spinlock_t ScramblingLock; /* Scrambling[] and AudioScrambling of every device */
+#endif
 
 	struct DeviceContext_s DeviceContext[DVB_MAX_DEVICES_PER_ADAPTER];
 
@@ -0,0 +1,349 @@
+/************************************************************************
+Copyright (C) 2003 STMicroelectronics. All Rights Reserved.
+
+This file is part of the Player2 Library.
+
+Player2 is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License version 2 as published by the
+Free Software Foundation.
+
+Player2 is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with player2; see the file COPYING. If not, write to the Free Software
+Foundation, 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+
+The Player2 Library may alternatively be licensed under a proprietary
+license from ST.
+
+Source file name : dvb_section.c
+Author :
+
+Section filter engine for the packets delivered by the pti.
+
+The kernel demux assembles sections one feed at a time, takes its lock
+for every packet and works out the crc again for every feed on a pid.
+For pids carrying only section feeds (the EPG tables of a whole
+transponder) the sections are assembled here straight from the packets
+the pti delivered, held until the end of the dma chunk, then checked in
+one crc pass and handed to the filters of all the feeds under a single
+take of the demux lock. The filters use the mask tables the kernel demux
+prepared when they were started.
+
+Date Modification Name
+---- ------------ --------
+19-Oct-26 Created
+
+************************************************************************/
+
+#include <linux/module.h>
+#include <linux/vmalloc.h>
+#include <linux/crc32.h>
+
+#include "dvb_module.h"
+#include "dvb_section.h"
+
+#define SECTION_MAX_LENGTH 4096
+
+struct DvbSectionPid_s
+{
+	int InUse;
+	u16 Pid;
+	u8 Continuity; /* last continuity counter, 0xff after a reset */
+	int Started; /* a payload unit start has been seen */
+	int Length; /* bytes assembled */
+	u8 Buffer[SECTION_MAX_LENGTH + 188];
+};
+
+struct DvbSectionPending_s
+{
+	u16 Pid;
+	int Valid; /* crc checked */
+	int Length;
+	u8 *Section;
+};
+
+struct DvbSectionEngine_s
+{
+	struct DvbSectionPid_s Pids[DVB_SECTION_PIDS];
+
+	int Pending;
+	int Used;
+	struct DvbSectionPending_s Sections[DVB_SECTION_PENDING];
+	u8 Store[DVB_SECTION_STORE];
+};
+
+/*{{{ DvbSectionCreate*/
+struct DvbSectionEngine_s *DvbSectionCreate(void)
+{
+	struct DvbSectionEngine_s *Engine = vmalloc(sizeof(struct DvbSectionEngine_s));
+	if (Engine == NULL)
+	{
+		DVB_ERROR("Unable to create section engine - no memory\n");
+		return NULL;
+	}
+	memset(Engine, 0, sizeof(struct DvbSectionEngine_s));
+	return Engine;
+}
+/*}}}*/
+/*{{{ DvbSectionDelete*/
+void DvbSectionDelete(struct DvbSectionEngine_s *Engine)
+{
+	if (Engine != NULL)
+		vfree(Engine);
+}
+/*}}}*/
+/*{{{ DvbSectionReset*/
+static void DvbSectionReset(struct DvbSectionPid_s *Pid)
+{
+	Pid->Continuity = 0xff;
+	Pid->Started = 0;
+	Pid->Length = 0;
+}
+/*}}}*/
+/*{{{ DvbSectionScan*/
+/*
+ Work out which pids the engine takes, those with a running section feed
+ and no transport stream feed. A recording of the pid, or of the whole
+ stream, leaves it to the kernel demux which then sees every packet.
+ Called once per dma chunk, the feed list is short.
+*/
+void DvbSectionScan(struct DvbSectionEngine_s *Engine,
+		    struct dvb_demux *Demux)
+{
+	struct dvb_demux_feed *Feed;
+	u16 Wanted[DVB_SECTION_PIDS];
+	int Excluded[DVB_SECTION_PIDS];
+	int Count = 0;
+	int All = 0;
+	int i, j;
+	unsigned long Flags;
+	spin_lock_irqsave(&Demux->lock, Flags);
+	list_for_each_entry(Feed, &Demux->feed_list, list_head)
+	{
+		if ((Feed->type == DMX_TYPE_SEC) && (Feed->state == DMX_STATE_GO))
+		{
+			for (i = 0; (i < Count) && (Wanted[i] != Feed->pid); i++)
+				;
+			if ((i == Count) && (Count < DVB_SECTION_PIDS))
+			{
+				Wanted[Count] = Feed->pid;
+				Excluded[Count++] = 0;
+			}
+		}
+	}
+	list_for_each_entry(Feed, &Demux->feed_list, list_head)
+	{
+		if ((Feed->type != DMX_TYPE_TS) || (Feed->state < DMX_STATE_GO))
+			continue;
+		if (Feed->pid == 0x2000)
+			All = 1;
+		for (i = 0; i < Count; i++)
+			if (Wanted[i] == Feed->pid)
+				Excluded[i] = 1;
+	}
+	spin_unlock_irqrestore(&Demux->lock, Flags);
+	/* release the pids no longer ours */
+	for (j = 0; j < DVB_SECTION_PIDS; j++)
+	{
+		if (!Engine->Pids[j].InUse)
+			continue;
+		for (i = 0; (i < Count) && (Wanted[i] != Engine->Pids[j].Pid); i++)
+			;
+		if (All || (i == Count) || Excluded[i])
+			Engine->Pids[j].InUse = 0;
+	}
+	if (All)
+		return;
+	/* and take on the new ones */
+	for (i = 0; i < Count; i++)
+	{
+		if (Excluded[i] || (DvbSectionLookup(Engine, Wanted[i]) != NULL))
+			continue;
+		for (j = 0; (j < DVB_SECTION_PIDS) && Engine->Pids[j].InUse; j++)
+			;
+		if (j == DVB_SECTION_PIDS)
+			break;
+		DvbSectionReset(&Engine->Pids[j]);
+		Engine->Pids[j].Pid = Wanted[i];
+		Engine->Pids[j].InUse = 1;
+	}
+}
+/*}}}*/
+/*{{{ DvbSectionLookup*/
+struct DvbSectionPid_s *DvbSectionLookup(struct DvbSectionEngine_s *Engine,
+					 u16 Pid)
+{
+	int i;
+	for (i = 0; i < DVB_SECTION_PIDS; i++)
+		if (Engine->Pids[i].InUse && (Engine->Pids[i].Pid == Pid))
+			return &Engine->Pids[i];
+	return NULL;
+}
+/*}}}*/
+/*{{{ DvbSectionMatch*/
+/* The same test as the kernel demux, on the tables it prepared */
+static int DvbSectionMatch(struct dvb_demux_filter *Filter,
+			   const u8 *Section,
+			   int Length)
+{
+	u8 Xor;
+	u8 NotEqual = 0;
+	int i;
+	for (i = 0; (i < DVB_DEMUX_MASK_MAX) && (i < Length); i++)
+	{
+		Xor = Filter->filter.filter_value[i] ^ Section[i];
+		if (Filter->maskandmode[i] & Xor)
+			return 0;
+		NotEqual |= Filter->maskandnotmode[i] & Xor;
+	}
+	if (Filter->doneq && !NotEqual)
+		return 0;
+	return 1;
+}
+/*}}}*/
+/*{{{ DvbSectionFlush*/
+/*
+ Check the crc of every held section, then give them to the filters of
+ the running section feeds, in order for each pid.
+*/
+void DvbSectionFlush(struct DvbSectionEngine_s *Engine,
+		     struct dvb_demux *Demux)
+{
+	struct DvbSectionPending_s *Pending;
+	struct dvb_demux_feed *Feed;
+	struct dvb_demux_filter *Filter;
+	unsigned long Flags;
+	int i;
+	if (Engine->Pending == 0)
+		return;
+	for (i = 0; i < Engine->Pending; i++)
+	{
+		Pending = &Engine->Sections[i];
+		Pending->Valid = ((Pending->Section[1] & 0x80) == 0) ||
+				 (crc32_be(~0, Pending->Section, Pending->Length) == 0);
+	}
+	spin_lock_irqsave(&Demux->lock, Flags);
+	list_for_each_entry(Feed, &Demux->feed_list, list_head)
+	{
+		if ((Feed->type != DMX_TYPE_SEC) || (Feed->state != DMX_STATE_GO))
+			continue;
+		for (i = 0; i < Engine->Pending; i++)
+		{
+			Pending = &Engine->Sections[i];
+			if ((Pending->Pid != Feed->pid) || (!Pending->Valid && Feed->feed.sec.check_crc))
+				continue;
+			for (Filter = Feed->filter; (Filter != NULL) && Feed->feed.sec.is_filtering; Filter = Filter->next)
+				if (DvbSectionMatch(Filter, Pending->Section, Pending->Length))
+					Feed->cb.sec(Pending->Section, Pending->Length, NULL, 0, &Filter->filter, DMX_OK);
+		}
+	}
+	spin_unlock_irqrestore(&Demux->lock, Flags);
+	Engine->Pending = 0;
+	Engine->Used = 0;
+}
+/*}}}*/
+/*{{{ DvbSectionComplete*/
+static void DvbSectionComplete(struct DvbSectionEngine_s *Engine,
+			       struct dvb_demux *Demux,
+			       struct DvbSectionPid_s *Pid,
+			       int Length)
+{
+	struct DvbSectionPending_s *Pending;
+	if ((Engine->Pending == DVB_SECTION_PENDING) || ((Engine->Used + Length) > DVB_SECTION_STORE))
+		DvbSectionFlush(Engine, Demux);
+	Pending = &Engine->Sections[Engine->Pending++];
+	Pending->Pid = Pid->Pid;
+	Pending->Length = Length;
+	Pending->Section = &Engine->Store[Engine->Used];
+	memcpy(Pending->Section, Pid->Buffer, Length);
+	Engine->Used += Length;
+}
+/*}}}*/
+/*{{{ DvbSectionAppend*/
+/* Add payload to the section being assembled, queueing any completed */
+static void DvbSectionAppend(struct DvbSectionEngine_s *Engine,
+			     struct dvb_demux *Demux,
+			     struct DvbSectionPid_s *Pid,
+			     const u8 *Data,
+			     int Count)
+{
+	int Length;
+	memcpy(&Pid->Buffer[Pid->Length], Data, Count);
+	Pid->Length += Count;
+	while (Pid->Length >= 3)
+	{
+		if (Pid->Buffer[0] == 0xff)
+		{
+			/* stuffing to the end of the packet */
+			Pid->Length = 0;
+			Pid->Started = 0;
+			return;
+		}
+		Length = 3 + (((Pid->Buffer[1] & 0x0f) << 8) | Pid->Buffer[2]);
+		if (Length > SECTION_MAX_LENGTH)
+		{
+			DvbSectionReset(Pid);
+			return;
+		}
+		if (Pid->Length < Length)
+			return;
+		DvbSectionComplete(Engine, Demux, Pid, Length);
+		Pid->Length -= Length;
+		if (Pid->Length > 0)
+			memmove(Pid->Buffer, &Pid->Buffer[Length], Pid->Length);
+	}
+}
+/*}}}*/
+/*{{{ DvbSectionPacket*/
+void DvbSectionPacket(struct DvbSectionEngine_s *Engine,
+		      struct dvb_demux *Demux,
+		      struct DvbSectionPid_s *Pid,
+		      const u8 *Packet)
+{
+	int Offset = 4;
+	int Pointer;
+	u8 Continuity = Packet[3] & 0x0f;
+	if ((Packet[0] != 0x47) || (Packet[1] & 0x80))
+	{
+		DvbSectionReset(Pid);
+		return;
+	}
+	if ((Packet[3] & 0x10) == 0)
+		return; /* no payload */
+	if (Packet[3] & 0x20)
+		Offset += 1 + Packet[4];
+	if (Offset >= 188)
+		return;
+	if ((Pid->Continuity != 0xff) && (Continuity != ((Pid->Continuity + 1) & 0x0f)))
+	{
+		if (Continuity == Pid->Continuity)
+			return; /* repeated packet */
+		Pid->Length = 0;
+		Pid->Started = 0;
+	}
+	Pid->Continuity = Continuity;
+	if (Packet[1] & 0x40)
+	{
+		Pointer = Packet[Offset++];
+		if ((Offset + Pointer) > 188)
+		{
+			DvbSectionReset(Pid);
+			return;
+		}
+		/* the pointer field bytes finish the previous section */
+		if (Pid->Started && (Pid->Length > 0) && (Pointer > 0))
+			DvbSectionAppend(Engine, Demux, Pid, &Packet[Offset], Pointer);
+		Pid->Length = 0;
+		Pid->Started = 1;
+		Offset += Pointer;
+	}
+	else if (!Pid->Started)
+		return;
+	if (Offset < 188)
+		DvbSectionAppend(Engine, Demux, Pid, &Packet[Offset], 188 - Offset);
+}
+/*}}}*/
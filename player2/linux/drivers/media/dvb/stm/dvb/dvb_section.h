@@ -0,0 +1,56 @@
+/************************************************************************
+Copyright (C) 2003 STMicroelectronics. All Rights Reserved.
+
+This file is part of the Player2 Library.
+
+Player2 is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License version 2 as published by the
+Free Software Foundation.
+
+Player2 is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with player2; see the file COPYING. If not, write to the Free Software
+Foundation, 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+
+The Player2 Library may alternatively be licensed under a proprietary
+license from ST.
+
+Source file name : dvb_section.h - section filter engine definitions
+
+Date Modification Name
+---- ------------ --------
+19-Oct-26 Created
+
+************************************************************************/
+
+#ifndef H_DVB_SECTION
+#define H_DVB_SECTION
+
+#include "dvb_demux.h" /* provides kernel demux definitions */
+
+#define DVB_SECTION_PIDS 8 /* section only pids handled by the engine, others go through the kernel demux */
+#define DVB_SECTION_PENDING 64 /* complete sections held for one crc and filter pass */
+#define DVB_SECTION_STORE 16384
+
+struct DvbSectionEngine_s;
+struct DvbSectionPid_s;
+
+struct DvbSectionEngine_s *DvbSectionCreate(void);
+void DvbSectionDelete(struct DvbSectionEngine_s *Engine);
+
+void DvbSectionScan(struct DvbSectionEngine_s *Engine,
+		    struct dvb_demux *Demux);
+struct DvbSectionPid_s *DvbSectionLookup(struct DvbSectionEngine_s *Engine,
+					 u16 Pid);
+void DvbSectionPacket(struct DvbSectionEngine_s *Engine,
+		      struct dvb_demux *Demux,
+		      struct DvbSectionPid_s *Pid,
+		      const u8 *Packet);
+void DvbSectionFlush(struct DvbSectionEngine_s *Engine,
+		     struct dvb_demux *Demux);
+
+#endif
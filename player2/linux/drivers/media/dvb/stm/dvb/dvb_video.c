@@ -1105,7 +1105,8 @@ static int VideoIoctlCommand(struct DeviceContext_s *Context, struct video_comma
 				(VideoCommand->option.option == PLAY_OPTION_VIDEO_START_IMMEDIATE) ||
 				(VideoCommand->option.option == PLAY_OPTION_PTS_SYMMETRIC_JUMP_DETECTION) ||
 				(VideoCommand->option.option == PLAY_OPTION_PTS_FORWARD_JUMP_DETECTION_THRESHOLD) ||
-				(VideoCommand->option.option == PLAY_OPTION_SYNC_START_IMMEDIATE))
+				(VideoCommand->option.option == PLAY_OPTION_SYNC_START_IMMEDIATE) ||
+				(VideoCommand->option.option == PLAY_OPTION_SYNC_START_FAST))
 		{
 			if (Context->Playback != NULL)
 				Result = DvbPlaybackSetOption(Context->Playback, (play_option_t)VideoCommand->option.option, (unsigned int)VideoCommand->option.value);
@@ -1262,6 +1263,16 @@ static int VideoIoctl(struct inode *Inode, struct file *File, unsigned int Ioctl
 				return -EPERM;
 		}
 	}
+#ifdef __TDT__
+	/* events, the scrambling changes among them, are queued without a writer */
+	if (IoctlCode == VIDEO_GET_EVENT)
+	{
+		mutex_lock(&(DvbContext->Lock));
+		Result = VideoIoctlGetEvent(Context, (struct video_event *)Parameter, File->f_flags);
+		mutex_unlock(&(DvbContext->Lock));
+		return Result;
+	}
+#endif
 	if (!Context->VideoOpenWrite) /* Check to see that somebody has the device open for write */
 		return -EBADF;
 	mutex_lock(&(DvbContext->Lock));
@@ -1512,6 +1523,17 @@ static unsigned int VideoPoll(struct file *File, poll_table *Wait)
 	return Mask;
 }
 /*}}}*/
+/*{{{ VideoScramblingChanged*/
+/* Called by the demux when the scrambling state of a decoder pid changes */
+void VideoScramblingChanged(struct DeviceContext_s *Context, unsigned int Pid, unsigned int Scrambled)
+{
+	struct stream_event_s Event;
+	Event.code = STREAM_EVENT_SCRAMBLING_CHANGED;
+	Event.timestamp = 0;
+	Event.u.scrambling = (Pid & 0x1fff) | (Scrambled ? (1 << 16) : 0);
+	VideoSetEvent(Context, &Event);
+}
+/*}}}*/
 /*{{{ VideoSetEvent*/
 static void VideoSetEvent(struct DeviceContext_s *Context, struct stream_event_s *Event)
 {
@@ -1571,6 +1593,16 @@ static void VideoSetEvent(struct DeviceContext_s *Context, struct stream_event_s
 		case STREAM_EVENT_TRICK_MODE_CHANGE:
 			VideoEvent->u.frame_rate = (unsigned int)(Event->u.trick_mode_domain);
 			break;
+		/* The code below uses the frame_rate to store the pid and its new
+		 scrambling state as this event is not defined in the standard structure */
+		case STREAM_EVENT_SCRAMBLING_CHANGED:
+			VideoEvent->u.frame_rate = Event->u.scrambling;
+			break;
+		/* The code below uses the frame_rate to store the queue ahead margin
+		 in microseconds, negative when the frame was queued late */
+		case STREAM_EVENT_DISPLAY_QUEUE_MARGIN_LOW:
+			VideoEvent->u.frame_rate = (unsigned int)(int)Event->u.longlong;
+			break;
 	}
 	EventList->Write = Next;
 	EventReceived = true;
@@ -59,6 +59,7 @@ int VideoIoctlSetSpeed(struct DeviceContext_s *Context,
 int VideoIoctlSetPlayInterval(struct DeviceContext_s *Context,
 			      video_play_interval_t *PlayInterval);
 int PlaybackInit(struct DeviceContext_s *Context);
+void VideoScramblingChanged(struct DeviceContext_s *Context, unsigned int Pid, unsigned int Scrambled);
 int VideoSetOutputWindow(struct DeviceContext_s *Context,
 			 unsigned int Left,
 			 unsigned int Top,
@@ -28,6 +28,7 @@
 #include "dvb_module.h"
 
 #include <linux/delay.h>
+#include <linux/proc_fs.h>
 
 //__TDT__: many modifications in this file
 #if LINUX_VERSION_CODE > KERNEL_VERSION(2,6,17)
@@ -175,6 +176,22 @@ enum
 extern int highSR;
 
 extern void paceSwtsByPti(void);
+extern unsigned int pti_hal_get_input_rate(int tag);
+
+/* Per input state of the merger, reported through /proc/tsm_inputs.
+   The overflow flags in the status registers are sticky, they are counted
+   and cleared each time the inputs are sampled, which is before every
+   software injection and on every read of the proc entry. */
+#define TSM_PROC_FILENAME "tsm_inputs"
+#define TSM_INPUTS 5 /* TS0, TS1, TS2, SWTS0, alternate input */
+
+static struct
+{
+	unsigned int fifo_overflows;
+	unsigned int ram_overflows;
+} tsmStats[TSM_INPUTS];
+
+static int tsmProcCreated = 0;
 
 /* ****************************************
  * Dagobert:
@@ -275,6 +292,70 @@ EXPORT_SYMBOL(extern_inject_data);
 #endif
 /* <<< DVBT-USB */
 
+static void stm_tsm_sample_inputs(void)
+{
+	unsigned int status;
+	int n;
+	if (!tsm_io)
+	{
+		return;
+	}
+	for (n = 0; n < TSM_INPUTS; n++)
+	{
+		status = readl(tsm_io + TSM_STREAM_STATUS(n));
+		if (!(status & (TSM_INPUTFIFO_OVERFLOW | TSM_RAM_OVERFLOW)))
+		{
+			continue;
+		}
+		if (status & TSM_INPUTFIFO_OVERFLOW)
+		{
+			tsmStats[n].fifo_overflows++;
+		}
+		if (status & TSM_RAM_OVERFLOW)
+		{
+			tsmStats[n].ram_overflows++;
+		}
+		writel(status & ~(TSM_INPUTFIFO_OVERFLOW | TSM_RAM_OVERFLOW), tsm_io + TSM_STREAM_STATUS(n));
+	}
+}
+
+/* The packet rate comes from the pti, the merger tags each packet with
+   the number of the input it came from. The ram share is the start of
+   the input's partition of the merger ram, so its size is the distance
+   to the next input. */
+static int stm_tsm_read_proc(char *page, char **start, off_t off, int count, int *eof, void *data_unused)
+{
+	unsigned int config, status, rate;
+	int len = 0;
+	int n;
+	if (off > 0 || !tsm_io)
+	{
+		*eof = 1;
+		return 0;
+	}
+	stm_tsm_sample_inputs();
+	len += sprintf(page + len, "in on pri ram lock errors fifo_ovf  ram_ovf  pkts/s  kbit/s\n");
+	for (n = 0; n < TSM_INPUTS; n++)
+	{
+		config = readl(tsm_io + TSM_STREAM_CONF(n));
+		status = readl(tsm_io + TSM_STREAM_STATUS(n));
+		rate = pti_hal_get_input_rate(n);
+		len += sprintf(page + len, "%2d %2d %3d %3d %4d %6d %8u %8u %7u %7u\n", n,
+			       (config & TSM_STREAM_ON) ? 1 : 0,
+			       (config >> 16) & 0xf,
+			       (config >> 8) & 0xff,
+			       (status & TSM_STREAM_LOCK) ? 1 : 0,
+			       TSM_ERRONEOUS_PACKETS(status),
+			       tsmStats[n].fifo_overflows,
+			       tsmStats[n].ram_overflows,
+			       rate,
+			       (rate * 188 * 8) / 1000);
+	}
+	len += sprintf(page + len, "swts_req %d\n", (readl(tsm_io + SWTS_CFG(0)) & TSM_SWTS_REQ) ? 1 : 0);
+	*eof = 1;
+	return len;
+}
+
 void stm_tsm_inject_data(struct stm_tsm_handle *handle, u32 *data, off_t size)
 {
 	int blocks = (size + 127) / 128;
@@ -326,6 +407,7 @@ int stm_tsm_inject_user_data(const char __user *data, off_t size)
 	struct stm_tsm_handle *handle = &tsm_handle;
 	dprintk("%s > size = %d\n", __FUNCTION__, (int) size);
 	dprintk("status: 0x%08x", readl(tsm_io + TSM_STREAM3_STA));
+	stm_tsm_sample_inputs();
 	paceSwtsByPti();
 	if (start & SWTS_FDMA_ALIGNMENT)
 	{
@@ -647,6 +729,11 @@ void stm_tsm_init(int use_cimax)
 	unsigned int stream_sync = 0xbc4722;
 #endif
 
+	if (!tsmProcCreated)
+	{
+		create_proc_read_entry(TSM_PROC_FILENAME, 0, NULL, stm_tsm_read_proc, NULL);
+		tsmProcCreated = 1;
+	}
 #if defined(SPARK)
 #if LINUX_VERSION_CODE >= KERNEL_VERSION(2,6,30)
 	spark_stm_tsm_init();
@@ -1759,6 +1846,11 @@ void stm_tsm_init(int use_cimax)
 
 void stm_tsm_release(void)
 {
+	if (tsmProcCreated)
+	{
+		remove_proc_entry(TSM_PROC_FILENAME, NULL);
+		tsmProcCreated = 0;
+	}
 	iounmap(tsm_io);
 }
 // vim:ts=4
@@ -124,9 +124,14 @@ extern void cx24116_register_frontend(struct dvb_adapter *dvb_adap);
 
 extern void demultiplexDvbPackets(struct dvb_demux *demux, const u8 *buf, int count);
 
+extern void demultiplexDvbPacketVector(struct dvb_demux *demux, const u8 **packets, int count);
+
 extern void pti_hal_init(struct stpti *pti, struct dvb_demux *demux, void (*_demultiplexDvbPackets)(struct dvb_demux *demux, const u8 *buf, int count), int numVideoBuffers);
+extern void pti_hal_set_packet_vector_handler(void (*_demultiplexDvbPacketVector)(struct dvb_demux *demux, const u8 **packets, int count));
+extern void pti_hal_set_packet_block(int packets);
 
 extern int swts;
+extern int bulkDemux;
 
 #if defined(SAGEMCOM88)
 extern int hasdvbt;
@@ -554,6 +559,9 @@ void ptiInit(struct DeviceContext_s *pContext)
 		printk("%s: [st-pti] stm_tsm_init\n", __func__);
 		stm_tsm_init(/*config */ 1);
 		printk("%s: [st-pti] pti_hal_init\n", __func__);
+		/* let the bulk demux have its blocks whole */
+		if (bulkDemux)
+			pti_hal_set_packet_block(DVB_BULK_DEMUX_PACKETS);
 // Twin tuner models
 #if defined(ARIVALINK200) \
  || defined(TF7700) \
@@ -588,6 +596,7 @@ void ptiInit(struct DeviceContext_s *pContext)
 #else
 		pti_hal_init(&pti, &pContext->DvbDemux, demultiplexDvbPackets, 1);
 #endif
+		pti_hal_set_packet_vector_handler(demultiplexDvbPacketVector);
 		printk("%s: [st-pti] register frontend\n", __func__);
 #if defined(FS9000) \
  || defined(UFS912) \
@@ -53,6 +53,7 @@ typedef void *player_stream_handle_t;
 #define PLAYER_EVENT_SAMPLE_FREQUENCY_CREATED (PLAYER_EVENT_DECODE_ERRORS_CREATED + 1)
 #define PLAYER_EVENT_NUMBER_CHANNELS_CREATED (PLAYER_EVENT_SAMPLE_FREQUENCY_CREATED + 1)
 #define PLAYER_EVENT_NUMBER_OF_SAMPLES_PROCESSED (PLAYER_EVENT_NUMBER_CHANNELS_CREATED + 1)
+#define PLAYER_EVENT_DEMUX_STATISTICS_CREATED (PLAYER_EVENT_NUMBER_OF_SAMPLES_PROCESSED + 1)
 
 #define PLAYER_EVENT_SIZE_CHANGED 0x10000
 #define PLAYER_EVENT_FRAME_RATE_CHANGED (PLAYER_EVENT_SIZE_CHANGED + 1)
@@ -86,6 +87,11 @@ union attribute_descriptor_u
 	int Int;
 	unsigned long long int UnsignedLongLongInt;
 	int Bool;
+	struct
+	{
+		char *Buffer; /* supplied by the caller */
+		unsigned int Size; /* in, the buffer size; out, the length written */
+	} CharBuffer;
 };
 
 typedef int (*player_event_signal_callback)(struct player_event_s *event);
@@ -42,6 +42,7 @@ enum attribute_id_e
 	ATTRIBUTE_ID_sample_frequency,
 	ATTRIBUTE_ID_number_of_samples_processed,
 	ATTRIBUTE_ID_supported_input_format,
+	ATTRIBUTE_ID_demux_statistics,
 	ATTRIBUTE_ID_MAX
 };
 
@@ -128,6 +129,9 @@ ssize_t show_generic_attribute(struct device *class_dev, char *buf, enum attribu
 	union attribute_descriptor_u value;
 	struct stream_data_s *streamdata = container_of(class_dev, struct stream_data_s, stream_class_device);
 	struct attribute_data_s *attributedata = &streamdata->attribute_data[attr_id];
+	/* tables are formatted straight into the page */
+	value.CharBuffer.Buffer = buf;
+	value.CharBuffer.Size = PAGE_SIZE;
 	Result = ComponentGetAttribute(attributedata->component, attr_name, &value);
 	if (Result < 0)
 	{
@@ -140,6 +144,10 @@ ssize_t show_generic_attribute(struct device *class_dev, char *buf, enum attribu
 		case ATTRIBUTE_ID_number_channels:
 			return sprintf(buf, "%s\n", value.ConstCharPointer);
 			break;
+		case ATTRIBUTE_ID_demux_statistics:
+			/* already a table of lines, in buf */
+			return value.CharBuffer.Size;
+			break;
 		case ATTRIBUTE_ID_decode_errors:
 		case ATTRIBUTE_ID_sample_frequency:
 			return sprintf(buf, "%i\n", value.Int);
@@ -204,6 +212,7 @@ SHOW(number_channels);
 SHOW(sample_frequency);
 SHOW(supported_input_format);
 SHOW(number_of_samples_processed);
+SHOW(demux_statistics);
 
 /* creation of store_xx methods */
 
@@ -217,6 +226,7 @@ DEVICE_ATTR(decode_errors, S_IWUSR | S_IRUGO, show_decode_errors, store_decode_e
 DEVICE_ATTR(sample_frequency, S_IRUGO, show_sample_frequency, NULL);
 DEVICE_ATTR(number_channels, S_IRUGO, show_number_channels, NULL);
 DEVICE_ATTR(number_of_samples_processed, S_IRUGO, show_number_of_samples_processed, NULL);
+DEVICE_ATTR(demux_statistics, S_IRUGO, show_demux_statistics, NULL);
 
 /*{{{ get_playback*/
 struct playback_data_s *get_playback(void *playback)
@@ -534,6 +544,11 @@ int event_attribute_created_handler(struct player_event_s *Event)
 			attribute_id = ATTRIBUTE_ID_number_of_samples_processed;
 			attribute = &dev_attr_number_of_samples_processed;
 			break;
+		case PLAYER_EVENT_DEMUX_STATISTICS_CREATED:
+			SYSFS_DEBUG("PLAYER_EVENT_DEMUX_STATISTICS_CREATED\n");
+			attribute_id = ATTRIBUTE_ID_demux_statistics;
+			attribute = &dev_attr_demux_statistics;
+			break;
 		default:
 			SYSFS_DEBUG("PLAYER_EVENT_NUMBER_CHANNELS_CREATED\n");
 			attribute_id = ATTRIBUTE_ID_number_channels;
@@ -701,6 +716,7 @@ static int PlayerSetEvent(struct player_event_s *Event)
 		case PLAYER_EVENT_SAMPLE_FREQUENCY_CREATED:
 		case PLAYER_EVENT_NUMBER_CHANNELS_CREATED:
 		case PLAYER_EVENT_NUMBER_OF_SAMPLES_PROCESSED:
+		case PLAYER_EVENT_DEMUX_STATISTICS_CREATED:
 		{
 			Result = event_attribute_created_handler(Event);
 			if (Result) return Result;
@@ -0,0 +1,150 @@
+/*
+ * pcm_kernels_bench.c
+ *
+ * Copyright (C) STMicroelectronics Limited 2009. All rights reserved.
+ *
+ * Host benchmark for the pcm transcoder repack kernels.
+ * Each case converts one second of audio with PcmKernel_Repack and with the
+ * byte at a time loop the transform used before the kernels, checks that the
+ * two outputs are identical and reports the time taken by each. Build with
+ * "make scalar" to measure the scalar kernels instead of the word kernels.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "pcm_transcoder_kernels.h"
+
+#define OUTPUT_CHANNEL_COUNT 8
+#define OUTPUT_SAMPLE_SIZE 4
+#define PASSES 10
+
+typedef struct
+{
+	const char *Name;
+	unsigned int SampleRate;
+	unsigned int ChannelCount;
+	unsigned int SampleSize;
+	unsigned int BigEndian;
+} BenchCase_t;
+
+static const BenchCase_t Cases[] =
+{
+	{"16 bit BE stereo 48 kHz", 48000, 2, 2, 1},
+	{"16 bit LE stereo 48 kHz", 48000, 2, 2, 0},
+	{"16 bit BE 5.1 48 kHz", 48000, 6, 2, 1},
+	{"24 bit BE 5.1 48 kHz", 48000, 6, 3, 1},
+	{"24 bit BE 7.1 96 kHz", 96000, 8, 3, 1},
+	{"24 bit LE 7.1 96 kHz", 96000, 8, 3, 0},
+	{"24 bit BE 7.1 192 kHz", 192000, 8, 3, 1}
+};
+
+/*{{{ Now*/
+static double Now(void)
+{
+	struct timespec Time;
+	clock_gettime(CLOCK_MONOTONIC, &Time);
+	return (double)Time.tv_sec + ((double)Time.tv_nsec / 1e9);
+}
+/*}}}*/
+/*{{{ ReferenceRepack*/
+/* The transform loop as it was before the kernels, one byte at a time */
+static void ReferenceRepack(const BenchCase_t *Case, const unsigned char *Input,
+			    unsigned char *Output, unsigned int Frames)
+{
+	unsigned int Frame;
+	unsigned int Channel;
+	unsigned int i;
+	memset(Output, 0, Frames * OUTPUT_CHANNEL_COUNT * OUTPUT_SAMPLE_SIZE);
+	for (Frame = 0; Frame < Frames; Frame++)
+	{
+		unsigned char *Out = Output + (Frame * OUTPUT_CHANNEL_COUNT * OUTPUT_SAMPLE_SIZE);
+		for (Channel = 0; Channel < Case->ChannelCount; Channel++)
+		{
+			if (Case->BigEndian)
+				for (i = 0; i < Case->SampleSize; i++)
+					Out[i + 4 - Case->SampleSize] = Input[Case->SampleSize - i - 1];
+			else
+				memcpy(Out + 4 - Case->SampleSize, Input, Case->SampleSize);
+			Out += OUTPUT_SAMPLE_SIZE;
+			Input += Case->SampleSize;
+		}
+	}
+}
+/*}}}*/
+/*{{{ RunCase*/
+static int RunCase(const BenchCase_t *Case)
+{
+	PcmRepackDescriptor_t Descriptor;
+	unsigned int Frames = Case->SampleRate;
+	unsigned int InputSize = Frames * Case->ChannelCount * Case->SampleSize;
+	unsigned int OutputSize = Frames * OUTPUT_CHANNEL_COUNT * OUTPUT_SAMPLE_SIZE;
+	unsigned char *Input = malloc(InputSize);
+	unsigned char *Reference = malloc(OutputSize);
+	int *Output = malloc(OutputSize);
+	double Start;
+	double ReferenceTime;
+	double KernelTime;
+	unsigned int Pass;
+	unsigned int i;
+	int Result = 0;
+	if ((Input == NULL) || (Reference == NULL) || (Output == NULL))
+	{
+		printf("%-24s out of memory\n", Case->Name);
+		Result = 1;
+		goto done;
+	}
+	for (i = 0; i < InputSize; i++)
+		Input[i] = (unsigned char)rand();
+	memset(&Descriptor, 0, sizeof(Descriptor));
+	Descriptor.SampleSize = Case->SampleSize;
+	Descriptor.BigEndian = Case->BigEndian;
+	Descriptor.ChannelCount = Case->ChannelCount;
+	Descriptor.OutputChannelCount = OUTPUT_CHANNEL_COUNT;
+	PcmKernel_DefaultChannelMap(&Descriptor);
+	Start = Now();
+	for (Pass = 0; Pass < PASSES; Pass++)
+		ReferenceRepack(Case, Input, Reference, Frames);
+	ReferenceTime = (Now() - Start) / PASSES;
+	Start = Now();
+	for (Pass = 0; Pass < PASSES; Pass++)
+		PcmKernel_Repack(&Descriptor, Input, Output, Frames);
+	KernelTime = (Now() - Start) / PASSES;
+	/* The output words are little endian, as on the target */
+	for (i = 0; i < Frames * OUTPUT_CHANNEL_COUNT; i++)
+	{
+		unsigned char *r = Reference + (i * OUTPUT_SAMPLE_SIZE);
+		unsigned int Expected = r[0] | (r[1] << 8) | (r[2] << 16) | ((unsigned int)r[3] << 24);
+		if ((unsigned int)Output[i] != Expected)
+		{
+			printf("%-24s MISMATCH at sample %u, %08x expected %08x\n", Case->Name, i, (unsigned int)Output[i], Expected);
+			Result = 1;
+			goto done;
+		}
+	}
+	printf("%-24s reference %8.3f ms  kernels %8.3f ms  (%.2fx)\n", Case->Name,
+	       ReferenceTime * 1000.0, KernelTime * 1000.0, ReferenceTime / KernelTime);
+done:
+	free(Input);
+	free(Reference);
+	free(Output);
+	return Result;
+}
+/*}}}*/
+/*{{{ main*/
+int main(void)
+{
+	unsigned int i;
+	int Failures = 0;
+#ifdef PCM_KERNELS_SCALAR_ONLY
+	printf("Scalar kernels, one second of audio per case, %d passes\n", PASSES);
+#else
+	printf("Word kernels, one second of audio per case, %d passes\n", PASSES);
+#endif
+	for (i = 0; i < sizeof(Cases) / sizeof(Cases[0]); i++)
+		Failures += RunCase(&Cases[i]);
+	return (Failures == 0) ? 0 : 1;
+}
+/*}}}*/
@@ -0,0 +1,300 @@
+/*
+ * pcm_transcoder_kernels.c
+ *
+ * Copyright (C) STMicroelectronics Limited 2009. All rights reserved.
+ *
+ * Sample repacking kernels used by the pcm transcoder transform.
+ * The file has no kernel dependencies beyond string.h so it can be linked
+ * into host side benchmarks unchanged.
+ */
+
+#ifdef __KERNEL__
+#include <linux/kernel.h>
+#include <linux/string.h>
+#include <asm/byteorder.h>
+#ifdef __BIG_ENDIAN
+#define PCM_KERNELS_SCALAR_ONLY
+#endif
+#else
+#include <string.h>
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+#define PCM_KERNELS_SCALAR_ONLY
+#endif
+#endif
+
+#include "pcm_transcoder_kernels.h"
+
+/* The word kernels load aligned 32 bit little endian words */
+#define PCM_WORD_ALIGNED(p) ((((unsigned long)(p)) & 3) == 0)
+
+/* Through memcpy, as the byte buffer may not be read through an unsigned int pointer */
+static inline unsigned int PCM_LOAD_WORD(const unsigned char *p)
+{
+	unsigned int Word;
+	memcpy(&Word, p, sizeof(Word));
+	return Word;
+}
+
+/*{{{ PcmKernel_Unpack16BE*/
+void PcmKernel_Unpack16BE(const unsigned char *In, int *Out, unsigned int Count)
+{
+	unsigned int i = 0;
+#ifndef PCM_KERNELS_SCALAR_ONLY
+	if (PCM_WORD_ALIGNED(In))
+	{
+		/* Two samples per load, four per iteration */
+		for (; i + 4 <= Count; i += 4)
+		{
+			unsigned int w0 = PCM_LOAD_WORD(In + (i * 2));
+			unsigned int w1 = PCM_LOAD_WORD(In + (i * 2) + 4);
+			Out[i + 0] = (int)(((w0 & 0x000000ff) << 24) | ((w0 & 0x0000ff00) << 8));
+			Out[i + 1] = (int)(((w0 << 8) & 0xff000000) | ((w0 >> 8) & 0x00ff0000));
+			Out[i + 2] = (int)(((w1 & 0x000000ff) << 24) | ((w1 & 0x0000ff00) << 8));
+			Out[i + 3] = (int)(((w1 << 8) & 0xff000000) | ((w1 >> 8) & 0x00ff0000));
+		}
+	}
+#endif
+	for (; i < Count; i++)
+		Out[i] = (int)(((unsigned int)In[(i * 2)] << 24) | ((unsigned int)In[(i * 2) + 1] << 16));
+}
+/*}}}*/
+/*{{{ PcmKernel_Unpack16LE*/
+void PcmKernel_Unpack16LE(const unsigned char *In, int *Out, unsigned int Count)
+{
+	unsigned int i = 0;
+#ifndef PCM_KERNELS_SCALAR_ONLY
+	if (PCM_WORD_ALIGNED(In))
+	{
+		for (; i + 4 <= Count; i += 4)
+		{
+			unsigned int w0 = PCM_LOAD_WORD(In + (i * 2));
+			unsigned int w1 = PCM_LOAD_WORD(In + (i * 2) + 4);
+			Out[i + 0] = (int)(w0 << 16);
+			Out[i + 1] = (int)(w0 & 0xffff0000);
+			Out[i + 2] = (int)(w1 << 16);
+			Out[i + 3] = (int)(w1 & 0xffff0000);
+		}
+	}
+#endif
+	for (; i < Count; i++)
+		Out[i] = (int)(((unsigned int)In[(i * 2) + 1] << 24) | ((unsigned int)In[(i * 2)] << 16));
+}
+/*}}}*/
+/*{{{ PcmKernel_Unpack24BE*/
+void PcmKernel_Unpack24BE(const unsigned char *In, int *Out, unsigned int Count)
+{
+	unsigned int i = 0;
+#ifndef PCM_KERNELS_SCALAR_ONLY
+	if (PCM_WORD_ALIGNED(In))
+	{
+		/* Four samples in three loads */
+		for (; i + 4 <= Count; i += 4)
+		{
+			const unsigned char *p = In + (i * 3);
+			unsigned int w0 = PCM_LOAD_WORD(p);
+			unsigned int w1 = PCM_LOAD_WORD(p + 4);
+			unsigned int w2 = PCM_LOAD_WORD(p + 8);
+			Out[i + 0] = (int)(((w0 & 0x000000ff) << 24) | ((w0 & 0x0000ff00) << 8) | ((w0 & 0x00ff0000) >> 8));
+			Out[i + 1] = (int)((w0 & 0xff000000) | ((w1 & 0x000000ff) << 16) | (w1 & 0x0000ff00));
+			Out[i + 2] = (int)(((w1 & 0x00ff0000) << 8) | ((w1 & 0xff000000) >> 8) | ((w2 & 0x000000ff) << 8));
+			Out[i + 3] = (int)(((w2 & 0x0000ff00) << 16) | (w2 & 0x00ff0000) | ((w2 & 0xff000000) >> 16));
+		}
+	}
+#endif
+	for (; i < Count; i++)
+	{
+		const unsigned char *p = In + (i * 3);
+		Out[i] = (int)(((unsigned int)p[0] << 24) | ((unsigned int)p[1] << 16) | ((unsigned int)p[2] << 8));
+	}
+}
+/*}}}*/
+/*{{{ PcmKernel_Unpack24LE*/
+void PcmKernel_Unpack24LE(const unsigned char *In, int *Out, unsigned int Count)
+{
+	unsigned int i = 0;
+#ifndef PCM_KERNELS_SCALAR_ONLY
+	if (PCM_WORD_ALIGNED(In))
+	{
+		for (; i + 4 <= Count; i += 4)
+		{
+			const unsigned char *p = In + (i * 3);
+			unsigned int w0 = PCM_LOAD_WORD(p);
+			unsigned int w1 = PCM_LOAD_WORD(p + 4);
+			unsigned int w2 = PCM_LOAD_WORD(p + 8);
+			Out[i + 0] = (int)(w0 << 8);
+			Out[i + 1] = (int)(((w0 >> 16) & 0x0000ff00) | (w1 << 16));
+			Out[i + 2] = (int)(((w1 & 0xffff0000) >> 8) | ((w2 & 0x000000ff) << 24));
+			Out[i + 3] = (int)(w2 & 0xffffff00);
+		}
+	}
+#endif
+	for (; i < Count; i++)
+	{
+		const unsigned char *p = In + (i * 3);
+		Out[i] = (int)(((unsigned int)p[2] << 24) | ((unsigned int)p[1] << 16) | ((unsigned int)p[0] << 8));
+	}
+}
+/*}}}*/
+/*{{{ PcmKernel_UnpackGeneric*/
+void PcmKernel_UnpackGeneric(const unsigned char *In, int *Out, unsigned int Count,
+			     unsigned int SampleSize, unsigned int BigEndian)
+{
+	unsigned int i;
+	unsigned int b;
+	for (i = 0; i < Count; i++)
+	{
+		unsigned int Value = 0;
+		/* Put values into most significant bytes */
+		for (b = 0; b < SampleSize && b < 4; b++)
+			Value |= (unsigned int)In[BigEndian ? b : (SampleSize - b - 1)] << (24 - (b * 8));
+		Out[i] = (int)Value;
+		In += SampleSize;
+	}
+}
+/*}}}*/
+/*{{{ PcmKernel_Interleave*/
+void PcmKernel_Interleave(const int *In, int *Out, unsigned int Frames, unsigned int InChannels,
+			  const unsigned char *Map, unsigned int OutChannels)
+{
+	unsigned char Source[PCM_KERNEL_MAX_CHANNELS];
+	unsigned int Frame;
+	unsigned int Slot;
+	unsigned int Channel;
+	/* Invert the map once so every output slot is written exactly once per frame */
+	for (Slot = 0; Slot < OutChannels; Slot++)
+		Source[Slot] = PCM_KERNEL_CHANNEL_UNUSED;
+	for (Channel = 0; Channel < InChannels; Channel++)
+		if (Map[Channel] < OutChannels)
+			Source[Map[Channel]] = Channel;
+	for (Frame = 0; Frame < Frames; Frame++)
+	{
+		for (Slot = 0; Slot < OutChannels; Slot++)
+			Out[Slot] = (Source[Slot] == PCM_KERNEL_CHANNEL_UNUSED) ? 0 : In[Source[Slot]];
+		In += InChannels;
+		Out += OutChannels;
+	}
+}
+/*}}}*/
+/*{{{ PcmKernel_InputBytes*/
+unsigned int PcmKernel_InputBytes(const PcmRepackDescriptor_t *Descriptor, unsigned int Frames)
+{
+	return Frames * Descriptor->ChannelCount * Descriptor->SampleSize;
+}
+/*}}}*/
+/*{{{ PcmKernel_Unpack*/
+static void PcmKernel_Unpack(const PcmRepackDescriptor_t *Descriptor, const unsigned char *In,
+			     int *Out, unsigned int Frames)
+{
+	unsigned int Count = Frames * Descriptor->ChannelCount;
+	if (Descriptor->SampleSize == 2)
+	{
+		if (Descriptor->BigEndian)
+			PcmKernel_Unpack16BE(In, Out, Count);
+		else
+			PcmKernel_Unpack16LE(In, Out, Count);
+	}
+	else if (Descriptor->SampleSize == 3)
+	{
+		if (Descriptor->BigEndian)
+			PcmKernel_Unpack24BE(In, Out, Count);
+		else
+			PcmKernel_Unpack24LE(In, Out, Count);
+	}
+	else
+		PcmKernel_UnpackGeneric(In, Out, Count, Descriptor->SampleSize, Descriptor->BigEndian);
+}
+/*}}}*/
+/*{{{ PcmKernel_RepackBytes*/
+/*
+ * The byte at a time loop the transform used before the kernels. For stereo
+ * the word kernels save too little to pay for the scatter pass, so stereo
+ * keeps this path. The samples are written into the most significant bytes
+ * of little endian output words.
+ */
+static void PcmKernel_RepackBytes(const PcmRepackDescriptor_t *Descriptor, const unsigned char *In,
+				  int *Out, unsigned int Frames)
+{
+	unsigned int SampleSize = Descriptor->SampleSize;
+	unsigned int Frame;
+	unsigned int Channel;
+	unsigned int i;
+	memset(Out, 0, Frames * Descriptor->OutputChannelCount * sizeof(int));
+	if (Descriptor->BigEndian)
+	{
+		for (Frame = 0; Frame < Frames; Frame++)
+		{
+			for (Channel = 0; Channel < Descriptor->ChannelCount; Channel++)
+			{
+				unsigned char *Sample = (unsigned char *)(Out + Descriptor->ChannelMap[Channel]);
+				if (Descriptor->ChannelMap[Channel] < Descriptor->OutputChannelCount)
+					for (i = 0; i < SampleSize; i++)
+						Sample[i + 4 - SampleSize] = In[SampleSize - i - 1];
+				In += SampleSize;
+			}
+			Out += Descriptor->OutputChannelCount;
+		}
+	}
+	else
+	{
+		for (Frame = 0; Frame < Frames; Frame++)
+		{
+			for (Channel = 0; Channel < Descriptor->ChannelCount; Channel++)
+			{
+				unsigned char *Sample = (unsigned char *)(Out + Descriptor->ChannelMap[Channel]);
+				if (Descriptor->ChannelMap[Channel] < Descriptor->OutputChannelCount)
+					memcpy(Sample + 4 - SampleSize, In, SampleSize);
+				In += SampleSize;
+			}
+			Out += Descriptor->OutputChannelCount;
+		}
+	}
+}
+/*}}}*/
+/*{{{ PcmKernel_Repack*/
+unsigned int PcmKernel_Repack(const PcmRepackDescriptor_t *Descriptor, const unsigned char *In,
+			      int *Out, unsigned int Frames)
+{
+	int Scratch[PCM_KERNEL_MAX_CHANNELS * PCM_KERNEL_BLOCK_FRAMES];
+	unsigned int Done = 0;
+	unsigned int Channel;
+	int Direct;
+	if ((Descriptor->ChannelCount == 0) || (Descriptor->ChannelCount > PCM_KERNEL_MAX_CHANNELS))
+		return 0;
+	/* An identity map needs no scatter pass, unpack straight into the output */
+	Direct = (Descriptor->OutputChannelCount == Descriptor->ChannelCount);
+	for (Channel = 0; Direct && (Channel < Descriptor->ChannelCount); Channel++)
+		if (Descriptor->ChannelMap[Channel] != Channel)
+			Direct = 0;
+	if (Direct)
+	{
+		PcmKernel_Unpack(Descriptor, In, Out, Frames);
+		return Frames;
+	}
+	if ((Descriptor->ChannelCount == 2) && (Descriptor->SampleSize <= 4))
+	{
+		PcmKernel_RepackBytes(Descriptor, In, Out, Frames);
+		return Frames;
+	}
+	while (Done < Frames)
+	{
+		unsigned int Block = Frames - Done;
+		if (Block > PCM_KERNEL_BLOCK_FRAMES)
+			Block = PCM_KERNEL_BLOCK_FRAMES;
+		PcmKernel_Unpack(Descriptor, In, Scratch, Block);
+		PcmKernel_Interleave(Scratch, Out, Block, Descriptor->ChannelCount,
+				     Descriptor->ChannelMap, Descriptor->OutputChannelCount);
+		In += PcmKernel_InputBytes(Descriptor, Block);
+		Out += Block * Descriptor->OutputChannelCount;
+		Done += Block;
+	}
+	return Frames;
+}
+/*}}}*/
+/*{{{ PcmKernel_DefaultChannelMap*/
+void PcmKernel_DefaultChannelMap(PcmRepackDescriptor_t *Descriptor)
+{
+	unsigned int Channel;
+	for (Channel = 0; Channel < PCM_KERNEL_MAX_CHANNELS; Channel++)
+		Descriptor->ChannelMap[Channel] = (Channel < Descriptor->ChannelCount) ? Channel : PCM_KERNEL_CHANNEL_UNUSED;
+}
+/*}}}*/
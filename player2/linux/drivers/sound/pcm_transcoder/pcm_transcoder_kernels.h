@@ -0,0 +1,58 @@
+/*
+ * pcm_transcoder_kernels.h
+ *
+ * Copyright (C) STMicroelectronics Limited 2009. All rights reserved.
+ *
+ * Sample repacking kernels used by the pcm transcoder transform.
+ *
+ * All unpack kernels produce signed 32 bit samples with the significant bits
+ * left justified (the layout expected by the mixer). The word based kernels
+ * process several samples per memory access and are selected automatically
+ * when the input is suitably aligned, otherwise the scalar kernels are used.
+ * Stereo is repacked a byte at a time as before the kernels, which the host
+ * benchmark shows is as quick as the word kernels for two channels.
+ * Defining PCM_KERNELS_SCALAR_ONLY forces the scalar kernels, which allows
+ * the two implementations to be compared in a host build.
+ */
+
+#ifndef PCM_TRANSCODER_KERNELS_H_
+#define PCM_TRANSCODER_KERNELS_H_
+
+#define PCM_KERNEL_MAX_CHANNELS 8
+#define PCM_KERNEL_CHANNEL_UNUSED 0xff
+
+/* Number of frames converted per pass through the scratch area */
+#define PCM_KERNEL_BLOCK_FRAMES 16
+
+typedef struct
+{
+	unsigned int SampleSize; /* Bytes per sample */
+	unsigned int BigEndian;
+	unsigned int ChannelCount; /* Channels per input frame */
+	unsigned char ChannelMap[PCM_KERNEL_MAX_CHANNELS]; /* Output slot of each input channel */
+	unsigned int OutputChannelCount; /* Channels per output frame */
+} PcmRepackDescriptor_t;
+
+/* Linear unpackers: Count samples from In to left justified 32 bit values at Out */
+void PcmKernel_Unpack16BE(const unsigned char *In, int *Out, unsigned int Count);
+void PcmKernel_Unpack16LE(const unsigned char *In, int *Out, unsigned int Count);
+void PcmKernel_Unpack24BE(const unsigned char *In, int *Out, unsigned int Count);
+void PcmKernel_Unpack24LE(const unsigned char *In, int *Out, unsigned int Count);
+void PcmKernel_UnpackGeneric(const unsigned char *In, int *Out, unsigned int Count,
+			     unsigned int SampleSize, unsigned int BigEndian);
+
+/* Scatter interleaved frames into a wider output frame according to Map */
+void PcmKernel_Interleave(const int *In, int *Out, unsigned int Frames, unsigned int InChannels,
+			  const unsigned char *Map, unsigned int OutChannels);
+
+/* Input bytes consumed by Frames frames of the described stream */
+unsigned int PcmKernel_InputBytes(const PcmRepackDescriptor_t *Descriptor, unsigned int Frames);
+
+/* Complete conversion of Frames frames, returns the number of frames written */
+unsigned int PcmKernel_Repack(const PcmRepackDescriptor_t *Descriptor, const unsigned char *In,
+			      int *Out, unsigned int Frames);
+
+/* Fill ChannelMap with the default layout for ChannelCount WAV ordered channels */
+void PcmKernel_DefaultChannelMap(PcmRepackDescriptor_t *Descriptor);
+
+#endif /*PCM_TRANSCODER_KERNELS_H_*/
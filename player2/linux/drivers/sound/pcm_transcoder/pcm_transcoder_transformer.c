@@ -20,6 +20,7 @@
 #include <mme.h>
 #include "pcm_transcoder.h"
 #include "Pcm_TranscoderTypes.h"
+#include "pcm_transcoder_kernels.h"
 
 #define PCM_INPUT_BUFFER 0
 #define PCM_OUTPUT_BUFFER 1
@@ -28,7 +29,6 @@
 #define PCM_OUTPUT_FRONT_RIGHT 1
 #define PCM_OUTPUT_FRONT_CENTRE 3
 #define PCM_OUTPUT_SAMPLE_SIZE (PCM_OUTPUT_BITS_PER_SAMPLE/8)
-#define PCM_OUTPUT_MONO_OFFSET (PCM_OUTPUT_FRONT_CENTRE*PCM_OUTPUT_SAMPLE_SIZE) /* Mono goes out through front centre */
 #define PCM_OUTPUT_CHANNEL_COUNT 8
 #define PCM_OUTPUT_BYTES_PER_SAMPLE (PCM_OUTPUT_SAMPLE_SIZE * PCM_OUTPUT_CHANNEL_COUNT)
 
@@ -43,6 +43,7 @@ struct PcmContext_s
 	unsigned int DataEndianness;
 	enum eAccAcMode AudioMode;
 	enum eAccFsCode SamplingFrequency;
+	PcmRepackDescriptor_t Repack;
 };
 /*}}}*/
 
@@ -71,6 +72,9 @@ static MME_ERROR InitializeContext(struct PcmContext_s *PcmContext, MME_LxPcmAud
 		case 6:
 			PcmContext->AudioMode = ACC_MODE32_LFE;
 			break; /* 5,1 */
+		case 8:
+			PcmContext->AudioMode = ACC_MODE34_LFE;
+			break; /* 7,1 */
 		default:
 			PCM_ERROR("%d Channels not supported - treating as stereo.\n", PcmContext->ChannelCount);
 			PcmContext->AudioMode = ACC_MODE20;
@@ -121,6 +125,15 @@ static MME_ERROR InitializeContext(struct PcmContext_s *PcmContext, MME_LxPcmAud
 			break;
 	}
 	PCM_TRACE("PcmContext->SamplingFrequency %d (%x)\n", PcmContext->SamplingFrequency, PcmContext->SamplingFrequency);
+	PcmContext->Repack.SampleSize = PcmContext->BitsPerSample / 8;
+	PcmContext->Repack.BigEndian = (PcmContext->DataEndianness != PCM_LITTLE_ENDIAN);
+	PcmContext->Repack.ChannelCount = PcmContext->ChannelCount;
+	if (PcmContext->ChannelCount > PCM_OUTPUT_CHANNEL_COUNT)
+		PcmContext->Repack.ChannelCount = 2; /* Treated as stereo, only the first two channels are kept */
+	PcmContext->Repack.OutputChannelCount = PCM_OUTPUT_CHANNEL_COUNT;
+	PcmKernel_DefaultChannelMap(&PcmContext->Repack);
+	if (PcmContext->ChannelCount == 1)
+		PcmContext->Repack.ChannelMap[0] = PCM_OUTPUT_FRONT_CENTRE; /* Mono goes out through front centre */
 	return MME_SUCCESS;
 }
 /*}}}*/
@@ -170,9 +183,6 @@ static MME_ERROR PcmTranscoder_InitTransformer(MME_UINT ParamsSize, MME_GenericP
 /*{{{ PcmTranscoder_Transform*/
 static MME_ERROR PcmTranscoder_Transform(void *Context, MME_Command_t *Command)
 {
-	unsigned int i;
-	unsigned int Sample;
-	unsigned int Channel;
 	struct PcmContext_s *PcmContext = (struct PcmContext_s *)Context;
 	MME_CommandStatus_t *CommandStatus = &Command->CmdStatus;
 	MME_LxAudioDecoderFrameStatus_t *FrameStatus = (MME_LxAudioDecoderFrameStatus_t *)CommandStatus->AdditionalInfo_p;
@@ -180,44 +190,27 @@ static MME_ERROR PcmTranscoder_Transform(void *Context, MME_Command_t *Command)
 	MME_DataBuffer_t *OutputDataBuffer = Command->DataBuffers_p[PCM_OUTPUT_BUFFER];
 	MME_ScatterPage_t *InputScatterPage = &InputDataBuffer->ScatterPages_p[0];
 	MME_ScatterPage_t *OutputScatterPage = &OutputDataBuffer->ScatterPages_p[0];
-	unsigned char *Input = InputScatterPage->Page_p;
-	unsigned int SampleSize = PcmContext->BitsPerSample / 8;
 	unsigned int SampleCount = InputScatterPage->Size / PcmContext->BlockAlign;
-	unsigned int OutputOffset = 0;
-	PCM_DEBUG("Samples %d SampleSize %d\n", SampleCount, SampleSize);
-	if (PcmContext->ChannelCount == 1)
-		OutputOffset = PCM_OUTPUT_MONO_OFFSET;
-	memset((unsigned char *)OutputScatterPage->Page_p, 0, SampleCount * PCM_OUTPUT_BYTES_PER_SAMPLE);
-	if (PcmContext->DataEndianness == PCM_LITTLE_ENDIAN)
+	unsigned int Sample;
+	PCM_DEBUG("Samples %d SampleSize %d\n", SampleCount, PcmContext->Repack.SampleSize);
+	if ((PcmContext->ChannelCount != 0) && (PcmContext->Repack.ChannelCount == PcmContext->ChannelCount))
 	{
-		for (Sample = 0; Sample < (InputScatterPage->Size / PcmContext->BlockAlign); Sample++)
-		{
-			unsigned char *Output = ((unsigned char *)OutputScatterPage->Page_p) + (Sample * PCM_OUTPUT_BYTES_PER_SAMPLE) + OutputOffset;
-			for (Channel = 0; Channel < PcmContext->ChannelCount; Channel++)
-			{
-				memcpy(Output + 4 - SampleSize, Input, SampleSize); /* Put values into most significant bytes in a little endian way */
-				Output += PCM_OUTPUT_SAMPLE_SIZE;
-				Input += SampleSize;
-			}
-		}
+		/* Unpack, byte swap and place every channel in its output slot in a single pass */
+		Sample = PcmKernel_Repack(&PcmContext->Repack, (const unsigned char *)InputScatterPage->Page_p,
+					  (int *)OutputScatterPage->Page_p, SampleCount);
 	}
 	else
 	{
-		for (Sample = 0; Sample < (InputScatterPage->Size / PcmContext->BlockAlign); Sample++)
-		{
-			unsigned char *Output = ((unsigned char *)OutputScatterPage->Page_p) + (Sample * PCM_OUTPUT_BYTES_PER_SAMPLE) + OutputOffset;
-			for (Channel = 0; Channel < PcmContext->ChannelCount; Channel++)
-			{
-				for (i = 0; i < SampleSize; i++)
-					Output[i + 4 - SampleSize] = Input[SampleSize - i - 1]; /* Put values into most significant bytes in a little endian way */
-				Output += PCM_OUTPUT_SAMPLE_SIZE;
-				Input += SampleSize;
-			}
-		}
+		/* Too many (or no) channels for the output frame, repack the kept ones a frame at a time */
+		memset((unsigned char *)OutputScatterPage->Page_p, 0, SampleCount * PCM_OUTPUT_BYTES_PER_SAMPLE);
+		for (Sample = 0; Sample < SampleCount; Sample++)
+			PcmKernel_Repack(&PcmContext->Repack, (const unsigned char *)InputScatterPage->Page_p + (Sample * PcmContext->BlockAlign),
+					 (int *)OutputScatterPage->Page_p + (Sample * PCM_OUTPUT_CHANNEL_COUNT), 1);
 	}
 	/*{{{ trace*/
 #if 0
 	{
+		unsigned int i;
 		unsigned char *P = (unsigned char *)InputScatterPage->Page_p;
 		printk("\n%08x: ", 0);
 		for (i = 0; i < 512; i++)
@@ -228,6 +221,7 @@ static MME_ERROR PcmTranscoder_Transform(void *Context, MME_Command_t *Command)
 		}
 	}
 	{
+		unsigned int i;
 		unsigned char *P = (unsigned char *)OutputScatterPage->Page_p;
 		printk("\n%08x: ", 0);
 		for (i = 0; i < 512; i++)
@@ -39,6 +39,8 @@
 #define VIDEO_EVENT_FATAL_ERROR (VIDEO_EVENT_VSYNC_OFFSET_MEASURED+1)
 #define VIDEO_EVENT_OUTPUT_SIZE_CHANGED (VIDEO_EVENT_FATAL_ERROR+1)
 #define VIDEO_EVENT_FATAL_HARDWARE_FAILURE (VIDEO_EVENT_OUTPUT_SIZE_CHANGED+1)
+#define VIDEO_EVENT_SCRAMBLING_CHANGED (VIDEO_EVENT_FATAL_HARDWARE_FAILURE+1) /* u.frame_rate = pid | (scrambled << 16) */
+#define VIDEO_EVENT_DISPLAY_QUEUE_MARGIN_LOW (VIDEO_EVENT_SCRAMBLING_CHANGED+1) /* u.frame_rate = queue ahead margin in us, signed */
 
 /*
  * List of possible container types - used to select demux.. If stream_source is VIDEO_SOURCE_DEMUX
@@ -326,9 +328,14 @@ typedef enum
 
 	DVB_OPTION_SYNC_START_IMMEDIATE = 42,
 
-	/* OPTION_MAX must always be one greater than largest option - currently DVB_OPTION_H264_TREAT_TOP_BOTTOM_PICTURE_STRUCT_AS_INTERLACED */
+	DVB_OPTION_SYNC_START_FAST = 43,
 
-	DVB_OPTION_MAX = 43
+	DVB_OPTION_DISPLAY_QUEUE_TARGET_DEPTH = 44,
+	DVB_OPTION_DISPLAY_QUEUE_MARGIN_THRESHOLD = 45,
+
+	/* OPTION_MAX must always be one greater than largest option - currently DVB_OPTION_DISPLAY_QUEUE_MARGIN_THRESHOLD */
+
+	DVB_OPTION_MAX = 46
 } dvb_option_t;
 
 // Legacy typo correction
@@ -383,6 +390,7 @@ typedef dvb_option_t video_option_t;
 #define AUDIO_SET_CLOCK_DATA_POINT _IOW('o', 79, audio_clock_data_point_t)
 #define AUDIO_SET_TIME_MAPPING _IOW('o', 80, audio_time_mapping_t)
 #define AUDIO_GET_CLOCK_DATA_POINT _IOR('o', 81, audio_clock_data_point_t)
+#define AUDIO_GET_SCRAMBLING _IOR('o', 82, unsigned int) /* pid | (scrambled << 16), POLLPRI when changed */
 
 #endif /* H_DVB_STM_H */
 
@@ -81,6 +81,9 @@ class Demultiplexor_c : public BaseComponentClass_c
 
 		virtual DemultiplexorStatus_t InputJump(DemultiplexorContext_t Context) = 0;
 
+		virtual DemultiplexorStatus_t SetClockRecoveryIdentifier(DemultiplexorContext_t Context,
+									 unsigned int StreamIdentifier) = 0;
+
 		virtual DemultiplexorStatus_t Demux(PlayerPlayback_t Playback,
 						    DemultiplexorContext_t Context,
 						    Buffer_t Buffer) = 0;
@@ -183,6 +186,18 @@ it has regarding the component classes of the stream is now out of date and shou
 \return Demultiplexor status code, DemultiplexorNoError indicates success.
 */
 
+/*! \fn DemultiplexorStatus_t Demultiplexor_c::SetClockRecoveryIdentifier( DemultiplexorContext_t Context, unsigned int StreamIdentifier )
+\brief Nominate the stream carrying the source clock.
+
+When set the demultiplexor extracts the clock references it finds on this stream (i.e. the PCR
+for MPEG transport stream) and feeds them to clock recovery itself, against the time the data
+arrived. The stream need not also be one that has been added to the context.
+
+\param Context A demultiplexor context identifier.
+\param StreamIdentifier The demultiplexors native stream identifier, an identifier outside the native range stops the extraction.
+\return Demultiplexor status code, DemultiplexorNoError indicates success.
+*/
+
 /*! \fn DemultiplexorStatus_t Demultiplexor_c::Demux(PlayerPlayback_t Playback, DemultiplexorContext_t Context, Buffer_t Buffer)
 \brief Demultiplex the supplied data buffer.
 
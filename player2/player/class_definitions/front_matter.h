@@ -529,6 +529,7 @@ typedef enum
 {
  MuxTypeUnMuxed = 0,
  MuxTypeTransportStream,
+ MuxTypeBluRayTransportStream,
  ... Any Others I can't think of ...
 } PlayerInputMuxType_t;
 
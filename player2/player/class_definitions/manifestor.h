@@ -108,6 +108,8 @@ class Manifestor_c : public BaseComponentClass_c
 
 		virtual ManifestorStatus_t GetDecodeBufferCount(unsigned int *Count) = 0;
 
+		virtual ManifestorStatus_t GetBufferFormats(unsigned int *Formats) = 0;
+
 		virtual ManifestorStatus_t SynchronizeOutput(void) = 0;
 
 		virtual ManifestorStatus_t GetFrameCount(unsigned long long *FrameCount) = 0;
@@ -315,6 +317,18 @@ will be the first buffer to be submitted via the normal route.
  \return Manifestor status code, ManifestorNoError indicates success.
 */
 
+/*! \fn ManifestorStatus_t Manifestor_c::GetBufferFormats( unsigned int *Formats )
+ \brief Obtain the decode buffer formats the output surface can manifest directly.
+
+ The formats are returned as a mask with bit (1 << Format) set for each BufferFormat_t the
+ surface consumes without conversion. A codec uses this when it fills out its decode buffer
+ request, so that each stream is decoded into a layout the surface reads in place. Manifestors
+ that do not restrict the format set every bit.
+
+ \param Formats, the returned mask of buffer formats.
+ \return Manifestor status code, ManifestorNoError indicates success.
+*/
+
 /*! \fn ManifestorStatus_t Manifestor_c::SynchronizeOutput( void )
  \brief Synchronize output so that any framing of data aligns with the current time
 
@@ -0,0 +1,339 @@
+/************************************************************************
+Copyright (C) 2009 STMicroelectronics. All Rights Reserved.
+
+This file is part of the Player2 Library.
+
+Player2 is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License version 2 as published by the
+Free Software Foundation.
+
+Player2 is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with player2; see the file COPYING. If not, write to the Free Software
+Foundation, 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+
+The Player2 Library may alternatively be licensed under a proprietary
+license from ST.
+
+Source file name : minimum_delay_fit.h
+
+Definition of the class supporting windowed, minimum delay filtered
+line fitting of clock samples in player 2.
+
+Transport delay can only ever make a sample arrive late, so the sample
+with the largest (source - local) offset in a short time slice is the one
+that suffered the least delay. The fit keeps one such sample per slice
+(bucket) over a sliding window of slices, then performs a least squares
+fit of the offset against local time over those samples only, rejecting
+any that still lie well away from the line (a whole slice delivered
+late by a bursty network).
+
+The points supplied are X (local time) and Y (source time), both
+relative to a fixed base chosen by the caller. When the window is full
+the bucket duration is doubled (adjacent buckets being merged) until the
+maximum duration is reached, after which the oldest bucket is dropped.
+
+Date Modification Name
+---- ------------ --------
+
+************************************************************************/
+
+#include "rational.h"
+
+#ifndef H_MINIMUM_DELAY_FIT
+#define H_MINIMUM_DELAY_FIT
+
+#define MINIMUM_DELAY_FIT_BUCKETS 16
+#define MINIMUM_DELAY_FIT_MINIMUM_REJECTION 500 // us, residuals below this are treated as noise
+#define MINIMUM_DELAY_FIT_PPB_SCALE 1000000000LL
+
+// -------------------------------------------------------------
+
+class MinimumDelayFit_c
+{
+	private:
+		unsigned int Count;
+		long long BucketX[MINIMUM_DELAY_FIT_BUCKETS]; // Local time of the least delayed sample
+		long long BucketD[MINIMUM_DELAY_FIT_BUCKETS]; // Its source - local offset
+		unsigned int BucketPoints[MINIMUM_DELAY_FIT_BUCKETS]; // Points the bucket was chosen from
+		bool BucketRejected[MINIMUM_DELAY_FIT_BUCKETS]; // Its points have been counted as rejected
+		long long BucketStart; // Local time at which the newest bucket opened
+
+		unsigned long long BucketDuration;
+		unsigned long long MaximumBucketDuration;
+
+		unsigned int Accepted; // Points, those of a bucket move to Rejected when it is first discarded
+		unsigned int Rejected;
+
+		long long FitPpb; // Result of the last fit, Y = X + FitOffset + ((FitPpb * X) / 10^9)
+		long long FitOffset;
+
+		//
+		// Fit the selected buckets, offset D = Intercept + ((Ppb * (X - Origin)) / 10^9)
+		//
+
+		bool FitBuckets(bool *Use,
+				long long Origin,
+				long long *Intercept,
+				long long *Ppb)
+		{
+			unsigned int i;
+			long long N = 0;
+			long long X, D;
+			long long SigmaX = 0;
+			long long SigmaD = 0;
+			long long SigmaXX = 0;
+			long long SigmaXD = 0;
+			long long Top;
+			long long Bottom;
+			//
+			// X is taken in ms and D relative to the first bucket, this
+			// keeps all the sums comfortably inside 64 bits for a window
+			// of up to several minutes.
+			//
+			for (i = 0; i < (Count - 1); i++)
+				if (Use[i])
+				{
+					X = (BucketX[i] - Origin) / 1000;
+					D = BucketD[i] - BucketD[0];
+					N++;
+					SigmaX += X;
+					SigmaD += D;
+					SigmaXX += X * X;
+					SigmaXD += X * D;
+				}
+			if (N < 2)
+				return false;
+			Top = (N * SigmaXD) - (SigmaX * SigmaD);
+			Bottom = (N * SigmaXX) - (SigmaX * SigmaX);
+			if (Bottom == 0)
+				return false;
+			//
+			// Top/Bottom is in us per ms, scale to parts per billion
+			//
+			*Ppb = ((Top / Bottom) * 1000000) + (((Top % Bottom) * 1000000) / Bottom);
+			*Intercept = BucketD[0] + ((SigmaD - ((Top * SigmaX) / Bottom)) / N);
+			return true;
+		}
+
+	public:
+
+		//
+		// Constructor just resets the accumulation
+		//
+
+		MinimumDelayFit_c()
+		{
+			Reset(250000, 4000000);
+		}
+
+		//
+		// Reset the accumulation
+		//
+
+		void Reset(unsigned long long InitialBucketDuration,
+			   unsigned long long MaximumDuration)
+		{
+			Count = 0;
+			BucketStart = 0;
+			BucketDuration = InitialBucketDuration;
+			MaximumBucketDuration = MaximumDuration;
+			Accepted = 0;
+			Rejected = 0;
+			FitPpb = 0;
+			FitOffset = 0;
+		}
+
+		//
+		// Read out functions
+		//
+
+		unsigned int Buckets(void)
+		{
+			return (Count == 0) ? 0 : (Count - 1);
+		}
+
+		unsigned long long Span(void)
+		{
+			return (Count < 3) ? 0 : (BucketX[Count - 2] - BucketX[0]);
+		}
+
+		unsigned int AcceptedPoints(void)
+		{
+			return Accepted;
+		}
+
+		unsigned int RejectedPoints(void)
+		{
+			return Rejected;
+		}
+
+		//
+		// Add a new pair of values, returns true when a bucket has just
+		// been closed, which is the natural moment to read out a new fit.
+		//
+
+		bool Add(long long Y,
+			 long long X)
+		{
+			unsigned int i;
+			bool Closed;
+			long long D = Y - X;
+//
+			Closed = (Count != 0) && ((X - BucketStart) >= (long long)BucketDuration);
+			if ((Count == 0) || Closed)
+			{
+				if (Count == MINIMUM_DELAY_FIT_BUCKETS)
+				{
+					if (BucketDuration < MaximumBucketDuration)
+					{
+						//
+						// Widen the window, merging adjacent pairs of buckets
+						//
+						for (i = 0; i < (MINIMUM_DELAY_FIT_BUCKETS / 2); i++)
+						{
+							unsigned int Pick = (BucketD[2 * i] >= BucketD[(2 * i) + 1]) ? (2 * i) : ((2 * i) + 1);
+							BucketX[i] = BucketX[Pick];
+							BucketD[i] = BucketD[Pick];
+							BucketPoints[i] = BucketPoints[2 * i] + BucketPoints[(2 * i) + 1];
+							BucketRejected[i] = BucketRejected[2 * i] || BucketRejected[(2 * i) + 1];
+						}
+						Count = MINIMUM_DELAY_FIT_BUCKETS / 2;
+						BucketDuration *= 2;
+					}
+					else
+					{
+						//
+						// Slide the window
+						//
+						for (i = 1; i < Count; i++)
+						{
+							BucketX[i - 1] = BucketX[i];
+							BucketD[i - 1] = BucketD[i];
+							BucketPoints[i - 1] = BucketPoints[i];
+							BucketRejected[i - 1] = BucketRejected[i];
+						}
+						Count--;
+					}
+				}
+				BucketX[Count] = X;
+				BucketD[Count] = D;
+				BucketPoints[Count] = 1;
+				BucketRejected[Count] = false;
+				BucketStart = X;
+				Count++;
+				Accepted++;
+				return Closed;
+			}
+			//
+			// Within the current bucket we just keep the least delayed point
+			//
+			if (D > BucketD[Count - 1])
+			{
+				BucketX[Count - 1] = X;
+				BucketD[Count - 1] = D;
+			}
+			BucketPoints[Count - 1]++;
+			Accepted++;
+			return false;
+		}
+
+		//
+		// Perform the fit, supplying the gradient (dY/dX). Only closed buckets
+		// take part, the newest may hold a single delayed sample.
+		//
+
+		bool Fit(Rational_t *Gradient)
+		{
+			unsigned int i;
+			unsigned int Closed = Buckets();
+			bool Use[MINIMUM_DELAY_FIT_BUCKETS];
+			long long Origin;
+			long long Intercept;
+			long long Ppb;
+			long long Residual;
+			long long MeanResidual;
+			unsigned int Discarded;
+			if (Closed < 2)
+				return false;
+			Origin = BucketX[0];
+			for (i = 0; i < Closed; i++)
+				Use[i] = true;
+			if (!FitBuckets(Use, Origin, &Intercept, &Ppb))
+				return false;
+			//
+			// Reject any bucket that lies much further from the line than the average
+			//
+			MeanResidual = 0;
+			for (i = 0; i < Closed; i++)
+			{
+				Residual = BucketD[i] - (Intercept + ((Ppb * (BucketX[i] - Origin)) / MINIMUM_DELAY_FIT_PPB_SCALE));
+				MeanResidual += Abs(Residual);
+			}
+			MeanResidual = max(MeanResidual / Closed, (long long)MINIMUM_DELAY_FIT_MINIMUM_REJECTION / 3);
+			Discarded = 0;
+			for (i = 0; i < Closed; i++)
+			{
+				Residual = BucketD[i] - (Intercept + ((Ppb * (BucketX[i] - Origin)) / MINIMUM_DELAY_FIT_PPB_SCALE));
+				if (Abs(Residual) > (3 * MeanResidual))
+				{
+					Use[i] = false;
+					Discarded++;
+				}
+			}
+			if ((Discarded != 0) && ((Closed - Discarded) >= 2))
+			{
+				//
+				// A bucket may stay an outlier over many fits, count its points once
+				//
+				for (i = 0; i < Closed; i++)
+					if (!Use[i] && !BucketRejected[i])
+					{
+						BucketRejected[i] = true;
+						Accepted -= BucketPoints[i];
+						Rejected += BucketPoints[i];
+					}
+				FitBuckets(Use, Origin, &Intercept, &Ppb);
+			}
+			//
+			// Convert back to the callers coordinates, Y = X + D
+			//
+			FitPpb = Ppb;
+			FitOffset = Intercept - ((Ppb * Origin) / MINIMUM_DELAY_FIT_PPB_SCALE);
+			*Gradient = Rational_t(MINIMUM_DELAY_FIT_PPB_SCALE + Ppb, MINIMUM_DELAY_FIT_PPB_SCALE);
+			return true;
+		}
+
+		//
+		// Read out the value of Y at X according to the last fit
+		//
+
+		long long Evaluate(long long X)
+		{
+			return X + FitOffset + ((FitPpb * X) / MINIMUM_DELAY_FIT_PPB_SCALE);
+		}
+
+		//
+		// Check a new pair of values against the newest bucket, a jump larger
+		// than any credible transport jitter indicates a source discontinuity.
+		//
+
+		bool Discontinuity(long long Y,
+				   long long X,
+				   long long Threshold)
+		{
+			if (Count == 0)
+				return false;
+			return (Abs((Y - X) - BucketD[Count - 1]) > Threshold);
+		}
+};
+
+//
+
+typedef MinimumDelayFit_c MinimumDelayFit_t;
+
+#endif
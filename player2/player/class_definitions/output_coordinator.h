@@ -161,6 +161,9 @@ class OutputCoordinator_c : public BaseComponentClass_c
 								     unsigned long long RequestedOutputTime,
 								     unsigned long long ActualOutputTime) = 0;
 
+		virtual OutputCoordinatorStatus_t SnapToVsyncGrid(OutputCoordinatorContext_t Context,
+								  unsigned long long *SystemTime) = 0;
+
 		virtual OutputCoordinatorStatus_t ClockRecoveryInitialize(PlayerTimeFormat_t SourceTimeFormat) = 0;
 
 		virtual OutputCoordinatorStatus_t ClockRecoveryDataPoint(unsigned long long SourceTime,
@@ -169,6 +172,11 @@ class OutputCoordinator_c : public BaseComponentClass_c
 		virtual OutputCoordinatorStatus_t ClockRecoveryEstimate(unsigned long long *SourceTime,
 									unsigned long long *LocalTime) = 0;
 
+		virtual OutputCoordinatorStatus_t ClockRecoveryStatistics(unsigned long long *ConvergenceTime,
+									  unsigned int *AcceptedPoints,
+									  unsigned int *RejectedPoints,
+									  unsigned int *Discontinuities) = 0;
+
 };
 
 // ---------------------------------------------------------------------
@@ -478,6 +486,8 @@ class OutputCoordinator_c : public BaseComponentClass_c
 
  This function is provided to support dvp control when not using vsync locking, in addition to
  monitoring the vsync offset, the function will adjust the time mapping to eliminate it.
+ It is called for every video frame, and also measures the vsync period and phase used by
+ SnapToVsyncGrid.
 
  \param Context Stream context identifier.
  \param RequestedOutputTime When we wanted the frame to display.
@@ -486,6 +496,21 @@ class OutputCoordinator_c : public BaseComponentClass_c
  \return OutputCoordinator status code, OutputCoordinatorNoError should be returned.
 */
 
+/*! \fn OutputCoordinatorStatus_t OutputCoordinator_c::SnapToVsyncGrid( OutputCoordinatorContext_t Context,
+ unsigned long long *SystemTime );
+ \brief Move a frame output time onto the measured vsync grid.
+
+ The display shows a frame on the vsync nearest its output time, a time lying near the midpoint
+ between two vsyncs is shown on either depending on interrupt latency, breaking the cadence.
+ Placing output times on the vsyncs measured by MonitorVsyncOffset makes the choice of vsync
+ certain. The time is left alone until the grid has been measured.
+
+ \param Context Stream context identifier.
+ \param SystemTime Pointer to the output time, updated in place.
+
+ \return OutputCoordinator status code, OutputCoordinatorNoError should be returned.
+*/
+
 /*! \fn OutputCoordinatorStatus_t OutputCoordinator_c::ClockRecoveryInitialize(
  OutputCoordinatorTimeFormat_t SourceTimeFormat )
 \brief Initialize clock recovery
@@ -520,4 +545,19 @@ time arrived at the box.
 
 \return OutputCoordinator status code, OutputCoordinatorNoError should be returned.
 */
+
+/*! \fn OutputCoordinatorStatus_t OutputCoordinator_c::ClockRecoveryStatistics(
+ unsigned long long *ConvergenceTime,
+ unsigned int *AcceptedPoints,
+ unsigned int *RejectedPoints,
+ unsigned int *Discontinuities )
+\brief Read out the behaviour of the clock recovery estimator
+
+\param ConvergenceTime Local time from the first data point until the recovered rate settled, INVALID_TIME if it has not yet settled.
+\param AcceptedPoints Data points in the current window that the fit uses.
+\param RejectedPoints Data points in the current window discarded by the fit as outliers.
+\param Discontinuities Source clock jumps that caused the fit to restart.
+
+\return OutputCoordinator status code, OutputCoordinatorError if clock recovery has not been initialized.
+*/
 #endif
@@ -232,6 +232,12 @@ class Player_c
 							     unsigned long long *SourceTime,
 							     unsigned long long *LocalTime = NULL) = 0;
 
+		virtual PlayerStatus_t ClockRecoveryStatistics(PlayerPlayback_t Playback,
+							       unsigned long long *ConvergenceTime,
+							       unsigned int *AcceptedPoints = NULL,
+							       unsigned int *RejectedPoints = NULL,
+							       unsigned int *Discontinuities = NULL) = 0;
+
 		//
 		// Mechanisms for data insertion
 		//
@@ -768,6 +774,22 @@ time arrived at the box.
 \return Player status code, PlayerNoError indicates success.
 */
 
+/*! \fn PlayerStatus_t Player_c::ClockRecoveryStatistics( PlayerPlayback_t Playback,
+ unsigned long long *ConvergenceTime,
+ unsigned int *AcceptedPoints = NULL,
+ unsigned int *RejectedPoints = NULL,
+ unsigned int *Discontinuities = NULL )
+\brief Read out clock recovery statistics
+
+\param Playback Playback on which we are recovering a clock
+\param ConvergenceTime Time taken for the recovered rate to settle, INVALID_TIME if it has not yet done so.
+\param AcceptedPoints Data points in the current window that the fit uses.
+\param RejectedPoints Data points in the current window discarded as outliers.
+\param Discontinuities Number of source clock jumps seen.
+
+\return Player status code, PlayerNoError indicates success.
+*/
+
 //
 // Mechanisms for data insertion
 //
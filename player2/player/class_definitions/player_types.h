@@ -197,7 +197,10 @@ typedef enum
 
 	//
 	// Master clock mechanisms, define which clock is going to be used
-	// to master mappings between system time and playback time
+	// to master mappings between system time and playback time.
+	// The transport stream demultiplexor only recovers the source clock
+	// from BluRay (M2TS) arrival time stamps with the system clock as
+	// master, the default video clock master leaves them unused.
 	//
 
 #define PolicyValueVideoClockMaster 0
@@ -231,6 +234,17 @@ typedef enum
 
 	PolicyManifestFirstFrameEarly, // Apply/Disapply
 
+	//
+	// Policy to establish the time mapping as soon as the first video
+	// frame reaches synchronization, without waiting for the other streams
+	// in the playback, or for the startup delay. Intended for channel change,
+	// late streams join the established mapping discarding any data that
+	// precedes it. Audio is discarded in whole decoded frames, so the audio
+	// start can lag the mapping by up to one audio frame duration.
+	//
+
+	PolicySyncStartFast, // Apply/Disapply
+
 	//
 	// Policy to force a null manifestation on shutdown for video
 	// audio must always mute.
@@ -462,6 +476,17 @@ typedef enum
 
 	PolicyUsePTSDeducedDefaultFrameRates,
 
+	//
+	// Display queue depth control for the video manifestor. The target depth
+	// is the number of display entries kept queued ahead of the display, 0
+	// leaves the depth unlimited. The margin threshold is the time, in
+	// microseconds, between queueing a frame and its presentation below which
+	// EventDisplayQueueMarginLow is raised, 0 disables the event.
+	//
+
+	PolicyDisplayQueueTargetDepth,
+	PolicyDisplayQueueMarginThreshold,
+
 //
 
 	PolicyMaxPolicy
@@ -496,6 +521,8 @@ typedef enum
 
 #define EventVsyncOffsetMeasured 0x0000000000020000ull
 #define EventFatalHardwareFailure 0x0000000000040000ull
+#define EventDemuxStatisticsCreated 0x0000000000080000ull
+#define EventDisplayQueueMarginLow 0x0000000000100000ull
 
 // Ongoing events
 #define EventSizeChangeParse 0x0000000100000000ull
@@ -650,6 +677,7 @@ typedef struct PlayerEventRecord_s
 #define SYSFS_ATTRIBUTE_ID_INTEGER SYSFS_ATTRIBUTE_ID_BOOL + 1
 #define SYSFS_ATTRIBUTE_ID_CONSTCHARPOINTER SYSFS_ATTRIBUTE_ID_INTEGER + 1
 #define SYSFS_ATTRIBUTE_ID_UNSIGNEDLONGLONGINT SYSFS_ATTRIBUTE_ID_CONSTCHARPOINTER +1
+#define SYSFS_ATTRIBUTE_ID_CHARBUFFER SYSFS_ATTRIBUTE_ID_UNSIGNEDLONGLONGINT + 1 // Formatted into the caller's CharBuffer
 
 typedef struct PlayerAttributeDescriptor_s
 {
@@ -661,6 +689,11 @@ typedef struct PlayerAttributeDescriptor_s
 		int Int;
 		unsigned long long int UnsignedLongLongInt;
 		bool Bool;
+		struct
+		{
+			char *Buffer; // Supplied by the caller
+			unsigned int Size; // In, the buffer size; out, the length written
+		} CharBuffer;
 	} u;
 
 } PlayerAttributeDescriptor_t;
@@ -41,7 +41,8 @@ Date Modification Name
 typedef enum
 {
 	MuxTypeUnMuxed = 0,
-	MuxTypeTransportStream
+	MuxTypeTransportStream,
+	MuxTypeBluRayTransportStream // 192 byte packets, a 4 byte arrival time stamp before each (M2TS)
 } PlayerInputMuxType_t;
 
 typedef struct PlayerInputDescriptor_s
@@ -461,6 +462,9 @@ typedef enum
 	FormatVideo422_YUYV
 } BufferFormat_t;
 
+#define BUFFER_FORMAT_MASK(Format) (1 << (Format)) // Sets of formats, see Manifestor_c::GetBufferFormats
+#define BUFFER_FORMAT_MASK_ALL 0xffffffff
+
 //
 
 typedef struct BufferStructure_s
@@ -488,6 +492,18 @@ typedef struct BufferStructure_s
 // information feedback mechanism.
 //
 
+typedef enum
+{
+	DecodeCostIndependentFrame = 0,
+	DecodeCostReferenceFrame, // Reference, but not independent
+	DecodeCostNonReferenceFrame,
+	DecodeCostNonReferenceFrameSubstandard,
+
+	DecodeCostClasses
+} DecodeCostClass_t;
+
+//
+
 typedef struct CodecTrickModeParameters_s
 {
 	Rational_t EmpiricalMaximumDecodeFrameRateShortIntegration; // Observed values out of the transformer
@@ -499,6 +515,8 @@ typedef struct CodecTrickModeParameters_s
 	unsigned int DefaultGroupSize;
 	unsigned int DefaultGroupReferenceFrameCount; // Including the key frame
 
+	unsigned long long AverageDecodeTime[DecodeCostClasses]; // Observed per frame class in us, zero until seen
+
 } CodecTrickModeParameters_t;
 
 //
@@ -58,6 +58,7 @@ Codec_DvpVideo_c::Codec_DvpVideo_c()
 	DvpTrickModeParameters.SubstandardDecodeRateIncrease = 1;
 	DvpTrickModeParameters.DefaultGroupSize = 1;
 	DvpTrickModeParameters.DefaultGroupReferenceFrameCount = 1;
+	memset(DvpTrickModeParameters.AverageDecodeTime, 0x00, sizeof(DvpTrickModeParameters.AverageDecodeTime));
 //
 	InitializationStatus = CodecNoError;
 }
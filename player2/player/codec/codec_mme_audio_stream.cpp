@@ -1010,6 +1010,7 @@ CodecStatus_t Codec_MmeAudioStream_c::SendMMETransformCommand(void)
 	flush_cache_all();
 #endif
 	TransformContextBuffer = NULL;
+	TransformContext->DecodeCostClass = DecodeCostClasses; // A transform spans many frames, so it cannot be costed per frame
 	TransformContext->DecodeCommenceTime = OS_GetTimeInMicroSeconds();
 	Status = MME_SendCommand(MMEHandle, &TransformContext->MMECommand);
 	if (Status != MME_SUCCESS)
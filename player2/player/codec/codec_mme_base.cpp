@@ -45,6 +45,8 @@ Date Modification Name
 // Locally defined constants
 //
 
+#define DECODE_COST_AVERAGING_WEIGHT 8 // Each new decode time contributes 1/8th of the per class average
+
 // /////////////////////////////////////////////////////////////////////////
 //
 // Locally defined structures
@@ -242,6 +244,7 @@ CodecStatus_t Codec_MmeBase_c::Reset(void)
 	memset(DecodeTimes, 0x00, 16 * MAX_DECODE_BUFFERS * sizeof(unsigned long long));
 	ShortTotalDecodeTime = 0;
 	LongTotalDecodeTime = 0;
+	memset(Configuration.TrickModeParameters.AverageDecodeTime, 0x00, sizeof(Configuration.TrickModeParameters.AverageDecodeTime));
 //
 	return BaseComponentClass_c::Reset();
 }
@@ -1378,6 +1381,17 @@ CodecStatus_t Codec_MmeBase_c::SendMMEDecodeCommand(void)
 	CodedFrameBuffer->FlushCache();
 #endif
 	DecodeContextBuffer = NULL;
+	DecodeContext->DecodeCostClass = DecodeCostClasses;
+	if (ParsedFrameParameters != NULL)
+	{
+		if (ParsedFrameParameters->IndependentFrame)
+			DecodeContext->DecodeCostClass = DecodeCostIndependentFrame;
+		else if (ParsedFrameParameters->ReferenceFrame)
+			DecodeContext->DecodeCostClass = DecodeCostReferenceFrame;
+		else
+			DecodeContext->DecodeCostClass = ParsedFrameParameters->ApplySubstandardDecode ?
+							 DecodeCostNonReferenceFrameSubstandard : DecodeCostNonReferenceFrame;
+	}
 	DecodeContext->DecodeCommenceTime = OS_GetTimeInMicroSeconds();
 	//report (severity_error, "Sending actual MME Decode frame command %d\n",DecodeContext->MMECommand.CmdCode);
 	Status = MME_SendCommand(MMEHandle, &DecodeContext->MMECommand);
@@ -1539,6 +1553,7 @@ CodecStatus_t Codec_MmeBase_c::CalculateMaximumFrameRate(CodecBaseDecodeContext_
 {
 	unsigned long long Now;
 	unsigned long long DecodeTime;
+	unsigned long long *AverageDecodeTime;
 //
 	Now = OS_GetTimeInMicroSeconds();
 	DecodeTime = min(Now - DecodeContext->DecodeCommenceTime, Now - LastDecodeCompletionTime);
@@ -1561,6 +1576,17 @@ CodecStatus_t Codec_MmeBase_c::CalculateMaximumFrameRate(CodecBaseDecodeContext_
 	DecodeTimes[NextDecodeTime % DecodeTimeLongIntegrationPeriod] = DecodeTime;
 	NextDecodeTime++;
 	LastDecodeCompletionTime = Now;
+	//
+	// Keep a running average per class of frame, allowing the output
+	// timer to cost the decode of each type of frame separately.
+	//
+	if (DecodeContext->DecodeCostClass < DecodeCostClasses)
+	{
+		AverageDecodeTime = &Configuration.TrickModeParameters.AverageDecodeTime[DecodeContext->DecodeCostClass];
+		*AverageDecodeTime = (*AverageDecodeTime == 0) ?
+				     DecodeTime :
+				     (((DECODE_COST_AVERAGING_WEIGHT - 1) * (*AverageDecodeTime)) + DecodeTime) / DECODE_COST_AVERAGING_WEIGHT;
+	}
 //
 #if 0
 	if ((NextDecodeTime % DecodeTimeIntegrationPeriod) == 0)
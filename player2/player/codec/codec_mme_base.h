@@ -282,6 +282,7 @@ typedef struct CodecBaseDecodeContext_s
 	ReferenceFrameList_t ReferenceFrameList[MAX_REFERENCE_FRAME_LISTS];
 
 	unsigned long long DecodeCommenceTime;
+	DecodeCostClass_t DecodeCostClass;
 } CodecBaseDecodeContext_t;
 
 // /////////////////////////////////////////////////////////////////////////
@@ -72,6 +72,8 @@ CodecStatus_t Codec_MmeVideo_c::Reset(void)
 	VideoOutputSurface = NULL;
 	ParsedVideoParameters = NULL;
 	KnownLastSliceInFieldFrame = false;
+	ManifestorBufferFormats = BUFFER_FORMAT_MASK_ALL;
+	CheckedDecodeOutputFormat = FormatUnknown;
 	return Codec_MmeBase_c::Reset();
 }
 
@@ -101,6 +103,12 @@ CodecStatus_t Codec_MmeVideo_c::RegisterOutputBufferRing(Ring_t Ring)
 			SetComponentState(ComponentInError);
 			return Status;
 		}
+		//
+		// And the buffer formats the surface displays in place
+		//
+		if (Manifestor->GetBufferFormats(&ManifestorBufferFormats) != ManifestorNoError)
+			ManifestorBufferFormats = BUFFER_FORMAT_MASK_ALL;
+		CheckedDecodeOutputFormat = FormatUnknown;
 	}
 //
 	return CodecNoError;
@@ -125,6 +133,11 @@ CodecStatus_t Codec_MmeVideo_c::Input(Buffer_t CodedBuffer)
 	//
 	AssertComponentState("Codec_MmeVideo_c::Input", ComponentRunning);
 	//
+	// Refuse a stream the surface cannot display before taking any contexts
+	//
+	if (!DecodeOutputFormatDisplayable())
+		return CodecError;
+	//
 	// First perform base operations
 	//
 	Status = Codec_MmeBase_c::Input(CodedBuffer);
@@ -352,6 +365,28 @@ CodecStatus_t Codec_MmeVideo_c::InitializeDataTypes(void)
 	return Codec_MmeBase_c::InitializeDataTypes();
 }
 
+// /////////////////////////////////////////////////////////////////////////
+//
+// Check the decode output format against those the surface reads in place,
+// rather than allocating a pool of buffers it cannot display. The first
+// refusal marks the stream unplayable, so no further frames reach us, the
+// refusals after it (frames already parsed) are silent.
+//
+
+bool Codec_MmeVideo_c::DecodeOutputFormatDisplayable(void)
+{
+	if ((ManifestorBufferFormats & BUFFER_FORMAT_MASK(Configuration.DecodeOutputFormat)) != 0)
+		return true;
+	if (Configuration.DecodeOutputFormat != CheckedDecodeOutputFormat)
+	{
+		report(severity_error, "Codec_MmeVideo_c::DecodeOutputFormatDisplayable(%s) - Decode output format %d cannot be displayed by the output surface (formats %08x).\n",
+		       Configuration.CodecName, Configuration.DecodeOutputFormat, ManifestorBufferFormats);
+		CheckedDecodeOutputFormat = Configuration.DecodeOutputFormat;
+		Player->MarkStreamUnPlayable(Stream);
+	}
+	return false;
+}
+
 // /////////////////////////////////////////////////////////////////////////
 //
 // The generic video function used to fill out a buffer structure
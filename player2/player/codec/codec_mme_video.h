@@ -66,8 +66,13 @@ class Codec_MmeVideo_c : public Codec_MmeBase_c
 		ParsedVideoParameters_t *ParsedVideoParameters;
 		bool KnownLastSliceInFieldFrame;
 
+		unsigned int ManifestorBufferFormats;
+		BufferFormat_t CheckedDecodeOutputFormat;
+
 		// Functions
 
+		bool DecodeOutputFormatDisplayable(void);
+
 	public:
 
 		//
@@ -447,7 +447,10 @@ CodecStatus_t Codec_MmeVideoFlv1_c::FillOutDecodeCommand(void)
 
 CodecStatus_t Codec_MmeVideoFlv1_c::FillOutDecodeBufferRequest(BufferStructure_t *Request)
 {
-	Codec_MmeVideo_c::FillOutDecodeBufferRequest(Request);
+	CodecStatus_t Status;
+	Status = Codec_MmeVideo_c::FillOutDecodeBufferRequest(Request);
+	if (Status != CodecNoError)
+		return Status;
 	Request->ComponentBorder[0] = 16;
 	Request->ComponentBorder[1] = 16;
 	return CodecNoError;
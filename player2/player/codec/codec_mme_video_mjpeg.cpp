@@ -419,6 +419,7 @@ CodecStatus_t Codec_MmeVideoMjpeg_c::SendMMEDecodeCommand(void)
 	flush_cache_all();
 #endif
 	DecodeContextBuffer = NULL;
+	DecodeContext->DecodeCostClass = DecodeCostIndependentFrame;
 	DecodeContext->DecodeCommenceTime = OS_GetTimeInMicroSeconds();
 	//report (severity_error, "Sending actual MME Decode frame command %d\n",DecodeContext->MMECommand.CmdCode);
 	MMEStatus = MME_SendCommand(MMEHandle, &DecodeContext->MMECommand);
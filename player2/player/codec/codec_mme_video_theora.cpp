@@ -657,9 +657,12 @@ CodecStatus_t Codec_MmeVideoTheora_c::FillOutDecodeCommand(void)
 
 CodecStatus_t Codec_MmeVideoTheora_c::FillOutDecodeBufferRequest(BufferStructure_t *Request)
 {
+	CodecStatus_t Status;
 	CODEC_DEBUG("%s\n", __FUNCTION__);
 	//Request->Format = Configuration.DecodeOutputFormat;
-	Codec_MmeVideo_c::FillOutDecodeBufferRequest(Request);
+	Status = Codec_MmeVideo_c::FillOutDecodeBufferRequest(Request);
+	if (Status != CodecNoError)
+		return Status;
 	Request->ComponentBorder[0] = 16;
 	Request->ComponentBorder[1] = 16;
 	return CodecNoError;
@@ -382,7 +382,10 @@ CodecStatus_t Codec_MmeVideoVp6_c::FillOutDecodeCommand(void)
 
 CodecStatus_t Codec_MmeVideoVp6_c::FillOutDecodeBufferRequest(BufferStructure_t *Request)
 {
-	Codec_MmeVideo_c::FillOutDecodeBufferRequest(Request);
+	CodecStatus_t Status;
+	Status = Codec_MmeVideo_c::FillOutDecodeBufferRequest(Request);
+	if (Status != CodecNoError)
+		return Status;
 	Request->ComponentBorder[0] = 32;
 	Request->ComponentBorder[1] = 32;
 	return CodecNoError;
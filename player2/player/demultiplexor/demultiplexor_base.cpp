@@ -206,6 +206,19 @@ DemultiplexorStatus_t Demultiplexor_Base_c::InputJump(
 	return DemultiplexorError;
 }
 
+// /////////////////////////////////////////////////////////////////////////
+//
+// The default clock recovery identifier function, formats with no
+// clock references of their own ignore it
+//
+
+DemultiplexorStatus_t Demultiplexor_Base_c::SetClockRecoveryIdentifier(
+	DemultiplexorContext_t Context,
+	unsigned int StreamIdentifier)
+{
+	return DemultiplexorNoError;
+}
+
 // /////////////////////////////////////////////////////////////////////////
 //
 // The demux function
@@ -121,6 +121,9 @@ class Demultiplexor_Base_c : public Demultiplexor_c
 
 		DemultiplexorStatus_t InputJump(DemultiplexorContext_t Context);
 
+		DemultiplexorStatus_t SetClockRecoveryIdentifier(DemultiplexorContext_t Context,
+								 unsigned int StreamIdentifier);
+
 		DemultiplexorStatus_t Demux(PlayerPlayback_t Playback,
 					    DemultiplexorContext_t Context,
 					    Buffer_t Buffer);
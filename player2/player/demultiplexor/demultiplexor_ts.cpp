@@ -43,6 +43,8 @@ Date Modification Name
 
 #define MINIMUM_TIME_BETWEEN_GLITCH_PRINTS 2000 // Milli seconds
 
+extern "C" int sprintf(char *buf, const char *fmt, ...);
+
 // /////////////////////////////////////////////////////////////////////////
 //
 // Locally defined structures
@@ -66,10 +68,202 @@ Demultiplexor_Ts_c::Demultiplexor_Ts_c(void)
 	InitializationStatus = DemultiplexorError;
 //
 	Demultiplexor_Base_c::SetContextSize(sizeof(struct DemultiplexorContext_s));
+	StatisticsEntries = NULL;
+	if (OS_InitializeMutex(&StatisticsLock) != OS_NO_ERROR)
+	{
+		report(severity_error, "Demultiplexor_Ts_c::Demultiplexor_Ts_c - Unable to create the statistics lock\n");
+		return;
+	}
 //
 	InitializationStatus = DemultiplexorNoError;
 }
 
+// /////////////////////////////////////////////////////////////////////////
+//
+// The Destructor function
+//
+
+Demultiplexor_Ts_c::~Demultiplexor_Ts_c(void)
+{
+	DemultiplexorStatistics_c *Entry;
+//
+	while (StatisticsEntries != NULL)
+	{
+		Entry = StatisticsEntries;
+		StatisticsEntries = Entry->Next;
+		delete Entry;
+	}
+	if (InitializationStatus == DemultiplexorNoError)
+		OS_TerminateMutex(&StatisticsLock);
+}
+
+// /////////////////////////////////////////////////////////////////////////
+//
+// The context functions attach each context to a statistics entry, reusing
+// one left by a destroyed context if there is one.
+//
+
+DemultiplexorStatus_t Demultiplexor_Ts_c::CreateContext(DemultiplexorContext_t *Context)
+{
+	DemultiplexorStatus_t Status;
+	DemultiplexorStatistics_c *Entry;
+//
+	Status = Demultiplexor_Base_c::CreateContext(Context);
+	if (Status != DemultiplexorNoError)
+		return Status;
+//
+	OS_LockMutex(&StatisticsLock);
+	for (Entry = StatisticsEntries; Entry != NULL; Entry = Entry->Next)
+		if (Entry->Context == NULL)
+			break;
+	if (Entry == NULL)
+	{
+		Entry = new DemultiplexorStatistics_c;
+		if (Entry == NULL)
+		{
+			OS_UnLockMutex(&StatisticsLock);
+			report(severity_error, "Demultiplexor_Ts_c::CreateContext - Unable to create the statistics entry\n");
+			Demultiplexor_Base_c::DestroyContext(*Context);
+			return DemultiplexorError;
+		}
+		Entry->Demultiplexor = this;
+		Entry->Next = StatisticsEntries;
+		StatisticsEntries = Entry;
+	}
+	Entry->Context = *Context;
+	(*Context)->Statistics = Entry;
+	OS_UnLockMutex(&StatisticsLock);
+	return DemultiplexorNoError;
+}
+
+//
+
+DemultiplexorStatus_t Demultiplexor_Ts_c::DestroyContext(DemultiplexorContext_t Context)
+{
+	OS_LockMutex(&StatisticsLock);
+	Context->Statistics->Context = NULL;
+	OS_UnLockMutex(&StatisticsLock);
+	return Demultiplexor_Base_c::DestroyContext(Context);
+}
+
+// /////////////////////////////////////////////////////////////////////////
+//
+// The statistics are read as a table, one line per pid of the context
+// the entry is attached to. Rates are left to the reader, from the counts
+// and the milliseconds over which they ran. A context feeding clock
+// recovery adds a line giving its state.
+// The counters are read under the context lock they are written under,
+// so the 64 bit byte count cannot be seen half updated. The statistics
+// lock keeps the context from being destroyed while we do so.
+// The table is formatted into the caller's buffer, so concurrent readers
+// each get their own copy.
+//
+
+PlayerStatus_t DemultiplexorStatistics_c::GetAttribute(
+	const char *Attribute,
+	PlayerAttributeDescriptor_t *Value)
+{
+	return Demultiplexor->GetStatistics(this, Attribute, Value);
+}
+
+//
+
+PlayerStatus_t Demultiplexor_Ts_c::GetStatistics(
+	DemultiplexorStatistics_c *Entry,
+	const char *Attribute,
+	PlayerAttributeDescriptor_t *Value)
+{
+	unsigned int i;
+	unsigned int Length;
+	unsigned long long Now;
+	unsigned long long ConvergenceTime;
+	unsigned int Accepted;
+	unsigned int Rejected;
+	unsigned int Discontinuities;
+	char *Statistics;
+	unsigned int Size;
+	DemultiplexorContext_t Context;
+	DemultiplexorStreamContext_t *Stream;
+//
+	if (strcmp(Attribute, "demux_statistics") != 0)
+		return PlayerNotSupported;
+//
+	Statistics = Value->u.CharBuffer.Buffer;
+	Size = Value->u.CharBuffer.Size;
+	if ((Statistics == NULL) || (Size < 128))
+	{
+		report(severity_error, "Demultiplexor_Ts_c::GetStatistics - No buffer supplied for %s.\n", Attribute);
+		return PlayerError;
+	}
+//
+	OS_LockMutex(&StatisticsLock);
+	Context = Entry->Context;
+	if (Context == NULL)
+	{
+		OS_UnLockMutex(&StatisticsLock);
+		return PlayerError;
+	}
+	OS_LockMutex(&Context->Base.Lock);
+	Now = OS_GetTimeInMilliSeconds();
+	Length = sprintf(Statistics, "pid packets bytes cc_errors repeats invalid priority_discards ms\n");
+	for (i = 0; i < DEMULTIPLEXOR_MAX_STREAMS; i++)
+	{
+		Stream = &Context->Streams[i];
+		if ((Context->Base.Streams[i].Stream == NULL) || ((Length + 128) > Size))
+			continue;
+		Length += sprintf(Statistics + Length, "0x%04x %u %llu %u %u %u %u %u\n",
+				  Stream->Pid, Stream->Packets, Stream->PayloadBytes,
+				  Stream->ContinuityErrors, Stream->RepeatedPackets,
+				  Stream->InvalidPackets, Stream->PriorityDiscards,
+				  (unsigned int)(Now - Stream->StatisticsStart));
+	}
+	//
+	// The clock recovery we feed, convergence in microseconds (-1 until it settles)
+	//
+	if (Context->ClockRecoveryInitialized && ((Length + 128) <= Size) &&
+			(Player->ClockRecoveryStatistics(Context->Playback, &ConvergenceTime, &Accepted, &Rejected, &Discontinuities) == PlayerNoError))
+		Length += sprintf(Statistics + Length, "clock_recovery converged_us %lld accepted %u rejected %u discontinuities %u\n",
+				  (ConvergenceTime == INVALID_TIME) ? -1LL : (long long)ConvergenceTime,
+				  Accepted, Rejected, Discontinuities);
+	OS_UnLockMutex(&Context->Base.Lock);
+	OS_UnLockMutex(&StatisticsLock);
+//
+	Value->Id = SYSFS_ATTRIBUTE_ID_CHARBUFFER;
+	Value->u.CharBuffer.Size = Length;
+	return PlayerNoError;
+}
+
+// /////////////////////////////////////////////////////////////////////////
+//
+// Ask for the statistics entry of any newly added stream, done from the
+// demux pass as that is where we know the playback.
+//
+
+void Demultiplexor_Ts_c::AnnounceStatistics(
+	PlayerPlayback_t Playback,
+	DemultiplexorContext_t Context)
+{
+	unsigned int i;
+	PlayerEventRecord_t Event;
+//
+	Context->AnnounceStatistics = false;
+	for (i = 0; i < DEMULTIPLEXOR_MAX_STREAMS; i++)
+	{
+		if ((Context->Base.Streams[i].Stream == NULL) ||
+				(Context->Base.Streams[i].Stream == Context->Streams[i].AnnouncedStream))
+			continue;
+		Context->Streams[i].AnnouncedStream = Context->Base.Streams[i].Stream;
+		Event.Code = EventDemuxStatisticsCreated;
+		Event.Playback = Playback;
+		Event.Stream = Context->Base.Streams[i].Stream;
+		Event.PlaybackTime = TIME_NOT_APPLICABLE;
+		Event.UserData = NULL;
+		Event.Value[0].Pointer = Context->Statistics; // pointer to the component
+		if (Player->SignalEvent(&Event) != PlayerNoError)
+			report(severity_error, "Demultiplexor_Ts_c::AnnounceStatistics - Failed to signal event.\n");
+	}
+}
+
 // /////////////////////////////////////////////////////////////////////////
 //
 // The add a stream to a context function
@@ -99,6 +293,7 @@ DemultiplexorStatus_t Demultiplexor_Ts_c::AddStream(
 	if (Status != DemultiplexorNoError)
 		return Status;
 //
+	OS_LockMutex(&Context->Base.Lock);
 	PidTableIndex = (StreamIdentifier & (DVB_MAX_PIDS - 1));
 	Context->PidTable[PidTableIndex] = Context->Base.LastStreamSet + 1;
 	Context->Streams[Context->Base.LastStreamSet].ValidExpectedContinuityCount = false;
@@ -108,7 +303,17 @@ DemultiplexorStatus_t Demultiplexor_Ts_c::AddStream(
 	Context->Streams[Context->Base.LastStreamSet].SelectOnPriority = ((StreamIdentifier & DEMULTIPLEXOR_SELECT_ON_PRIORITY) != 0);
 	Context->Streams[Context->Base.LastStreamSet].DesiredPriority = ((StreamIdentifier & DEMULTIPLEXOR_PRIORITY_HIGH) != 0);
 	Context->Streams[Context->Base.LastStreamSet].TimeOfLastDiscontinuityPrint = INVALID_TIME;
+	Context->Streams[Context->Base.LastStreamSet].Pid = PidTableIndex;
+	Context->Streams[Context->Base.LastStreamSet].StatisticsStart = OS_GetTimeInMilliSeconds();
+	Context->Streams[Context->Base.LastStreamSet].Packets = 0;
+	Context->Streams[Context->Base.LastStreamSet].PayloadBytes = 0;
+	Context->Streams[Context->Base.LastStreamSet].ContinuityErrors = 0;
+	Context->Streams[Context->Base.LastStreamSet].RepeatedPackets = 0;
+	Context->Streams[Context->Base.LastStreamSet].InvalidPackets = 0;
+	Context->Streams[Context->Base.LastStreamSet].PriorityDiscards = 0;
 	Context->AddedNewStream = true;
+	Context->AnnounceStatistics = true;
+	OS_UnLockMutex(&Context->Base.Lock);
 //
 	return DemultiplexorError;
 }
@@ -142,10 +347,106 @@ DemultiplexorStatus_t Demultiplexor_Ts_c::InputJump(
 	//
 	for (i = 0; i < DEMULTIPLEXOR_MAX_STREAMS; i++)
 		Context->Streams[i].ValidExpectedContinuityCount = false;
+	Context->ArrivalTimeValid = false;
+	Context->ClockRecoveryInitialized = false;
 //
 	return Demultiplexor_Base_c::InputJump(Context);
 }
 
+// /////////////////////////////////////////////////////////////////////////
+//
+// The set clock recovery identifier function, nominates the PCR pid
+//
+
+DemultiplexorStatus_t Demultiplexor_Ts_c::SetClockRecoveryIdentifier(
+	DemultiplexorContext_t Context,
+	unsigned int StreamIdentifier)
+{
+	OS_LockMutex(&Context->Base.Lock);
+	if (!Context->PcrPidValid || (Context->PcrPid != StreamIdentifier))
+		Context->ClockRecoveryInitialized = false;
+	Context->PcrPidValid = (StreamIdentifier < DVB_MAX_PIDS);
+	Context->PcrPid = StreamIdentifier;
+	OS_UnLockMutex(&Context->Base.Lock);
+//
+	return DemultiplexorNoError;
+}
+
+// /////////////////////////////////////////////////////////////////////////
+//
+// Pass on a clock recovery data point. Initializing the clock recovery
+// restarts its fit, so we do it only for the first point from a source,
+// or when the source changes format.
+//
+
+void Demultiplexor_Ts_c::ClockRecoveryDataPoint(
+	PlayerPlayback_t Playback,
+	DemultiplexorContext_t Context,
+	PlayerTimeFormat_t SourceTimeFormat,
+	unsigned long long SourceTime,
+	unsigned long long LocalTime)
+{
+	if (!Context->ClockRecoveryInitialized || (Context->ClockRecoveryFormat != SourceTimeFormat))
+	{
+		if (Player->ClockRecoveryInitialize(Playback, SourceTimeFormat) != PlayerNoError)
+			return;
+		Context->ClockRecoveryInitialized = true;
+		Context->ClockRecoveryFormat = SourceTimeFormat;
+	}
+	Player->ClockRecoveryDataPoint(Playback, SourceTime, LocalTime);
+}
+
+// /////////////////////////////////////////////////////////////////////////
+//
+// Pass on a PCR as a clock recovery data point, we use only the 90Khz
+// base, the extension being well below the resolution of the arrival time.
+// The clock recovery handles the wrap of the 33 bit value.
+//
+
+void Demultiplexor_Ts_c::PcrDataPoint(
+	PlayerPlayback_t Playback,
+	DemultiplexorContext_t Context,
+	unsigned char *Packet,
+	unsigned long long LocalTime)
+{
+	unsigned long long Pcr;
+//
+	Pcr = ((unsigned long long)DVB_GET_PCR_BIT_32(Packet) << 32) | (unsigned int)DVB_GET_PCR_BITS_0_TO_31(Packet);
+	ClockRecoveryDataPoint(Playback, Context, TimeFormatPts, Pcr, LocalTime);
+}
+
+// /////////////////////////////////////////////////////////////////////////
+//
+// The arrival time stamp of the first packet in a BluRay buffer is the
+// source clock at which it left the mux, we pass it on (once per buffer)
+// as a clock recovery data point against the time the buffer reached us.
+// Only worth doing when the system clock is master, which is not the
+// default (see PolicyMasterClock), so the application has to select it.
+//
+
+void Demultiplexor_Ts_c::ArrivalTimeDataPoint(
+	PlayerPlayback_t Playback,
+	DemultiplexorContext_t Context,
+	unsigned long long LocalTime)
+{
+	unsigned int ArrivalTime;
+	unsigned char *Data = Context->Base.BufferData;
+//
+	if (Player->PolicyValue(Playback, PlayerAllStreams, PolicyMasterClock) != PolicyValueSystemClockMaster)
+		return;
+	ArrivalTime = ((Data[0] & 0x3f) << 24) | (Data[1] << 16) | (Data[2] << 8) | Data[3];
+	if (!Context->ArrivalTimeValid)
+	{
+		Context->ArrivalTimeBaseLine = 0;
+		Context->ArrivalTimeValid = true;
+	}
+	else if (ArrivalTime < Context->LastArrivalTime)
+		Context->ArrivalTimeBaseLine += DEMULTIPLEXOR_ARRIVAL_TIME_WRAP;
+	Context->LastArrivalTime = ArrivalTime;
+//
+	ClockRecoveryDataPoint(Playback, Context, TimeFormatUs, (Context->ArrivalTimeBaseLine + ArrivalTime) / 27, LocalTime);
+}
+
 // /////////////////////////////////////////////////////////////////////////
 //
 // The demux function
@@ -165,16 +466,28 @@ DemultiplexorStatus_t Demultiplexor_Ts_c::Demux(
 	bool DeferredValidExpectedContinuityCount;
 	DemultiplexorStreamContext_t *Stream;
 	DemultiplexorBaseStreamContext_t *BaseStream;
+	unsigned long long ArrivalTime = OS_GetTimeInMicroSeconds();
 //
 	Status = Demultiplexor_Base_c::Demux(Playback, Context, Buffer);
 	if (Status != DemultiplexorNoError)
 		return Status;
 //
+	Context->Playback = Playback;
+	if (Context->AnnounceStatistics)
+		AnnounceStatistics(Playback, Context);
 	//
-	// If the packet is a multiple of s BluRay packet assume they're BluRay packets
+	// BluRay packets declared as such by the injector need no detection,
+	// otherwise if the packet is a multiple of s BluRay packet assume they're BluRay packets
 	//
-	if (Context->AddedNewStream ||
-			(Context->Base.BufferLength % (DVB_PACKET_SIZE + Context->BluRayExtraData)) != 0)
+	if (Context->Base.Descriptor->MuxType == MuxTypeBluRayTransportStream)
+	{
+		Context->BluRayExtraData = 4;
+		Context->AddedNewStream = false;
+		if (!Context->PcrPidValid && (Context->Base.BufferLength >= (DVB_PACKET_SIZE + 4)))
+			ArrivalTimeDataPoint(Playback, Context, ArrivalTime);
+	}
+	else if (Context->AddedNewStream ||
+			 (Context->Base.BufferLength % (DVB_PACKET_SIZE + Context->BluRayExtraData)) != 0)
 	{
 		Context->BluRayExtraData = 0; // Default to DVB
 		if ((Context->Base.BufferLength % (DVB_PACKET_SIZE + 4)) == 0)
@@ -243,6 +556,9 @@ DemultiplexorStatus_t Demultiplexor_Ts_c::Demux(
 		// Extract the pid, is it interesting
 		//
 		Pid = DVB_PID(Header);
+		if (Context->PcrPidValid && (Pid == Context->PcrPid) && DVB_VALID_PACKET(Header) &&
+				DVB_PCR_PRESENT(Header, &Context->Base.BufferData[NewPacketStart]))
+			PcrDataPoint(Playback, Context, &Context->Base.BufferData[NewPacketStart], ArrivalTime);
 		if (Context->PidTable[Pid] == 0)
 			continue;
 		Entry = Context->PidTable[Pid] - 1;
@@ -251,8 +567,10 @@ DemultiplexorStatus_t Demultiplexor_Ts_c::Demux(
 		//
 		// We are interested, Check validity of packet
 		//
+		Stream->Packets++;
 		if (!DVB_VALID_PACKET(Header))
 		{
+			Stream->InvalidPackets++;
 			report(severity_error, "Demultiplexor_Ts_c::Demux - Invalid packet (%02x %02x %02x %02x)\n",
 			       Context->Base.BufferData[NewPacketStart], Context->Base.BufferData[NewPacketStart + 1], Context->Base.BufferData[NewPacketStart + 2], Context->Base.BufferData[NewPacketStart + 3]);
 			continue;
@@ -280,7 +598,11 @@ DemultiplexorStatus_t Demultiplexor_Ts_c::Demux(
 			// Check for repeat packet - if so skip whole packet
 			//
 			if (((DVB_CONTINUITY_COUNT(Header) + 1) & 0x0f) == Stream->ExpectedContinuityCount)
+			{
+				Stream->RepeatedPackets++;
 				continue;
+			}
+			Stream->ContinuityErrors++;
 			report(severity_error, "Demultiplexor_Ts_c::Demux - Noted a continuity count error, forcing a glitch.\n");
 			Player->InputGlitch(PlayerAllPlaybacks, BaseStream->Stream);
 		}
@@ -291,12 +613,16 @@ DemultiplexorStatus_t Demultiplexor_Ts_c::Demux(
 		// must take place after the continuity check).
 		//
 		if (Stream->SelectOnPriority && Stream->DesiredPriority != (bool) DVB_PRIORITY(Header))
+		{
+			Stream->PriorityDiscards++;
 			continue;
+		}
 		//
 		// Pass on to the appropriate collator
 		//
 		if (DVB_PAYLOAD_PRESENT(Header) && (DataOffset < DVB_PACKET_SIZE))
 		{
+			Stream->PayloadBytes += DVB_PACKET_SIZE - DataOffset;
 			//
 			// Ignore return status (others may be interested in this stream)
 			//
@@ -48,6 +48,8 @@ Date Modification Name
 #define DEMULTIPLEXOR_PRIORITY_HIGH 0x00004000
 #define DEMULTIPLEXOR_PRIORITY_LOW 0x00000000
 
+#define DEMULTIPLEXOR_ARRIVAL_TIME_WRAP 0x40000000ULL // 30 bit arrival time stamp at 27MHz
+
 // /////////////////////////////////////////////////////////////////////////
 //
 // Locally defined structures
@@ -60,10 +62,26 @@ typedef struct DemultiplexorStreamContext_s
 	bool SelectOnPriority;
 	bool DesiredPriority;
 	unsigned long long TimeOfLastDiscontinuityPrint;
+
+	//
+	// Statistics, written and read under the context lock
+	//
+
+	PlayerStream_t AnnouncedStream; // Stream whose sysfs entry has been requested
+	unsigned int Pid;
+	unsigned long long StatisticsStart;
+	unsigned int Packets;
+	unsigned long long PayloadBytes;
+	unsigned int ContinuityErrors;
+	unsigned int RepeatedPackets;
+	unsigned int InvalidPackets;
+	unsigned int PriorityDiscards;
 } DemultiplexorStreamContext_t;
 
 //
 
+class DemultiplexorStatistics_c;
+
 struct DemultiplexorContext_s
 {
 	struct DemultiplexorBaseContext_s Base;
@@ -71,8 +89,22 @@ struct DemultiplexorContext_s
 	DemultiplexorStreamContext_t Streams[DEMULTIPLEXOR_MAX_STREAMS];
 	unsigned char PidTable[DVB_MAX_PIDS];
 
+	DemultiplexorStatistics_c *Statistics; // The component its streams' statistics are read through
+
 	bool AddedNewStream;
+	bool AnnounceStatistics;
 	unsigned int BluRayExtraData;
+
+	bool ArrivalTimeValid; // M2TS arrival time stamps, unwrapped for clock recovery
+	unsigned int LastArrivalTime;
+	unsigned long long ArrivalTimeBaseLine;
+
+	bool PcrPidValid; // PCRs on this pid are fed to clock recovery, in preference to arrival times
+	unsigned int PcrPid;
+
+	PlayerPlayback_t Playback; // Whose clock recovery we feed, for the statistics
+	bool ClockRecoveryInitialized; // Cleared to restart the fit, on a new PCR pid or an input jump
+	PlayerTimeFormat_t ClockRecoveryFormat;
 };
 
 // /////////////////////////////////////////////////////////////////////////
@@ -86,8 +118,35 @@ class Demultiplexor_Ts_c : public Demultiplexor_Base_c
 
 		// Data
 
+		OS_Mutex_t StatisticsLock;
+		DemultiplexorStatistics_c *StatisticsEntries; // Kept until we go, sysfs may still hold them
+
 		// Functions
 
+		friend class DemultiplexorStatistics_c;
+
+		PlayerStatus_t GetStatistics(DemultiplexorStatistics_c *Entry,
+					     const char *Attribute,
+					     PlayerAttributeDescriptor_t *Value);
+
+		void AnnounceStatistics(PlayerPlayback_t Playback,
+					DemultiplexorContext_t Context);
+
+		void ClockRecoveryDataPoint(PlayerPlayback_t Playback,
+					    DemultiplexorContext_t Context,
+					    PlayerTimeFormat_t SourceTimeFormat,
+					    unsigned long long SourceTime,
+					    unsigned long long LocalTime);
+
+		void ArrivalTimeDataPoint(PlayerPlayback_t Playback,
+					  DemultiplexorContext_t Context,
+					  unsigned long long LocalTime);
+
+		void PcrDataPoint(PlayerPlayback_t Playback,
+				  DemultiplexorContext_t Context,
+				  unsigned char *Packet,
+				  unsigned long long LocalTime);
+
 	public:
 
 		//
@@ -95,6 +154,15 @@ class Demultiplexor_Ts_c : public Demultiplexor_Base_c
 		//
 
 		Demultiplexor_Ts_c(void);
+		~Demultiplexor_Ts_c(void);
+
+		//
+		// Context management functions
+		//
+
+		DemultiplexorStatus_t CreateContext(DemultiplexorContext_t *Context);
+
+		DemultiplexorStatus_t DestroyContext(DemultiplexorContext_t Context);
 
 		//
 		// API functions
@@ -111,10 +179,32 @@ class Demultiplexor_Ts_c : public Demultiplexor_Base_c
 
 		DemultiplexorStatus_t InputJump(DemultiplexorContext_t Context);
 
+		DemultiplexorStatus_t SetClockRecoveryIdentifier(DemultiplexorContext_t Context,
+								 unsigned int StreamIdentifier);
+
 		DemultiplexorStatus_t Demux(PlayerPlayback_t Playback,
 					    DemultiplexorContext_t Context,
 					    Buffer_t Buffer);
 };
 
+// /////////////////////////////////////////////////////////////////////////
+//
+// The component a context's statistics are read through, one per context
+// so each stream's entry covers its own context only. It outlives the
+// context, which is detached (under the statistics lock) when destroyed.
+//
+
+class DemultiplexorStatistics_c : public BaseComponentClass_c
+{
+	public:
+
+		Demultiplexor_Ts_c *Demultiplexor;
+		DemultiplexorContext_t Context;
+		DemultiplexorStatistics_c *Next;
+
+		PlayerStatus_t GetAttribute(const char *Attribute,
+					    PlayerAttributeDescriptor_t *Value);
+};
+
 #endif
 
@@ -578,6 +578,16 @@ ManifestorStatus_t Manifestor_Base_c::GetDecodeBufferCount(unsigned int *Count)
 	return ManifestorNoError;
 }
 
+// /////////////////////////////////////////////////////////////////////
+//
+// The default buffer formats function, any format can be manifested
+
+ManifestorStatus_t Manifestor_Base_c::GetBufferFormats(unsigned int *Formats)
+{
+	*Formats = BUFFER_FORMAT_MASK_ALL;
+	return ManifestorNoError;
+}
+
 // /////////////////////////////////////////////////////////////////////
 //
 // The default synchronize output function
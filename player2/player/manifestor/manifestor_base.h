@@ -220,6 +220,8 @@ class Manifestor_Base_c : public Manifestor_c
 
 		ManifestorStatus_t GetDecodeBufferCount(unsigned int *Count);
 
+		virtual ManifestorStatus_t GetBufferFormats(unsigned int *Formats);
+
 		ManifestorStatus_t SynchronizeOutput(void);
 
 		// Support functions for derived classes
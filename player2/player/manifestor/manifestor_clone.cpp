@@ -289,6 +289,16 @@ ManifestorStatus_t Manifestor_Clone_c::GetDecodeBufferCount(unsigned int *Count)
 	return Original->GetDecodeBufferCount(Count);
 }
 
+// /////////////////////////////////////////////////////////////////////////
+//
+// GetBufferFormats - the buffers come from the original, so do the formats
+//
+
+ManifestorStatus_t Manifestor_Clone_c::GetBufferFormats(unsigned int *Formats)
+{
+	return Original->GetBufferFormats(Formats);
+}
+
 // /////////////////////////////////////////////////////////////////////////
 //
 // SynchronizeOutput
@@ -134,6 +134,8 @@ class Manifestor_Clone_c : public Manifestor_c
 
 		ManifestorStatus_t GetDecodeBufferCount(unsigned int *Count);
 
+		ManifestorStatus_t GetBufferFormats(unsigned int *Formats);
+
 		ManifestorStatus_t SynchronizeOutput(void);
 
 		ManifestorStatus_t GetFrameCount(unsigned long long *FrameCount);
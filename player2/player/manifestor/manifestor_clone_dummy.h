@@ -144,6 +144,13 @@ class Manifestor_CloneDummy_c : public Manifestor_c
 			return ManifestorNoError;
 		}
 
+		ManifestorStatus_t GetBufferFormats(unsigned int *Formats)
+		{
+			report(severity_info, "GetBufferFormats - Called\n");
+			*Formats = BUFFER_FORMAT_MASK_ALL;
+			return ManifestorNoError;
+		}
+
 		ManifestorStatus_t SynchronizeOutput(void)
 		{
 			report(severity_info, "SynchronizeOutput - Called\n");
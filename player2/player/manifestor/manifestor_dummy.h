@@ -129,6 +129,13 @@ class Manifestor_Dummy_c : public Manifestor_c
 			return ManifestorNoError;
 		}
 
+		ManifestorStatus_t GetBufferFormats(unsigned int *Formats)
+		{
+			report(severity_info, "Manifestor_Dummy_c::GetBufferFormats - Called\n");
+			*Formats = BUFFER_FORMAT_MASK_ALL;
+			return ManifestorNoError;
+		}
+
 //
 
 		ManifestorStatus_t GetNextQueuedManifestationTime(unsigned long long *Time)
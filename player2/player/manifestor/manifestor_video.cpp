@@ -893,6 +893,7 @@ ManifestorStatus_t Manifestor_Video_c::SetDisplayWindows(struct VideoDisplayPara
 	int DestWidth, DestHeight;
 	Rational_t PictureAspectRatio;
 	Rational_t WindowAspectRatio;
+	int DecimationPolicyValue;
 	//MANIFESTOR_DEBUG("\n");
 	// Before checking if the display parameters have changed, we copy over
 	// the content frame rate to avoid excess message generation.
@@ -1180,6 +1181,7 @@ ManifestorStatus_t Manifestor_Video_c::SetDisplayWindows(struct VideoDisplayPara
 	InputWindow.Width = SourceWidth;
 	InputWindow.Height = SourceHeight;
 	// Decide whether the display requires scaling/cropping or not
+	DecimationPolicyValue = Player->PolicyValue(Playback, Stream, PolicyDecimateDecoderOutput);
 	DecimateIfAvailable = false;
 #if 0
 	// Hm why is here not the decimate value used from havana_stream ?
@@ -1220,12 +1222,21 @@ ManifestorStatus_t Manifestor_Video_c::SetDisplayWindows(struct VideoDisplayPara
 		DecimateIfAvailable = true;
 	}
 #else
-	if ((Player->PolicyValue(Playback, Stream, PolicyDecimateDecoderOutput) != PolicyValueDecimateDecoderOutputDisabled) &&
+	if ((DecimationPolicyValue != PolicyValueDecimateDecoderOutputDisabled) &&
 			((SourceWidth > (DestWidth * MAX_SCALING_FACTOR)) || (SourceHeight > (DestHeight * MAX_SCALING_FACTOR))))
 	{
 		DecimateIfAvailable = true;
 	}
 #endif
+	// A window no bigger than the decimated picture (a pip of an hd
+	// stream) is displayed from the decimated surface, the display then
+	// fetches a half or a quarter of the data for each frame.
+	if ((DecimationPolicyValue != PolicyValueDecimateDecoderOutputDisabled) &&
+			(SourceWidth >= (DestWidth * (int)DECIMATION_FACTOR_H(DecimationPolicyValue))) &&
+			(SourceHeight >= (DestHeight * DECIMATION_FACTOR_V)))
+	{
+		DecimateIfAvailable = true;
+	}
 	CroppedWindow.X = SourceX * INPUT_WINDOW_SCALE_FACTOR;
 	CroppedWindow.Y = SourceY * INPUT_WINDOW_SCALE_FACTOR;
 	CroppedWindow.Width = SourceWidth;
@@ -1356,7 +1367,7 @@ ManifestorStatus_t Manifestor_Video_c::FillOutBufferStructure(BufferStructure_t
 	// Do a switch depending on the buffer type
 	//
 	unsigned int DecimationPolicyValue = Player->PolicyValue(Playback, Stream, PolicyDecimateDecoderOutput);
-	unsigned int DecimationValue = (DecimationPolicyValue == PolicyValueDecimateDecoderOutputHalf) ? 2 : 4;
+	unsigned int DecimationValue = DECIMATION_FACTOR_H(DecimationPolicyValue);
 	switch (RequestedStructure->Format)
 	{
 		case FormatVideo420_PairedMacroBlock:
@@ -1382,7 +1393,7 @@ ManifestorStatus_t Manifestor_Video_c::FillOutBufferStructure(BufferStructure_t
 			{
 				RequestedStructure->ComponentCount = 4;
 				RequestedStructure->Dimension[2] = RequestedStructure->Dimension[0] / DecimationValue;
-				RequestedStructure->Dimension[3] = RequestedStructure->Dimension[1] / DecimationValue;
+				RequestedStructure->Dimension[3] = RequestedStructure->Dimension[1] / DECIMATION_FACTOR_V;
 				RequestedStructure->Dimension[2] = ((RequestedStructure->Dimension[2] + 0x0f) & 0xfffffff0);
 				RequestedStructure->Dimension[3] = ((RequestedStructure->Dimension[3] + 0x1f) & 0xffffffe0);
 				RequestedStructure->Strides[0][2] = RequestedStructure->Dimension[2];
@@ -1414,7 +1425,7 @@ ManifestorStatus_t Manifestor_Video_c::FillOutBufferStructure(BufferStructure_t
 			if (RequestedStructure->DecimationRequired)
 			{
 				RequestedStructure->Dimension[2] = RequestedStructure->Dimension[0] / DecimationValue;
-				RequestedStructure->Dimension[3] = RequestedStructure->Dimension[1] / DecimationValue;
+				RequestedStructure->Dimension[3] = RequestedStructure->Dimension[1] / DECIMATION_FACTOR_V;
 				RequestedStructure->ComponentCount = 4;
 				RequestedStructure->ComponentOffset[2] = (2 * RequestedStructure->Dimension[0] * RequestedStructure->Dimension[1]);
 				RequestedStructure->Strides[0][2] = 2 * RequestedStructure->Dimension[2];
@@ -46,6 +46,10 @@ Date Modification Name
 #define INPUT_WINDOW_SCALE_FACTOR 16
 
 #define MAX_SCALING_FACTOR 2
+
+// The decoders decimate horizontally by 2 or 4 but always by 2 vertically
+#define DECIMATION_FACTOR_H(p) (((p) == PolicyValueDecimateDecoderOutputQuarter) ? 4 : 2)
+#define DECIMATION_FACTOR_V 2
 #define MAX_RESIZE_STEPS 128
 
 typedef enum
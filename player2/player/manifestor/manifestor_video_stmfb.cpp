@@ -193,10 +193,22 @@ Manifestor_VideoStmfb_c::Manifestor_VideoStmfb_c(void)
 	DisplayDevice = NULL;
 	Plane = NULL;
 	Output = NULL;
+	BufferFormats = BUFFER_FORMAT_MASK_ALL;
 	Visible = false;
 	ClockRateAdjustment = 0;
 	DisplayAddress = 0;
 	DisplaySize = 0;
+	DisplayEntriesQueued = 0;
+	DisplayEntriesDone = 0;
+	WaitingForQueueDepth = false;
+	DisplayQueueDrainedValid = false;
+	if (OS_InitializeEvent(&DisplayQueueDrained) != OS_NO_ERROR)
+	{
+		MANIFESTOR_ERROR("Failed to initialize DisplayQueueDrained event\n");
+		InitializationStatus = ManifestorError;
+		return;
+	}
+	DisplayQueueDrainedValid = true;
 #if defined (QUEUE_BUFFER_CAN_FAIL)
 	DisplayAvailableValid = false;
 	DisplayHeadroom = 0;
@@ -237,6 +249,14 @@ Manifestor_VideoStmfb_c::~Manifestor_VideoStmfb_c(void)
 		OS_SemaphoreTerminate(&DisplayAvailable);
 	}
 #endif
+	if (DisplayQueueDrainedValid)
+	{
+		DisplayQueueDrainedValid = false;
+		OS_SetEvent(&DisplayQueueDrained);
+		while (WaitingForQueueDepth)
+			OS_SleepMilliSeconds(2);
+		OS_TerminateEvent(&DisplayQueueDrained);
+	}
 	CloseOutputSurface();
 #ifdef __TDT__
 #ifdef UFS922
@@ -288,6 +308,7 @@ ManifestorStatus_t Manifestor_VideoStmfb_c::Reset(void)
 		DisplayBuffer[i].info.pDisplayCallback = NULL;
 		DisplayBuffer[i].info.pCompletedCallback = NULL;
 	}
+	memset(&QueueStatistics, 0, sizeof(QueueStatistics));
 	// Again Julian, a hack...
 	ManifestorLastDisplayedBuffer = NULL;
 	wake_up_interruptible(&g_ManifestorLastWaitQueue);
@@ -330,6 +351,59 @@ ManifestorStatus_t Manifestor_VideoStmfb_c::UpdateOutputSurfaceDescriptor(void)
 	return ManifestorNoError;
 }
 //}}}
+//{{{ SelectBufferFormats
+//{{{ doxynote
+/// \brief Find which decode buffer formats the plane can display directly,
+/// the inverse of the mapping in SelectDisplaySource
+/// \param Plane Handle of the display plane.
+/// \return Mask of BUFFER_FORMAT_MASK() bits
+//}}}
+static unsigned int SelectBufferFormats(stm_display_plane_t *Plane)
+{
+	const SURF_FMT *SurfaceFormats;
+	unsigned int Formats = 0;
+	int Count;
+	int i;
+	Count = stm_display_plane_get_image_formats(Plane, &SurfaceFormats);
+	if (Count < 0)
+		return BUFFER_FORMAT_MASK_ALL;
+	for (i = 0; i < Count; i++)
+	{
+		switch (SurfaceFormats[i])
+		{
+			case SURF_ARGB8888:
+				Formats |= BUFFER_FORMAT_MASK(FormatVideo8888_ARGB);
+				break;
+			case SURF_RGB888:
+				Formats |= BUFFER_FORMAT_MASK(FormatVideo888_RGB);
+				break;
+			case SURF_RGB565:
+				Formats |= BUFFER_FORMAT_MASK(FormatVideo565_RGB);
+				break;
+			case SURF_YCBCR420MB:
+				Formats |= BUFFER_FORMAT_MASK(FormatVideo420_MacroBlock) |
+					   BUFFER_FORMAT_MASK(FormatVideo420_PairedMacroBlock);
+				break;
+			case SURF_YCBCR422R:
+				Formats |= BUFFER_FORMAT_MASK(FormatVideo422_Raster);
+				break;
+			case SURF_YUV420:
+				Formats |= BUFFER_FORMAT_MASK(FormatVideo420_Planar);
+				break;
+			case SURF_YUV422P:
+				Formats |= BUFFER_FORMAT_MASK(FormatVideo422_Planar);
+				break;
+			case SURF_YUYV:
+				Formats |= BUFFER_FORMAT_MASK(FormatVideo422_YUYV);
+				break;
+			default:
+				break;
+		}
+	}
+	// Marker frames are never displayed
+	return Formats | BUFFER_FORMAT_MASK(FormatMarkerFrame);
+}
+//}}}
 //{{{ OpenOutputSurface
 //{{{ doxynote
 /// \brief Find out information about display plane and output and use it to
@@ -369,6 +443,8 @@ ManifestorStatus_t Manifestor_VideoStmfb_c::OpenOutputSurface(DeviceHandle_t Dev
 		return ManifestorError;
 	}
 	stm_display_plane_connect_to_output(Plane, Output);
+	BufferFormats = SelectBufferFormats(Plane);
+	MANIFESTOR_DEBUG("Plane buffer formats %08x\n", BufferFormats);
 //
 // Nicks replacement code to update the surface descriptor.
 //
@@ -757,6 +833,7 @@ ManifestorStatus_t Manifestor_VideoStmfb_c::CloseOutputSurface(void)
 	DisplayDevice = NULL;
 	Plane = NULL;
 	Output = NULL;
+	BufferFormats = BUFFER_FORMAT_MASK_ALL;
 	// Again Julian, a hack...
 	ManifestorLastDisplayedBuffer = NULL;
 	wake_up_interruptible(&g_ManifestorLastWaitQueue);
@@ -1165,6 +1242,11 @@ ManifestorStatus_t Manifestor_VideoStmfb_c::QueueBuffer(unsigned int BufferIndex
 		DisplayEventRequested = 0;
 	}
 	//}}}
+	if (Count > 0)
+	{
+		WaitForDisplayQueueDepth();
+		RecordQueueAheadMargin(DisplayBuff->info.presentationTime, FrameParameters->NativePlaybackTime);
+	}
 	for (i = 0, Status = 0; (i < Count) && (Status == 0); i++)
 	{
 		DisplayBuff->src.ulFlags = QueueRecord[i].Flags;
@@ -1227,6 +1309,8 @@ ManifestorStatus_t Manifestor_VideoStmfb_c::QueueBuffer(unsigned int BufferIndex
 			WaitingForHeadroom = false;
 #endif
 		}
+		if (Status == 0)
+			DisplayEntriesQueued++;
 		DisplayBuff->info.presentationTime = 0;
 	}
 	if (Status == 0)
@@ -1235,6 +1319,95 @@ ManifestorStatus_t Manifestor_VideoStmfb_c::QueueBuffer(unsigned int BufferIndex
 		return ManifestorError;
 }
 //}}}
+//{{{ WaitForDisplayQueueDepth
+//{{{ doxynote
+/// \brief Hold back the next frame while the display queue is at its target depth
+///
+/// The wait is bounded, if the display is not taking frames (paused) the frame
+/// is queued anyway once STMFB_DISPLAY_QUEUE_WAIT has passed.
+//}}}
+void Manifestor_VideoStmfb_c::WaitForDisplayQueueDepth(void)
+{
+	unsigned int TargetDepth = Player->PolicyValue(Playback, Stream, PolicyDisplayQueueTargetDepth);
+	if ((TargetDepth == 0) || !DisplayQueueDrainedValid)
+		return;
+	if ((DisplayEntriesQueued - DisplayEntriesDone) < TargetDepth)
+		return;
+	QueueStatistics.DepthWaits++;
+	WaitingForQueueDepth = true;
+	OS_ResetEvent(&DisplayQueueDrained);
+	while (DisplayQueueDrainedValid && ((DisplayEntriesQueued - DisplayEntriesDone) >= TargetDepth))
+	{
+		if (OS_WaitForEvent(&DisplayQueueDrained, STMFB_DISPLAY_QUEUE_WAIT) == OS_TIMED_OUT)
+			break;
+		OS_ResetEvent(&DisplayQueueDrained);
+	}
+	WaitingForQueueDepth = false;
+}
+//}}}
+//{{{ RecordQueueAheadMargin
+//{{{ doxynote
+/// \brief Account the time between queueing a frame and the vsync it is scheduled for
+/// \param PresentationTime System time the frame is to be displayed, 0 for as soon as possible
+/// \param NativePlaybackTime Stream time of the frame, for the event
+///
+/// A margin below PolicyDisplayQueueMarginThreshold raises EventDisplayQueueMarginLow.
+/// Every 1 << STMFB_DISPLAY_QUEUE_REPORT_SHIFT frames the smallest, mean and largest
+/// margin are reported to the monitor.
+//}}}
+void Manifestor_VideoStmfb_c::RecordQueueAheadMargin(unsigned long long PresentationTime,
+						     unsigned long long NativePlaybackTime)
+{
+	unsigned int Depth = DisplayEntriesQueued - DisplayEntriesDone;
+	unsigned int Mask = (1 << STMFB_DISPLAY_QUEUE_REPORT_SHIFT) - 1;
+	unsigned int Threshold;
+	long long Margin;
+	bool FirstOfReport;
+	if (PresentationTime == 0)
+		return;
+	Margin = (long long)(PresentationTime - OS_GetTimeInMicroSeconds());
+	FirstOfReport = ((QueueStatistics.Frames & Mask) == 0);
+	if (FirstOfReport || (Margin < QueueStatistics.MinMargin))
+		QueueStatistics.MinMargin = Margin;
+	if (FirstOfReport || (Margin > QueueStatistics.MaxMargin))
+		QueueStatistics.MaxMargin = Margin;
+	QueueStatistics.SumMargin += Margin;
+	QueueStatistics.Frames++;
+	if (Depth > QueueStatistics.MaxDepth)
+		QueueStatistics.MaxDepth = Depth;
+	Threshold = Player->PolicyValue(Playback, Stream, PolicyDisplayQueueMarginThreshold);
+	if ((Threshold != 0) && (Margin < (long long)Threshold))
+	{
+		PlayerEventRecord_t Event;
+		QueueStatistics.LowMarginFrames++;
+		Event.Code = EventDisplayQueueMarginLow;
+		Event.Playback = Playback;
+		Event.Stream = Stream;
+		Event.PlaybackTime = NativePlaybackTime;
+		Event.Value[0].LongLong = Margin;
+		Event.Value[1].UnsignedInt = Depth;
+		Player->SignalEvent(&Event);
+	}
+	if ((QueueStatistics.Frames & Mask) == 0)
+	{
+		unsigned int Parameters[MONITOR_PARAMETER_COUNT];
+		memset(Parameters, 0, sizeof(Parameters));
+		Parameters[0] = (unsigned int)QueueStatistics.MinMargin;
+		Parameters[1] = (unsigned int)(QueueStatistics.SumMargin >> STMFB_DISPLAY_QUEUE_REPORT_SHIFT);
+		Parameters[2] = (unsigned int)QueueStatistics.MaxMargin;
+		Parameters[3] = QueueStatistics.LowMarginFrames;
+		Parameters[4] = QueueStatistics.MaxDepth;
+		Parameters[5] = QueueStatistics.DepthWaits;
+		MonitorSignalEvent(MONITOR_EVENT_INFORMATION, Parameters, "Display queue ahead margin");
+		MANIFESTOR_DEBUG("Queue ahead margin min %lld mean %lld max %lld us, %d low, depth max %d, %d waits\n",
+				 QueueStatistics.MinMargin, QueueStatistics.SumMargin >> STMFB_DISPLAY_QUEUE_REPORT_SHIFT,
+				 QueueStatistics.MaxMargin, QueueStatistics.LowMarginFrames,
+				 QueueStatistics.MaxDepth, QueueStatistics.DepthWaits);
+		QueueStatistics.SumMargin = 0;
+		QueueStatistics.MaxDepth = 0;
+	}
+}
+//}}}
 //{{{ QueueInitialFrame
 //{{{ doxynote
 /// \brief Actually put first field of initial buffer on display
@@ -1338,6 +1511,8 @@ ManifestorStatus_t Manifestor_VideoStmfb_c::FlushDisplayQueue(void)
 	DisplayFlush = true;
 #endif
 	stm_display_plane_pause(Plane, 1);
+	if (WaitingForQueueDepth)
+		OS_SetEvent(&DisplayQueueDrained);
 	if (BufferOnDisplay == INVALID_BUFFER_ID)
 	{
 		OS_SemaphoreSignal(&InitialFrameDisplayed);
@@ -1476,6 +1651,22 @@ ManifestorStatus_t Manifestor_VideoStmfb_c::SynchronizeOutput(void)
 	return ManifestorNoError;
 }
 //}}}
+//{{{ GetBufferFormats
+// ///////////////////////////////////////////////////////////////////////////////////////
+//
+// GetBufferFormats:
+// Action : Report the decode buffer formats the plane displays without conversion
+// Input : void
+// Output : Mask of BUFFER_FORMAT_MASK() bits
+// Results :
+//
+
+ManifestorStatus_t Manifestor_VideoStmfb_c::GetBufferFormats(unsigned int *Formats)
+{
+	*Formats = BufferFormats;
+	return ManifestorNoError;
+}
+//}}}
 //{{{ Enable
 // ///////////////////////////////////////////////////////////////////////////////////////
 // Enable
@@ -1604,6 +1795,9 @@ static void initial_frame_display_callback(void *Buffer, stm_time64_t VsyncTime)
 //{{{ DoneCallback
 void Manifestor_VideoStmfb_c::DoneCallback(struct StreamBuffer_s *Buffer, stm_time64_t VsyncTime, unsigned int Status)
 {
+	DisplayEntriesDone++;
+	if (WaitingForQueueDepth)
+		OS_SetEvent(&DisplayQueueDrained);
 	//if ((Buffer->BufferState != BufferStateQueued) || (--(Buffer->QueueCount) != 0))
 	if ((Buffer->BufferState != BufferStateQueued) && (Buffer->BufferState != BufferStateMultiQueue))
 		return;
@@ -42,11 +42,25 @@ Date Modification Name
 #define MANIFESTOR_TAG "ManifestorVideoStmfb_c::"
 
 #define STMFB_BUFFER_HEADROOM 12 /* Number of buffers to wait after queue is full before we restart queuing buffers */
+#define STMFB_DISPLAY_QUEUE_WAIT 100 /* Longest wait, in ms, for the display queue to drain to its target depth */
+#define STMFB_DISPLAY_QUEUE_REPORT_SHIFT 9 /* Report the queue ahead margin to the monitor every 512 frames */
 
 #ifndef stm_time64_t
 #define stm_time64_t TIME64
 #endif
 
+/// How far ahead of their presentation frames reach the display queue, times in microseconds
+struct DisplayQueueStatistics_s
+{
+	unsigned int Frames; ///< Frames queued with a presentation time
+	unsigned int LowMarginFrames; ///< Frames queued with less margin than PolicyDisplayQueueMarginThreshold
+	unsigned int DepthWaits; ///< Frames held back until the queue drained to PolicyDisplayQueueTargetDepth
+	unsigned int MaxDepth; ///< Deepest display queue seen when queueing a frame
+	long long MinMargin; ///< Smallest, largest and summed margin since the last report
+	long long MaxMargin;
+	long long SumMargin;
+};
+
 /// Video manifestor based on the stgfb core driver API.
 class Manifestor_VideoStmfb_c : public Manifestor_Video_c
 {
@@ -54,6 +68,7 @@ class Manifestor_VideoStmfb_c : public Manifestor_Video_c
 		stm_display_device_t *DisplayDevice;
 		stm_display_plane_t *Plane;
 		stm_display_output_t *Output;
+		unsigned int BufferFormats; ///< Decode buffer formats the plane displays, see SelectBufferFormats
 
 		stm_plane_crop_t srcRect;
 		stm_plane_crop_t croppedRect;
@@ -76,6 +91,19 @@ class Manifestor_VideoStmfb_c : public Manifestor_Video_c
 
 		int ClockRateAdjustment;
 
+		/* Display queue depth, entries queued less entries completed. Each count
+		   is written on one side only, QueueBuffer and the done callback */
+		unsigned int DisplayEntriesQueued;
+		volatile unsigned int DisplayEntriesDone;
+		OS_Event_t DisplayQueueDrained;
+		bool DisplayQueueDrainedValid;
+		volatile bool WaitingForQueueDepth;
+		struct DisplayQueueStatistics_s QueueStatistics;
+
+		void WaitForDisplayQueueDepth(void);
+		void RecordQueueAheadMargin(unsigned long long PresentationTime,
+					    unsigned long long NativePlaybackTime);
+
 	public:
 
 		/* Constructor / Destructor */
@@ -115,6 +143,7 @@ class Manifestor_VideoStmfb_c : public Manifestor_Video_c
 		ManifestorStatus_t CheckInputDimensions(unsigned int Width, unsigned int Height);
 
 		ManifestorStatus_t SynchronizeOutput(void);
+		ManifestorStatus_t GetBufferFormats(unsigned int *Formats);
 
 		bool BufferAvailable(unsigned char *Address, unsigned int Size);
 
@@ -61,9 +61,18 @@ Date Modification Name
 
 #define INTEGRATION_COUNT_FOR_VSYNC_OFFSET 4
 
-#define CLOCK_RECOVERY_MINIMUM_POINTS 4
-#define CLOCK_RECOVERY_MINIMUM_INTEGRATION_TIME 2000000 // us
-#define CLOCK_RECOVERY_MAXIMUM_INTEGRATION_TIME 512000000 // us
+#define VSYNC_GRID_PERIOD_SHIFT 8 // Measured vsync period held in 1/256ths of a us
+#define VSYNC_GRID_INTERVALS 64 // Frame intervals integrated for each measurement of the vsync period
+#define VSYNC_GRID_MAXIMUM_COUNT 16 // A longer frame interval is taken as a discontinuity
+#define VSYNC_GRID_CADENCE_ERRORS 4 // Cadence errors in one measurement before the grid phase is re-taken
+#define VSYNC_GRID_MAXIMUM_SNAP 4000000 // us, times further from the grid reference are left alone
+
+#define CLOCK_RECOVERY_MINIMUM_POINTS 4 // Closed buckets in the minimum delay fit
+#define CLOCK_RECOVERY_MINIMUM_INTEGRATION_TIME 1000000 // us
+#define CLOCK_RECOVERY_INITIAL_BUCKET_DURATION 250000 // us
+#define CLOCK_RECOVERY_MAXIMUM_BUCKET_DURATION 4000000 // us, gives a sliding window of just over a minute
+#define CLOCK_RECOVERY_DISCONTINUITY_THRESHOLD 1000000 // us, far beyond any transport jitter we expect to see
+#define CLOCK_RECOVERY_CONVERGED_THRESHOLD 2 // ppm change between successive readouts
 
 // /////////////////////////////////////////////////////////////////////////
 //
@@ -173,6 +182,7 @@ OutputCoordinatorStatus_t OutputCoordinator_Base_c::Reset(void)
 	Speed = 1;
 	Direction = PlayForward;
 	MinimumStreamOffset = 0;
+	VsyncOffsetIntegrationCount = 2 * INTEGRATION_COUNT_FOR_VSYNC_OFFSET; // Nothing to monitor until a mapping is made
 	ClockRecoveryInitialized = false;
 //
 	return BaseComponentClass_c::Reset();
@@ -224,6 +234,7 @@ OutputCoordinatorStatus_t OutputCoordinator_Base_c::RegisterStream(
 	NewContext->LeastSquareFit.Reset();
 	NewContext->ManifestorLatency = INVALID_TIME;
 	NewContext->StreamOffset = (long long)INVALID_TIME;
+	NewContext->VsyncLastActualTime = INVALID_TIME;
 	OS_InitializeEvent(&NewContext->AbortPerformEntryIntoDecodeWindowWait);
 	//
 	// Obtain the appropriate portion of the class list for this stream
@@ -536,6 +547,7 @@ OutputCoordinatorStatus_t OutputCoordinator_Base_c::ResetTimeMapping(OutputCoord
 			ContextLoop = ContextLoop->Next)
 	{
 		ContextLoop->TimeMappingEstablished = false;
+		ContextLoop->VsyncLastActualTime = INVALID_TIME; // The grid survives, the interval does not
 		OS_SetEvent(&ContextLoop->AbortPerformEntryIntoDecodeWindowWait);
 	}
 	//
@@ -749,6 +761,7 @@ OutputCoordinatorStatus_t OutputCoordinator_Base_c::SynchronizeStreams(
 	long long StreamOffset;
 	PlayerEventRecord_t Event;
 	unsigned int MaxSynchronizeWaits;
+	bool FastStart;
 	//
 	// We do not perform the synchronization if we use an enforced external time mapping
 	//
@@ -824,7 +837,16 @@ OutputCoordinatorStatus_t OutputCoordinator_Base_c::SynchronizeStreams(
 		report(severity_error, "OutputCoordinator_Base_c::SynchronizeStreams - Startup delay calculated to be too large (%lldms) (%016llx - %016llx).\n", StartupDelay, NormalizedPlaybackTime, NormalizedDecodeTime);
 		StartupDelay = MAXIMUM_STARTUP_DELAY;
 	}
-	if (StartupDelay != 0)
+	//
+	// In a fast start the first video stream to arrive establishes the
+	// mapping without waiting for anyone else, and without the startup
+	// delay. Frames that then decode too late for the mapping are dropped
+	// by the output timer, rather than holding back the first picture.
+	//
+	FastStart = (Direction == PlayForward) &&
+		    (Context->StreamType == StreamTypeVideo) &&
+		    (Player->PolicyValue(Playback, Context->Stream, PolicySyncStartFast) == PolicyValueApply);
+	if (!FastStart && (StartupDelay != 0))
 		OS_SleepMilliSeconds((unsigned int)StartupDelay);
 	// Determine Policy for reducing Stream Start Time.
 	if (Player->PolicyValue(Playback, Context->Stream, PolicySyncStartImmediate))
@@ -892,7 +914,8 @@ OutputCoordinatorStatus_t OutputCoordinator_Base_c::SynchronizeStreams(
 		//
 		// Can we do the synchronization
 		//
-		if ((StreamsInSynchronize == StreamCount) ||
+		if (FastStart ||
+				(StreamsInSynchronize == StreamCount) ||
 				(WaitCount >= MaxSynchronizeWaits))
 		{
 			//
@@ -921,6 +944,11 @@ OutputCoordinatorStatus_t OutputCoordinator_Base_c::SynchronizeStreams(
 			if ((VideoStartImmediatePolicy == PolicyValueApply) &&
 					(EarliestVideoContext != NULL))
 				EarliestContext = EarliestVideoContext;
+			if (FastStart)
+			{
+				EarliestContext = Context;
+				EarliestVideoContext = Context;
+			}
 			//
 			// Find the earliest start time
 			//
@@ -941,6 +969,12 @@ OutputCoordinatorStatus_t OutputCoordinator_Base_c::SynchronizeStreams(
 			//
 			MasterBaseNormalizedPlaybackTime = EarliestContext->SynchronizingAtPlaybackTime;
 			MasterBaseSystemTime = EarliestStartTime + StartTimeJitter;
+			if (FastStart)
+			{
+				VsyncOffsetIntegrationCount = 0; // Refine the fast mapping against the vsync
+				MinimumVsyncOffset = 0x7fffffffffffffffll;
+				report(severity_info, "OutputCoordinator_Base_c::SynchronizeStreams - Fast start, %d of %d streams synchronizing.\n", StreamsInSynchronize, StreamCount);
+			}
 			AccumulatedPlaybackTimeJumpsSinceSynchronization = 0;
 			JumpSeenAtPlaybackTime = INVALID_TIME;
 			MasterTimeMappingEstablished = true;
@@ -1535,6 +1569,15 @@ OutputCoordinatorStatus_t OutputCoordinator_Base_c::MonitorVsyncOffset(
 	long long int CorrectedOffset;
 	long long VideoFrameDuration;
 	unsigned char VsyncLocked;
+	unsigned char ExternalMapping;
+	unsigned char SyncStartFast;
+//
+	TrackVsyncGrid(Context, RequestedOutputTime, ActualOutputTime);
+//
+	ExternalMapping = Player->PolicyValue(Playback, Context->Stream, PolicyExternalTimeMapping);
+	SyncStartFast = Player->PolicyValue(Playback, Context->Stream, PolicySyncStartFast);
+	if ((ExternalMapping != PolicyValueApply) && (SyncStartFast != PolicyValueApply))
+		return OutputCoordinatorNoError;
 //
 	if (VsyncOffsetIntegrationCount >= (2 * INTEGRATION_COUNT_FOR_VSYNC_OFFSET))
 		return OutputCoordinatorNoError;
@@ -1590,6 +1633,134 @@ OutputCoordinatorStatus_t OutputCoordinator_Base_c::MonitorVsyncOffset(
 	return OutputCoordinatorMappingNotEstablished;
 }
 
+// /////////////////////////////////////////////////////////////////////////
+//
+// This function moves an output time onto the measured vsync grid,
+// the display then has no choice of vsync to make for the frame.
+//
+
+OutputCoordinatorStatus_t OutputCoordinator_Base_c::SnapToVsyncGrid(
+	OutputCoordinatorContext_t Context,
+	unsigned long long *SystemTime)
+{
+	long long Offset;
+	unsigned long long Distance;
+	unsigned long long Periods;
+//
+	if (!Context->VsyncGridEstablished || !ValidTime(*SystemTime))
+		return OutputCoordinatorNoError;
+	Offset = (long long)(*SystemTime - Context->VsyncGridReference);
+	Distance = (Offset < 0) ? -Offset : Offset;
+	if (Distance > VSYNC_GRID_MAXIMUM_SNAP)
+		return OutputCoordinatorNoError;
+	Periods = ((Distance << VSYNC_GRID_PERIOD_SHIFT) + (Context->VsyncGridPeriod / 2)) / Context->VsyncGridPeriod;
+	Distance = ((Periods * Context->VsyncGridPeriod) + (1 << (VSYNC_GRID_PERIOD_SHIFT - 1))) >> VSYNC_GRID_PERIOD_SHIFT;
+	*SystemTime = (Offset < 0) ? (Context->VsyncGridReference - Distance) : (Context->VsyncGridReference + Distance);
+	return OutputCoordinatorNoError;
+}
+
+// /////////////////////////////////////////////////////////////////////////
+//
+// Private - This function measures the vsync grid from the times frames
+// were actually displayed. Every interval between frames is a whole
+// number of vsyncs, integrating them gives the vsync period, and a frame
+// that started on the vsync it was planned for gives the phase.
+//
+// A frame held for a different number of vsyncs than planned is a
+// cadence error (a 24p frame held for 3 fields where 2 were planned).
+// Isolated errors are interrupt latency and are ignored, repeated errors
+// mean the grid phase has slipped, the phase is then re-taken from the
+// latest frame so that the correction costs a single repeated field.
+//
+
+void OutputCoordinator_Base_c::TrackVsyncGrid(
+	OutputCoordinatorContext_t Context,
+	unsigned long long RequestedOutputTime,
+	unsigned long long ActualOutputTime)
+{
+	unsigned long long NominalPeriod;
+	unsigned long long Interval;
+	long long Error;
+	unsigned int Count;
+	unsigned int PlannedCount;
+//
+	if ((Context->VideoSurfaceDescriptor == NULL) || (Context->VideoSurfaceDescriptor->FrameRate == 0))
+		return;
+	//
+	// A change of display mode invalidates the grid
+	//
+	NominalPeriod = RoundedLongLongIntegerPart(1000000 / Context->VideoSurfaceDescriptor->FrameRate);
+	if (NominalPeriod != Context->VsyncNominalPeriod)
+	{
+		Context->VsyncNominalPeriod = NominalPeriod;
+		Context->VsyncGridEstablished = false;
+		Context->VsyncLastActualTime = INVALID_TIME;
+	}
+	if (!ValidTime(Context->VsyncLastActualTime))
+	{
+		Context->VsyncIntervalSum = 0;
+		Context->VsyncCountSum = 0;
+		Context->VsyncIntervals = 0;
+		Context->VsyncCadenceErrors = 0;
+		Context->VsyncLastRequestedTime = RequestedOutputTime;
+		Context->VsyncLastActualTime = ActualOutputTime;
+		return;
+	}
+	//
+	// Count the vsyncs the previous frame was shown for
+	//
+	Interval = ActualOutputTime - Context->VsyncLastActualTime;
+	Context->VsyncLastActualTime = ActualOutputTime;
+	if (Interval > (VSYNC_GRID_MAXIMUM_COUNT * NominalPeriod))
+	{
+		Context->VsyncLastActualTime = INVALID_TIME;
+		return;
+	}
+	Count = (unsigned int)((Interval + (NominalPeriod / 2)) / NominalPeriod);
+	Error = (long long)Interval - (long long)(Count * NominalPeriod);
+	PlannedCount = (unsigned int)(((RequestedOutputTime - Context->VsyncLastRequestedTime) + (NominalPeriod / 2)) / NominalPeriod);
+	Context->VsyncLastRequestedTime = RequestedOutputTime;
+	if ((Count == 0) || !inrange(Error, -(long long)(NominalPeriod / 4), (long long)(NominalPeriod / 4)))
+	{
+		Context->VsyncLastActualTime = INVALID_TIME;
+		return;
+	}
+	//
+	// Integrate the period
+	//
+	Context->VsyncIntervalSum += Interval;
+	Context->VsyncCountSum += Count;
+	Context->VsyncIntervals++;
+	if (Context->VsyncIntervals >= VSYNC_GRID_INTERVALS)
+	{
+		if (!Context->VsyncGridEstablished)
+			Context->VsyncGridReference = ActualOutputTime;
+		Context->VsyncGridPeriod = (Context->VsyncIntervalSum << VSYNC_GRID_PERIOD_SHIFT) / Context->VsyncCountSum;
+		Context->VsyncGridEstablished = true;
+		Context->VsyncIntervalSum = 0;
+		Context->VsyncCountSum = 0;
+		Context->VsyncIntervals = 0;
+		Context->VsyncCadenceErrors = 0;
+	}
+	if (!Context->VsyncGridEstablished)
+		return;
+	//
+	// Check the cadence, following the phase while it holds
+	//
+	if (Count == PlannedCount)
+	{
+		Context->VsyncGridReference = ActualOutputTime;
+		return;
+	}
+	Context->VsyncCadenceErrors++;
+	if (Context->VsyncCadenceErrors >= VSYNC_GRID_CADENCE_ERRORS)
+	{
+		report(severity_info, "OutputCoordinator_Base_c::TrackVsyncGrid - Cadence lost (%d vsyncs for %d), phase re-taken.\n", Count, PlannedCount);
+		Context->VsyncGridReference = ActualOutputTime;
+		Context->VsyncCadenceErrors = 0;
+	}
+}
+
 // /////////////////////////////////////////////////////////////////////////
 //
 // Private - This function trawls the contexts and deduces the next
@@ -1670,7 +1841,10 @@ OutputCoordinatorStatus_t OutputCoordinator_Base_c::ClockRecoveryInitialize(Play
 	ClockRecoveryEstablishedBaseSource = INVALID_TIME;
 	ClockRecoveryEstablishedBaseLocal = INVALID_TIME;
 	ClockRecoveryInitialized = true;
-	ClockRecoveryIntegrationTime = CLOCK_RECOVERY_MINIMUM_INTEGRATION_TIME;
+	ClockRecoveryFirstPointTime = INVALID_TIME;
+	ClockRecoveryConvergenceTime = INVALID_TIME;
+	ClockRecoveryLastFitGradient = 0;
+	ClockRecoveryDiscontinuities = 0;
 	//
 	// We only reset the system clock here if the system clock is master
 	//
@@ -1700,6 +1874,8 @@ OutputCoordinatorStatus_t OutputCoordinator_Base_c::ClockRecoveryDataPoint(
 {
 	unsigned long long NormalizedSourceTime;
 	unsigned char MasterClock;
+	Rational_t Gradient;
+	Rational_t Change;
 	//
 	// Have we been initialized
 	//
@@ -1737,14 +1913,28 @@ OutputCoordinatorStatus_t OutputCoordinator_Base_c::ClockRecoveryDataPoint(
 			return PlayerNotSupported;
 	}
 	//
+	// A jump in the source clock invalidates the window, though not the established rate
+	//
+	if ((ClockRecoveryBaseSourceClock != INVALID_TIME) &&
+			ClockRecoveryFit.Discontinuity(NormalizedSourceTime - ClockRecoveryBaseSourceClock,
+						       LocalTime - ClockRecoveryBaseLocalClock,
+						       CLOCK_RECOVERY_DISCONTINUITY_THRESHOLD))
+	{
+		report(severity_info, "OutputCoordinator_Base_c::ClockRecoveryDataPoint - Source clock discontinuity, restarting fit.\n");
+		ClockRecoveryBaseSourceClock = INVALID_TIME;
+		ClockRecoveryBaseLocalClock = INVALID_TIME;
+		ClockRecoveryDiscontinuities++;
+	}
+	//
 	// Initialize the accumulated data if this is our first point
 	//
 	if (ClockRecoveryBaseSourceClock == INVALID_TIME)
 	{
 		ClockRecoveryBaseSourceClock = NormalizedSourceTime;
 		ClockRecoveryBaseLocalClock = LocalTime;
-		ClockRecoveryAccumulatedPoints = 0;
-		ClockRecoveryLeastSquareFit.Reset();
+		ClockRecoveryFit.Reset(CLOCK_RECOVERY_INITIAL_BUCKET_DURATION, CLOCK_RECOVERY_MAXIMUM_BUCKET_DURATION);
+		if (ClockRecoveryFirstPointTime == INVALID_TIME)
+			ClockRecoveryFirstPointTime = LocalTime;
 		if (ClockRecoveryEstablishedBaseSource == INVALID_TIME)
 		{
 			// If this is our first ever point, establish the minimum needed for guesstimating the source clock
@@ -1752,44 +1942,50 @@ OutputCoordinatorStatus_t OutputCoordinator_Base_c::ClockRecoveryDataPoint(
 			ClockRecoveryEstablishedBaseSource = ClockRecoveryBaseSourceClock;
 			ClockRecoveryEstablishedBaseLocal = ClockRecoveryBaseLocalClock;
 		}
+		else
+		{
+			// Keep the established rate, but anchor the estimate on the new source timeline
+			ClockRecoveryEstablishedBaseSource = ClockRecoveryBaseSourceClock;
+			ClockRecoveryEstablishedBaseLocal = ClockRecoveryBaseLocalClock;
+		}
 	}
 	//
-	// Accumulate the data point (converting the times to deltas first)
+	// Accumulate the data point, the fit keeps only the least delayed point in each
+	// bucket, and tells us when a bucket closes, which is when we read out a new fit.
 	//
-	NormalizedSourceTime -= ClockRecoveryBaseSourceClock + ClockRecoveryLeastSquareFit.Y();
-	LocalTime -= ClockRecoveryBaseLocalClock + ClockRecoveryLeastSquareFit.X();
-	ClockRecoveryLeastSquareFit.Add(NormalizedSourceTime, LocalTime);
-	ClockRecoveryAccumulatedPoints++;
+	if (!ClockRecoveryFit.Add(NormalizedSourceTime - ClockRecoveryBaseSourceClock, LocalTime - ClockRecoveryBaseLocalClock))
+		return OutputCoordinatorNoError;
+	if ((ClockRecoveryFit.Buckets() < CLOCK_RECOVERY_MINIMUM_POINTS) ||
+			(ClockRecoveryFit.Span() < CLOCK_RECOVERY_MINIMUM_INTEGRATION_TIME) ||
+			!ClockRecoveryFit.Fit(&Gradient))
+		return OutputCoordinatorNoError;
 	//
-	// Is it time for a readout, we judge this on elapsed time and on a minimum number of points
+	// Note when the rate stops moving, this is our convergence time
 	//
-	if ((ClockRecoveryAccumulatedPoints >= CLOCK_RECOVERY_MINIMUM_POINTS) &&
-			((unsigned long long)ClockRecoveryLeastSquareFit.X() >= ClockRecoveryIntegrationTime))
+	Change = (Gradient - ClockRecoveryLastFitGradient) * 1000000;
+	ClockRecoveryLastFitGradient = Gradient;
+	if ((ClockRecoveryConvergenceTime == INVALID_TIME) &&
+			(Change < CLOCK_RECOVERY_CONVERGED_THRESHOLD) && (Change > -CLOCK_RECOVERY_CONVERGED_THRESHOLD))
 	{
-		ClockRecoveryEstablishedGradient = ClockRecoveryLeastSquareFit.Gradient();
-		ClockRecoveryEstablishedBaseSource = ClockRecoveryBaseSourceClock + RoundedLongLongIntegerPart(ClockRecoveryLeastSquareFit.Intercept());
-		ClockRecoveryEstablishedBaseLocal = ClockRecoveryBaseLocalClock;
-		//
-		// Set us up for a reset
-		//
-		ClockRecoveryLastPts = INVALID_TIME; // Only used if PTS source time format
-		ClockRecoveryPtsBaseLine = 0;
-		ClockRecoveryBaseSourceClock = INVALID_TIME;
-		ClockRecoveryBaseLocalClock = INVALID_TIME;
-		//
-		// Adjust the integration time
-		//
-		if (ClockRecoveryIntegrationTime < CLOCK_RECOVERY_MAXIMUM_INTEGRATION_TIME)
-			ClockRecoveryIntegrationTime *= 2;
-		//
-		// Do we need to adjust the system clock rate
-		//
-		MasterClock = Player->PolicyValue(Playback, PlayerAllStreams, PolicyMasterClock);
-		if (MasterClock == PolicyValueSystemClockMaster)
-		{
-			SystemClockAdjustmentEstablished = true;
-			SystemClockAdjustment = ClockRecoveryEstablishedGradient;
-		}
+		ClockRecoveryConvergenceTime = LocalTime - ClockRecoveryFirstPointTime;
+		report(severity_info, "OutputCoordinator_Base_c::ClockRecoveryDataPoint - Converged in %lldus (%d points accepted, %d rejected, %d discontinuities).\n",
+		       ClockRecoveryConvergenceTime, ClockRecoveryFit.AcceptedPoints(), ClockRecoveryFit.RejectedPoints(), ClockRecoveryDiscontinuities);
+	}
+	//
+	// Anchor the estimate at this point on the fitted line, keeping the
+	// elapsed time used by ClockRecoveryEstimate() small.
+	//
+	ClockRecoveryEstablishedGradient = Gradient;
+	ClockRecoveryEstablishedBaseSource = ClockRecoveryBaseSourceClock + ClockRecoveryFit.Evaluate(LocalTime - ClockRecoveryBaseLocalClock);
+	ClockRecoveryEstablishedBaseLocal = LocalTime;
+	//
+	// Do we need to adjust the system clock rate
+	//
+	MasterClock = Player->PolicyValue(Playback, PlayerAllStreams, PolicyMasterClock);
+	if (MasterClock == PolicyValueSystemClockMaster)
+	{
+		SystemClockAdjustmentEstablished = true;
+		SystemClockAdjustment = ClockRecoveryEstablishedGradient;
 	}
 //
 	return OutputCoordinatorNoError;
@@ -1866,6 +2062,30 @@ OutputCoordinatorStatus_t OutputCoordinator_Base_c::ClockRecoveryEstimate(
 	return OutputCoordinatorNoError;
 }
 
+// /////////////////////////////////////////////////////////////////////////
+//
+// The function to read out the clock recovery statistics
+//
+
+OutputCoordinatorStatus_t OutputCoordinator_Base_c::ClockRecoveryStatistics(
+	unsigned long long *ConvergenceTime,
+	unsigned int *AcceptedPoints,
+	unsigned int *RejectedPoints,
+	unsigned int *Discontinuities)
+{
+	if (!ClockRecoveryInitialized)
+		return OutputCoordinatorError;
+	if (ConvergenceTime != NULL)
+		*ConvergenceTime = ClockRecoveryConvergenceTime;
+	if (AcceptedPoints != NULL)
+		*AcceptedPoints = ClockRecoveryFit.AcceptedPoints();
+	if (RejectedPoints != NULL)
+		*RejectedPoints = ClockRecoveryFit.RejectedPoints();
+	if (Discontinuities != NULL)
+		*Discontinuities = ClockRecoveryDiscontinuities;
+	return OutputCoordinatorNoError;
+}
+
 // /////////////////////////////////////////////////////////////////////////
 //
 // Time functions, coded here since direction
@@ -35,6 +35,7 @@ Date Modification Name
 
 #include "player.h"
 #include "least_squares.h"
+#include "minimum_delay_fit.h"
 
 // ---------------------------------------------------------------------
 //
@@ -105,6 +106,17 @@ struct OutputCoordinatorContext_s
 	long long StreamOffset;
 
 	long long CurrentErrorHistory[4];
+
+	bool VsyncGridEstablished;
+	unsigned long long VsyncGridReference; // A vsync on which a frame started as planned
+	unsigned long long VsyncGridPeriod; // Measured vsync period, in units of 1/(1 << VSYNC_GRID_PERIOD_SHIFT) us
+	unsigned long long VsyncNominalPeriod;
+	unsigned long long VsyncLastRequestedTime;
+	unsigned long long VsyncLastActualTime;
+	unsigned long long VsyncIntervalSum;
+	unsigned int VsyncCountSum;
+	unsigned int VsyncIntervals;
+	unsigned int VsyncCadenceErrors;
 };
 
 // ---------------------------------------------------------------------
@@ -158,9 +170,12 @@ class OutputCoordinator_Base_c : public OutputCoordinator_c
 		unsigned long long ClockRecoveryPtsBaseLine;
 		unsigned long long ClockRecoveryBaseSourceClock;
 		unsigned long long ClockRecoveryBaseLocalClock;
-		unsigned int ClockRecoveryAccumulatedPoints;
-		unsigned long long ClockRecoveryIntegrationTime;
-		LeastSquares_t ClockRecoveryLeastSquareFit;
+		MinimumDelayFit_t ClockRecoveryFit;
+		Rational_t ClockRecoveryLastFitGradient;
+
+		unsigned long long ClockRecoveryFirstPointTime;
+		unsigned long long ClockRecoveryConvergenceTime;
+		unsigned int ClockRecoveryDiscontinuities;
 
 		Rational_t ClockRecoveryEstablishedGradient;
 		unsigned long long ClockRecoveryEstablishedBaseSource;
@@ -169,6 +184,9 @@ class OutputCoordinator_Base_c : public OutputCoordinator_c
 		// Functions
 
 		unsigned long long RestartTime(void);
+		void TrackVsyncGrid(OutputCoordinatorContext_t Context,
+				    unsigned long long RequestedOutputTime,
+				    unsigned long long ActualOutputTime);
 		unsigned long long SpeedScale(unsigned long long T);
 		unsigned long long InverseSpeedScale(unsigned long long T);
 
@@ -257,6 +275,9 @@ class OutputCoordinator_Base_c : public OutputCoordinator_c
 							     unsigned long long RequestedOutputTime,
 							     unsigned long long ActualOutputTime);
 
+		OutputCoordinatorStatus_t SnapToVsyncGrid(OutputCoordinatorContext_t Context,
+							  unsigned long long *SystemTime);
+
 		OutputCoordinatorStatus_t ClockRecoveryInitialize(PlayerTimeFormat_t SourceTimeFormat);
 
 		OutputCoordinatorStatus_t ClockRecoveryDataPoint(unsigned long long SourceTime,
@@ -265,6 +286,11 @@ class OutputCoordinator_Base_c : public OutputCoordinator_c
 		OutputCoordinatorStatus_t ClockRecoveryEstimate(unsigned long long *SourceTime,
 								unsigned long long *LocalTime);
 
+		OutputCoordinatorStatus_t ClockRecoveryStatistics(unsigned long long *ConvergenceTime,
+								  unsigned int *AcceptedPoints,
+								  unsigned int *RejectedPoints,
+								  unsigned int *Discontinuities);
+
 };
 #endif
 
@@ -53,6 +53,10 @@ Date Modification Name
 #define REBASE_MARGIN 50000 // A 50ms margin when we attempt to recover 
 // from decode in time failures by rebasing
 
+#define DECODE_WINDOW_BATCH_FRAMES 4 // Frames released per wakeup of the parse to decode thread
+
+#define DECODE_COST_BUDGET_PERCENT 90 // Portion of real time we plan to spend decoding in a trick mode
+
 // /////////////////////////////////////////////////////////////////////////
 //
 // Locally defined structures
@@ -129,6 +133,7 @@ OutputTimerStatus_t OutputTimer_Base_c::Reset(void)
 	TimeMappingValidForDecodeTiming = false;
 	TimeMappingInvalidatedAtDecodeIndex = INVALID_INDEX;
 	LastSeenDecodeTime = INVALID_TIME;
+	DecodeWindowBatchEnd = INVALID_TIME;
 	LastKeyFramePlaybackTime = INVALID_TIME;
 	NextExpectedPlaybackTime = INVALID_TIME;
 	NormalizedTimeOffset = 0;
@@ -144,6 +149,7 @@ OutputTimerStatus_t OutputTimer_Base_c::Reset(void)
 	AdjustedSpeedAfterFrameDrop = 1;
 	PortionOfPreDecodeFramesToLose = 0;
 	AccumulatedPreDecodeFramesToLose = 0;
+	TrickModeCostModelValid = false;
 	TrickModeCheckReferenceFrames = 0;
 	LastTrickModePolicy = PolicyValueTrickModeAuto;
 	LastTrickModeDomain = TrickModeInvalid;
@@ -306,6 +312,7 @@ OutputTimerStatus_t OutputTimer_Base_c::ResetTimeMapping(void)
 	TimeMappingValidForDecodeTiming = false;
 	TimeMappingInvalidatedAtDecodeIndex = INVALID_INDEX;
 	LastSeenDecodeTime = INVALID_TIME;
+	DecodeWindowBatchEnd = INVALID_TIME;
 	NextExpectedPlaybackTime = INVALID_TIME;
 	LastExpectedFrameTime = INVALID_TIME;
 	LastActualFrameTime = INVALID_TIME;
@@ -386,6 +393,7 @@ OutputTimerStatus_t OutputTimer_Base_c::AwaitEntryIntoDecodeWindow(Buffer_t Buff
 		{
 			TimeMappingValidForDecodeTiming = false;
 			TimeMappingInvalidatedAtDecodeIndex = ParsedFrameParameters->DecodeFrameIndex;
+			DecodeWindowBatchEnd = INVALID_TIME;
 			report(severity_info, "OutputTimer_Base_c::AwaitEntryIntoDecodeWindow(%s) - Jump in decode times detected %12lld\n", Configuration.OutputTimerName, DeltaDecodeTime);
 		}
 	}
@@ -397,15 +405,63 @@ OutputTimerStatus_t OutputTimer_Base_c::AwaitEntryIntoDecodeWindow(Buffer_t Buff
 	if ((!TimeMappingValidForDecodeTiming && !TrickModeDiscarding) || !ValidTime(ParsedFrameParameters->NormalizedDecodeTime))
 		return OutputTimerNoError;
 	//
-	// Perform the wait
+	// Frames are released in batches, when we wake for one frame the windows
+	// of the frames that follow it are predicted from the frame decode time,
+	// and all those that open within the batch are released without a further
+	// wait. This keeps the wakeups of the parse to decode thread down to one
+	// per batch, while allowing the decoder to run ahead by at most a batch.
 	//
 	NormalizedDecodeTime = ParsedFrameParameters->NormalizedDecodeTime + (unsigned long long)NormalizedTimeOffset;
+	if (ValidTime(DecodeWindowBatchEnd) &&
+			(NormalizedDecodeTime >= DecodeWindowBatchStart) &&
+			(NormalizedDecodeTime < DecodeWindowBatchEnd))
+		return OutputTimerNoError;
+	//
+	// If the decoder is being starved (typically when catching up after a glitch),
+	// then we open the window a whole batch early to refill the pipeline.
+	//
 	DecodeWindowPorch = Configuration.FrameDecodeTime + Configuration.EarlyDecodePorch;
+	if (DecoderStarved())
+		DecodeWindowPorch += DECODE_WINDOW_BATCH_FRAMES * Configuration.FrameDecodeTime;
+	//
+	// Perform the wait
+	//
 	MaximumSleepTime = (unsigned long long)Configuration.MaximumDecodeTimesToWait * Configuration.FrameDecodeTime;
 	Status = OutputCoordinator->PerformEntryIntoDecodeWindowWait(OutputCoordinatorContext, NormalizedDecodeTime, DecodeWindowPorch, MaximumSleepTime);
+	//
+	// An abandoned wait means the mapping has moved, so no batch can be predicted
+	//
+	if ((Status == OutputCoordinatorNoError) && (Configuration.FrameDecodeTime != 0))
+	{
+		DecodeWindowBatchStart = NormalizedDecodeTime;
+		DecodeWindowBatchEnd = NormalizedDecodeTime + (DECODE_WINDOW_BATCH_FRAMES * Configuration.FrameDecodeTime);
+	}
+	else
+		DecodeWindowBatchEnd = INVALID_TIME;
 	return Status;
 }
 
+// /////////////////////////////////////////////////////////////////////////
+//
+// Private - Function to check whether the decoder is being starved, IE we
+// are catching up after failing to decode in time, and there are enough
+// free decode buffers to decode a whole batch ahead of its window.
+//
+
+bool OutputTimer_Base_c::DecoderStarved(void)
+{
+	unsigned int DecodeBufferCount;
+	unsigned int DecodeBuffersInUse;
+//
+	if (DecodeInTimeState == DecodingInTime)
+		return false;
+	DecodeBufferPool->GetPoolUsage(NULL,
+				       &DecodeBuffersInUse,
+				       NULL, NULL, NULL);
+	Manifestor->GetDecodeBufferCount(&DecodeBufferCount);
+	return ((DecodeBuffersInUse + DECODE_WINDOW_BATCH_FRAMES) < DecodeBufferCount);
+}
+
 // /////////////////////////////////////////////////////////////////////////
 //
 // The function to test for frame drop before or after decode
@@ -724,6 +780,7 @@ OutputTimerStatus_t OutputTimer_Base_c::DropTestBeforeManifestation(Buffer_t Buf
 	VideoOutputTiming_t *OutputTiming;
 	unsigned char DropLateFramesPolicy;
 	unsigned char VideoImmediatePolicy;
+	unsigned char SyncStartFastPolicy;
 	Rational_t Speed;
 	PlayDirection_t Direction;
 	unsigned long long Now;
@@ -783,8 +840,9 @@ OutputTimerStatus_t OutputTimer_Base_c::DropTestBeforeManifestation(Buffer_t Buf
 					// we need to ensure that we do not mistakenly think
 					// that we are failing to decode in time
 					VideoImmediatePolicy = Player->PolicyValue(Playback, Stream, PolicyVideoStartImmediate);
+					SyncStartFastPolicy = Player->PolicyValue(Playback, Stream, PolicySyncStartFast);
 					if ((Configuration.StreamType == StreamTypeAudio) &&
-							(VideoImmediatePolicy == PolicyValueApply))
+							((VideoImmediatePolicy == PolicyValueApply) || (SyncStartFastPolicy == PolicyValueApply)))
 					{
 						SynchronizationState = SyncStateStartAwaitingCorrectionWorkthrough;
 						DecodeInTimeState = DecodingInTime;
@@ -1010,7 +1068,6 @@ OutputTimerStatus_t OutputTimer_Base_c::RecordActualFrameTiming(
 	unsigned long long ActualTime;
 	unsigned long long PreviousExpectedDuration;
 	unsigned long long PreviousActualDuration;
-	unsigned char ExternalMappingPolicy;
 //
 	AssertComponentState("OutputTimer_Base_c::RecordActualFrameTiming", ComponentRunning);
 	//
@@ -1067,11 +1124,9 @@ OutputTimerStatus_t OutputTimer_Base_c::RecordActualFrameTiming(
 		return Status;
 	}
 	//
-	// Perform any required monitoring of vsync offsets
+	// Monitor the vsync grid, and any required vsync offsets
 	//
-	ExternalMappingPolicy = Player->PolicyValue(Playback, Stream, PolicyExternalTimeMapping);
-	if ((Configuration.StreamType == StreamTypeVideo) &&
-			(ExternalMappingPolicy == PolicyValueApply))
+	if (Configuration.StreamType == StreamTypeVideo)
 	{
 		Status = OutputCoordinator->MonitorVsyncOffset(OutputCoordinatorContext, ExpectedTime, ActualTime);
 		if (Status == OutputCoordinatorMappingNotEstablished)
@@ -1331,6 +1386,94 @@ void OutputTimer_Base_c::SetTrickModeDomainBoundaries(void)
 #endif
 }
 
+// /////////////////////////////////////////////////////////////////////////
+//
+// Choose the trick mode domain from the decode cost of each class of
+// frame as measured by the codec. The decode budget is shared out in
+// order of dependency, independent frames first, then the remaining
+// reference frames, and finally the non reference frames, of which we
+// drop just enough to fit (substandard decoding them if we can). Since
+// nothing depends on a non reference frame, this is the minimal loss for
+// the speed. Returns false if the costs are not yet known, in which case
+// the caller falls back on the empirical frame rate boundaries.
+//
+
+bool OutputTimer_Base_c::SelectTrickModeDomainByCost(Rational_t Speed,
+						     TrickModeDomain_t *Domain,
+						     Rational_t *PortionOfNonReferenceFramesToLose)
+{
+	unsigned long long Cost[DecodeCostClasses];
+	unsigned char PolicyValue;
+	long long FrameRate; // Coded frames per second at this speed, times 1000
+	long long IndependentFraction; // Portions of the group structure, times 1000
+	long long ReferenceFraction;
+	long long NonReferenceFraction;
+	long long Budget; // us of decode per second
+	long long IndependentLoad; // us of decode per second for each class
+	long long ReferenceLoad;
+	long long NonReferenceLoad;
+//
+	memcpy(Cost, TrickModeParameters.AverageDecodeTime, sizeof(Cost));
+	if ((Cost[DecodeCostIndependentFrame] == 0) ||
+			(Cost[DecodeCostReferenceFrame] == 0) ||
+			((Cost[DecodeCostNonReferenceFrame] == 0) && (Cost[DecodeCostNonReferenceFrameSubstandard] == 0)))
+		return false;
+	//
+	// At normal speed we only discard if we are allowed to
+	//
+	PolicyValue = Player->PolicyValue(Playback, Stream, PolicyAllowFrameDiscardAtNormalSpeed);
+	if ((Speed <= 1) && (PolicyValue != PolicyValueApply))
+		return false;
+	//
+	// Where one variant of non reference decode has not been seen, estimate it from the other
+	//
+	if (Cost[DecodeCostNonReferenceFrame] == 0)
+		Cost[DecodeCostNonReferenceFrame] = RoundedLongLongIntegerPart(TrickModeParameters.SubstandardDecodeRateIncrease * (int)Cost[DecodeCostNonReferenceFrameSubstandard]);
+	if (Cost[DecodeCostNonReferenceFrameSubstandard] == 0)
+		Cost[DecodeCostNonReferenceFrameSubstandard] = RoundedLongLongIntegerPart((int)Cost[DecodeCostNonReferenceFrame] / TrickModeParameters.SubstandardDecodeRateIncrease);
+	//
+	// Convert everything to integer loads
+	//
+	FrameRate = RoundedLongLongIntegerPart(Speed * CodedFrameRate * 1000);
+	IndependentFraction = RoundedLongLongIntegerPart(TrickModeGroupStructureIndependentFrames * 1000);
+	ReferenceFraction = RoundedLongLongIntegerPart(TrickModeGroupStructureReferenceFrames * 1000) - IndependentFraction;
+	NonReferenceFraction = 1000 - IndependentFraction - ReferenceFraction;
+	if ((FrameRate <= 0) || (ReferenceFraction < 0) || (NonReferenceFraction < 0))
+		return false;
+	Budget = (1000000 * DECODE_COST_BUDGET_PERCENT) / 100;
+	IndependentLoad = (FrameRate * IndependentFraction * Cost[DecodeCostIndependentFrame]) / 1000000;
+	ReferenceLoad = (FrameRate * ReferenceFraction * Cost[DecodeCostReferenceFrame]) / 1000000;
+	NonReferenceLoad = (FrameRate * NonReferenceFraction * Cost[DecodeCostNonReferenceFrame]) / 1000000;
+	//
+	// Share out the budget
+	//
+	*PortionOfNonReferenceFramesToLose = 0;
+	if ((IndependentLoad + ReferenceLoad + NonReferenceLoad) <= Budget)
+	{
+		*Domain = TrickModeDecodeAll;
+		return true;
+	}
+	if (TrickModeParameters.SubstandardDecodeSupported)
+	{
+		NonReferenceLoad = (FrameRate * NonReferenceFraction * Cost[DecodeCostNonReferenceFrameSubstandard]) / 1000000;
+		if ((IndependentLoad + ReferenceLoad + NonReferenceLoad) <= Budget)
+		{
+			*Domain = TrickModeDecodeAllDegradeNonReferenceFrames;
+			return true;
+		}
+	}
+	if (((IndependentLoad + ReferenceLoad) < Budget) && (NonReferenceLoad != 0))
+	{
+		*Domain = TrickModeStartDiscardingNonReferenceFrames;
+		*PortionOfNonReferenceFramesToLose = Rational_t(NonReferenceLoad - (Budget - IndependentLoad - ReferenceLoad), NonReferenceLoad);
+		return true;
+	}
+	*Domain = ((IndependentLoad + ReferenceLoad) <= Budget) ?
+		  TrickModeDecodeReferenceFramesDegradeNonKeyFrames :
+		  TrickModeDecodeKeyFrames;
+	return true;
+}
+
 // /////////////////////////////////////////////////////////////////////////
 //
 // Read the trick mode parameters, and set the trick mode
@@ -1376,18 +1519,27 @@ OutputTimerStatus_t OutputTimer_Base_c::TrickModeControl(void)
 		//
 		// Calculate the domain
 		//
+		TrickModeCostModelValid = false;
 		if (TrickModePolicy == PolicyValueTrickModeAuto)
 		{
-			if (Speed > TrickModeDomainTransitToDecodeKey)
-				TrickModeDomain = TrickModeDecodeKeyFrames;
-			else if (Speed > TrickModeDomainTransitToDecodeReference)
-				TrickModeDomain = TrickModeDecodeReferenceFramesDegradeNonKeyFrames;
-			else if (Speed > TrickModeDomainTransitToStartDiscard)
-				TrickModeDomain = TrickModeStartDiscardingNonReferenceFrames;
-			else if (Speed > TrickModeDomainTransitToDegradeNonReference)
-				TrickModeDomain = TrickModeDecodeAllDegradeNonReferenceFrames;
-			else
-				TrickModeDomain = TrickModeDecodeAll;
+			//
+			// Prefer the decode cost model, falling back on the
+			// empirical frame rate boundaries until costs are known.
+			//
+			TrickModeCostModelValid = SelectTrickModeDomainByCost(Speed, &TrickModeDomain, &TrickModeCostModelPortion);
+			if (!TrickModeCostModelValid)
+			{
+				if (Speed > TrickModeDomainTransitToDecodeKey)
+					TrickModeDomain = TrickModeDecodeKeyFrames;
+				else if (Speed > TrickModeDomainTransitToDecodeReference)
+					TrickModeDomain = TrickModeDecodeReferenceFramesDegradeNonKeyFrames;
+				else if (Speed > TrickModeDomainTransitToStartDiscard)
+					TrickModeDomain = TrickModeStartDiscardingNonReferenceFrames;
+				else if (Speed > TrickModeDomainTransitToDegradeNonReference)
+					TrickModeDomain = TrickModeDecodeAllDegradeNonReferenceFrames;
+				else
+					TrickModeDomain = TrickModeDecodeAll;
+			}
 		}
 		else
 		{
@@ -1405,8 +1557,10 @@ OutputTimerStatus_t OutputTimer_Base_c::TrickModeControl(void)
 				AdjustedSpeedAfterFrameDrop = Speed;
 				break;
 			case TrickModeStartDiscardingNonReferenceFrames:
-				PortionOfPreDecodeFramesToLose = (1 - (TrickModeDomainTransitToDegradeNonReference / Speed)) /
-								 TrickModeGroupStructureNonReferenceFrames;
+				PortionOfPreDecodeFramesToLose = TrickModeCostModelValid ?
+								 TrickModeCostModelPortion :
+								 ((1 - (TrickModeDomainTransitToDegradeNonReference / Speed)) /
+								  TrickModeGroupStructureNonReferenceFrames);
 				if (PortionOfPreDecodeFramesToLose > 1)
 					PortionOfPreDecodeFramesToLose = 1;
 				AdjustedSpeedAfterFrameDrop = Speed * (1 - (PortionOfPreDecodeFramesToLose * TrickModeGroupStructureNonReferenceFrames));
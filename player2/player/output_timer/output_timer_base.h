@@ -209,6 +209,8 @@ class OutputTimer_Base_c : public OutputTimer_c
 		Rational_t TrickModeDomainTransitToStartDiscard;
 		Rational_t TrickModeDomainTransitToDecodeReference;
 		Rational_t TrickModeDomainTransitToDecodeKey;
+		bool TrickModeCostModelValid;
+		Rational_t TrickModeCostModelPortion;
 
 		Rational_t CodedFrameRate;
 		Rational_t LastCodedFrameRate;
@@ -248,6 +250,8 @@ class OutputTimer_Base_c : public OutputTimer_c
 		bool TimeMappingValidForDecodeTiming; // Values used in decode time window checking
 		unsigned int TimeMappingInvalidatedAtDecodeIndex;
 		unsigned long long LastSeenDecodeTime;
+		unsigned long long DecodeWindowBatchStart; // Normalized decode times of frames released without a wait
+		unsigned long long DecodeWindowBatchEnd;
 
 		unsigned long long NextExpectedPlaybackTime; // Value used in check for PTS jumps
 		unsigned long long PlaybackTimeIncrement;
@@ -288,10 +292,14 @@ class OutputTimer_Base_c : public OutputTimer_c
 							 unsigned long long I1End);
 
 		void SetTrickModeDomainBoundaries(void);
+		bool SelectTrickModeDomainByCost(Rational_t Speed,
+						 TrickModeDomain_t *Domain,
+						 Rational_t *PortionOfNonReferenceFramesToLose);
 		OutputTimerStatus_t TrickModeControl(void);
 		void InitializeGroupStructure(void);
 		void MonitorGroupStructure(ParsedFrameParameters_t *ParsedFrameParameters);
 		void DecodeInTimeFailure(unsigned long long FailedBy);
+		bool DecoderStarved(void);
 
 		OutputTimerStatus_t ExtractPointersPreDecode(Buffer_t Buffer);
 		OutputTimerStatus_t ExtractPointersPostDecode(Buffer_t Buffer);
@@ -390,6 +390,7 @@ OutputTimerStatus_t OutputTimer_Video_c::FillOutFrameTimingRecord(
 		if (InterlacedContentOnInterlacedDisplay && !PartialFrame)
 			SystemTimeError = SystemTimeError * 2;
 		SystemTime = SystemTime - SystemTimeError.LongLongIntegerPart();
+		OutputCoordinator->SnapToVsyncGrid(OutputCoordinatorContext, &SystemTime);
 	}
 	//
 	// Calculate the field counts
@@ -96,6 +96,7 @@ Player_Generic_c::Player_Generic_c(void)
 	SetPolicy(PlayerAllPlaybacks, PlayerAllStreams, PolicyDiscardLateFrames, PolicyValueDiscardLateFramesAfterSynchronize);
 	SetPolicy(PlayerAllPlaybacks, PlayerAllStreams, PolicyVideoStartImmediate, PolicyValueApply);
 	SetPolicy(PlayerAllPlaybacks, PlayerAllStreams, PolicySyncStartImmediate, PolicyValueDisapply);
+	SetPolicy(PlayerAllPlaybacks, PlayerAllStreams, PolicySyncStartFast, PolicyValueDisapply);
 	SetPolicy(PlayerAllPlaybacks, PlayerAllStreams, PolicyRebaseOnFailureToDeliverDataInTime, PolicyValueApply);
 	SetPolicy(PlayerAllPlaybacks, PlayerAllStreams, PolicyRebaseOnFailureToDecodeInTime, PolicyValueApply);
 	SetPolicy(PlayerAllPlaybacks, PlayerAllStreams, PolicyH264AllowNonIDRResynchronization, PolicyValueApply);
@@ -116,6 +117,8 @@ Player_Generic_c::Player_Generic_c(void)
 	SetPolicy(PlayerAllPlaybacks, PlayerAllStreams, PolicyVideoOutputWindowResizeSteps, 1);
 	SetPolicy(PlayerAllPlaybacks, PlayerAllStreams, PolicyIgnoreStreamUnPlayableCalls, PolicyValueDisapply);
 	SetPolicy(PlayerAllPlaybacks, PlayerAllStreams, PolicyUsePTSDeducedDefaultFrameRates, PolicyValueApply);
+	SetPolicy(PlayerAllPlaybacks, PlayerAllStreams, PolicyDisplayQueueTargetDepth, 0);
+	SetPolicy(PlayerAllPlaybacks, PlayerAllStreams, PolicyDisplayQueueMarginThreshold, 0);
 	//
 	// Here sits Nicks debug setting for player policies, do not add normal initialization after this point
 	//
@@ -821,6 +821,12 @@ class Player_Generic_c : public Player_c
 						     unsigned long long *SourceTime,
 						     unsigned long long *LocalTime = NULL);
 
+		PlayerStatus_t ClockRecoveryStatistics(PlayerPlayback_t Playback,
+						       unsigned long long *ConvergenceTime,
+						       unsigned int *AcceptedPoints = NULL,
+						       unsigned int *RejectedPoints = NULL,
+						       unsigned int *Discontinuities = NULL);
+
 		//
 		// Mechanisms for data insertion
 		//
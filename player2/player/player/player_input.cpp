@@ -68,6 +68,7 @@ PlayerStatus_t Player_Generic_c::InjectData(PlayerPlayback_t Playback,
 	unsigned int Length;
 	void *Data;
 	PlayerInputMuxType_t MuxType;
+	PlayerInputMuxType_t SoughtMuxType;
 	PlayerStatus_t Status;
 #ifdef __TDT__
 	DemultiplexorStatus_t DemuxStatus = NULL;
@@ -97,12 +98,14 @@ PlayerStatus_t Player_Generic_c::InjectData(PlayerPlayback_t Playback,
 	else
 	{
 		//
-		// Data is muxed - seek a demultiplexor and pass on the call
+		// Data is muxed - seek a demultiplexor and pass on the call,
+		// the transport stream demultiplexor handles both packet formats.
 		//
+		SoughtMuxType = (Descriptor->MuxType == MuxTypeBluRayTransportStream) ? MuxTypeTransportStream : Descriptor->MuxType;
 		for (i = 0; i < DemultiplexorCount; i++)
 		{
 			Demultiplexors[i]->GetHandledMuxType(&MuxType);
-			if (MuxType == Descriptor->MuxType)
+			if (MuxType == SoughtMuxType)
 				break;
 		}
 		if (i < DemultiplexorCount)
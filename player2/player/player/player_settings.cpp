@@ -53,6 +53,7 @@ static const char *LookupPlayerPolicy(PlayerPolicy_t Policy)
 			C(PolicyAVDSynchronization);
 			C(PolicySyncStartImmediate);
 			C(PolicyManifestFirstFrameEarly);
+			C(PolicySyncStartFast);
 			C(PolicyVideoBlankOnShutdown);
 			C(PolicyStreamOnlyKeyFrames);
 			C(PolicyStreamSingleGroupBetweenDiscontinuities);
@@ -85,6 +86,8 @@ static const char *LookupPlayerPolicy(PlayerPolicy_t Policy)
 			C(PolicyVideoOutputWindowResizeSteps);
 			C(PolicyIgnoreStreamUnPlayableCalls);
 			C(PolicyUsePTSDeducedDefaultFrameRates);
+			C(PolicyDisplayQueueTargetDepth);
+			C(PolicyDisplayQueueMarginThreshold);
 			// Private policies (see player_generic.h)
 			C(PolicyPlayoutAlwaysPlayout);
 			C(PolicyPlayoutAlwaysDiscard);
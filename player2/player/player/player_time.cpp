@@ -341,6 +341,18 @@ PlayerStatus_t Player_Generic_c::ClockRecoveryEstimate(
 	return Playback->OutputCoordinator->ClockRecoveryEstimate(SourceTime, LocalTime);
 }
 
+//
+
+PlayerStatus_t Player_Generic_c::ClockRecoveryStatistics(
+	PlayerPlayback_t Playback,
+	unsigned long long *ConvergenceTime,
+	unsigned int *AcceptedPoints,
+	unsigned int *RejectedPoints,
+	unsigned int *Discontinuities)
+{
+	return Playback->OutputCoordinator->ClockRecoveryStatistics(ConvergenceTime, AcceptedPoints, RejectedPoints, Discontinuities);
+}
+
 // //////////////////////////////////////////////////////////////////////////////////////////////////
 //
 // Functions to hold the playback times (cross stream)
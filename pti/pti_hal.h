@@ -19,9 +19,12 @@ extern int pti_hal_slot_set_pid(int session_handle, int slot_handle, u16 pid);
 extern int pti_hal_slot_unlink_buffer(int session_handle, int slot_handle);
 extern int pti_hal_slot_clear_pid(int session_handle, int slot_handle);
 extern void pti_hal_init ( struct stpti *pti , struct dvb_demux* demux, void (*_demultiplex_dvb_packets)(struct dvb_demux* demux, const u8 *buf, int count),int num);
+extern void pti_hal_set_packet_vector_handler(void (*_demultiplex_dvb_vector)(struct dvb_demux* demux, const u8 **packets, int count));
+extern void pti_hal_set_packet_block(int packets);
 extern int pti_hal_get_new_session_handle(int source, struct dvb_demux * demux);
 extern int pti_hal_get_new_descrambler(int session_handle);
 extern int pti_hal_set_source(int session_handle, const int source);
 extern void paceSwtsByPti(void);
+extern unsigned int pti_hal_get_input_rate(int tag);
 
 #endif //_PTI_HAL_H_
@@ -27,6 +27,7 @@
 #endif
 #include <linux/platform_device.h>
 #include <linux/mutex.h>
+#include <linux/proc_fs.h>
 
 #include <asm/io.h>
 
@@ -74,6 +75,7 @@ unsigned int dma_0_buffer_top;
 unsigned int dma_0_buffer_rp;
 #define TAG_COUNT 4
 #define AUX_COUNT 20
+#define AUX_COUNT_MAX 64
 #else
 #define TAG_COUNT 3
 #define AUX_COUNT 20
@@ -121,6 +123,7 @@ struct pti_internal
 static struct stpti *external = NULL;
 static struct pti_internal *internal = NULL;
 static void (*demultiplex_dvb_packets)(struct dvb_demux* demux, const u8 *buf, int count) = NULL;
+static void (*demultiplex_dvb_vector)(struct dvb_demux* demux, const u8 **packets, int count) = NULL;
 
 #ifdef __TDT__
 #define DMA_POLLING_INTERVAL (1)
@@ -143,18 +146,79 @@ static struct timer_list ptiTimer;
 
 /* The work queue is a communication means between the process
    polling the DMA and the process injecting the TS data into the
-   demultiplexer. It is assumed that the injector process is fast
-   enough to process the entries in the work queue. */
+   demultiplexer. There is exactly one producer (the polling timer)
+   and one consumer (the injector thread), only the producer writes
+   writeIndex and only the consumer readIndex, so no lock is needed,
+   just barriers ordering an entry against the index publishing it.
+   One entry is always left free to tell a full queue from an empty one.
+   When the queue is full the chunk is dropped and accounted per tag. */
 static struct
 {
 	int offset;
 	int count;
+	int held;			/* DMA space is released by the injector */
+#ifdef __TDT__
+	unsigned int generation;
+#endif
 } workQueue[QUEUE_SIZE];
 
-static struct semaphore workSem;
+static volatile int readIndex;
+static volatile int writeIndex;
+
+/* Statistics exported through /proc/pti_stats. Each field has a single
+   writer, the polling timer or the injector thread. */
+#define PTI_PROC_FILENAME "pti_stats"
+
+static struct
+{
+	unsigned int injected[TAG_COUNT];	/* packets handed to a demux */
+	unsigned int dropped[TAG_COUNT];	/* packets lost on a full work queue */
+	unsigned int unrouted;			/* packets for a tag without a demux */
+	unsigned int stalled;			/* polls left in the DMA buffer on a full work queue */
+	unsigned int coalesced;			/* queue entries merged into the one before */
+	unsigned int pti_discards;		/* packets the PTI discarded itself */
+	unsigned int iif_overflows;
+	unsigned int iif_peak;			/* fullest the IIF fifo has been, in bytes */
+	unsigned int max_depth;			/* deepest the work queue has been */
+	unsigned int rate[TAG_COUNT];		/* packets per second over the last second */
+	unsigned int swts_paced;		/* software injections held back */
+	unsigned int swts_pace_ms;		/* time they were held back */
+} ptiStats;
+
+/* Pacing of the software injection (SWTS) into the TS merger. The tuner
+   inputs cannot be held back, so when the PTI falls behind it is the SWTS
+   that waits in paceSwtsByPti() before its next transfer. It waits while
+   the IIF fifo is above swtsIifLevel bytes, while the work queue is more
+   than half full, or while the packet rate of all the inputs together is
+   above iifBitrate kbit/s (0 for no limit). */
+static int swtsPacing = 1;
+static int swtsIifLevel = 96;
+static int iifBitrate = 0;
+
+#define SWTS_PACE_MAX_MS 50
+
+/* In zero copy mode the packets are handed to the demultiplexer where
+   they lie in the DMA buffer, as a vector of pointers past the TS merger
+   tag. The DMA read pointer can then only be moved once the injector has
+   finished with them, so the injector records how far it got and the
+   polling process gives the space back to the PTI. A DMA reset bumps the
+   generation so work queued before it is never released. */
+static int zeroCopy = 0;
+
+/* Packets gathered per tag before they are passed to the demux. The
+   player raises this with pti_hal_set_packet_block() for its bulk demux,
+   and on TDT the aux buffers are allocated to that size by pti_hal_init(). */
+static int auxCount = AUX_COUNT;
+
+#ifdef __TDT__
+static u8 *auxBuffer;
+static const u8 **auxVector;
 
-static int readIndex;
-static int writeIndex;
+static DEFINE_SPINLOCK(releaseLock);
+static unsigned int releasePointer;
+static unsigned int releaseCount;
+static unsigned int dmaGeneration;
+#endif
 
 /* PTI write ignores byte enables */
 static void PtiWrite(volatile unsigned short int *addr,unsigned short int value)
@@ -319,10 +383,44 @@ static void stpti_reset_dma(struct pti_internal *pti)
 
 */
 
+static void inject_packets(struct dvb_demux *demux, int held, const u8 *buf, const u8 **packets, int count)
+{
+	if (held)
+	{
+		demultiplex_dvb_vector(demux, packets, count);
+	}
+	else
+	{
+		demultiplex_dvb_packets(demux, buf, count);
+	}
+}
+
+#ifdef __TDT__
+/* Called by the injector once the demux has finished with a work queue
+   entry that is still held in the DMA buffer */
+static void release_packets(int offset, int count, unsigned int generation)
+{
+	spin_lock_bh(&releaseLock);
+	if (generation == dmaGeneration)
+	{
+		releasePointer = dma_0_buffer_base + offset + (count * PACKET_SIZE);
+		if (releasePointer >= dma_0_buffer_top)
+		{
+			releasePointer = dma_0_buffer_base;
+		}
+		releaseCount += count;
+	}
+	spin_unlock_bh(&releaseLock);
+}
+#endif
+
 static int stream_injector(void *user_data)
 {
-	int offset, count;
-	int overflow = 0;
+	int offset, count, held;
+	int lastIndex, nextIndex;
+#ifdef __TDT__
+	unsigned int generation;
+#endif
 
 //aktivate STREAMCHECK for debug
 //#define STREAMCHECK
@@ -350,27 +448,40 @@ static int stream_injector(void *user_data)
 
 	while(1)
 	{
-		/* the polling process increments the semaphore whenever it writes
+		/* the polling process wakes us whenever it writes
 		   an entry into the queue */
-		if (down_interruptible(&workSem))
+		if (wait_event_interruptible(internal->queue, writeIndex != readIndex))
 		{
 			break;
 		}
-		if (writeIndex == readIndex)
-		{
-			if (!overflow)
-			{
-				printk("PTI: queue overflow\n");
-				overflow = 1;
-			}
-			/* discard the buffer because the injector is too slow */
-			continue;
-		}
-		overflow = 0;
+		smp_rmb();
 
 		/* copy the start offset and the packet count to local variables */
 		offset = workQueue[readIndex].offset;
 		count = workQueue[readIndex].count;
+		held = workQueue[readIndex].held;
+#ifdef __TDT__
+		generation = workQueue[readIndex].generation;
+#endif
+
+		/* When we have fallen behind take every following entry that
+		   continues in the buffer in one go, so the batch size grows
+		   with the load and the per chunk overhead does not */
+		lastIndex = readIndex;
+		nextIndex = (readIndex + 1) % QUEUE_SIZE;
+		while ((nextIndex != writeIndex)
+		&&     (workQueue[nextIndex].offset == (offset + (count * PACKET_SIZE)))
+		&&     (workQueue[nextIndex].held == held)
+#ifdef __TDT__
+		&&     (workQueue[nextIndex].generation == generation)
+#endif
+		)
+		{
+			count += workQueue[nextIndex].count;
+			ptiStats.coalesced++;
+			lastIndex = nextIndex;
+			nextIndex = (nextIndex + 1) % QUEUE_SIZE;
+		}
 
 		//printk(".");
 
@@ -396,19 +507,33 @@ static int stream_injector(void *user_data)
 		{
 			u8 *pFrom = &internal->back_buffer[offset];
 #ifdef __TDT__
-			static u8 auxbuf[TAG_COUNT][PACKET_SIZE_WO_HEADER * AUX_COUNT];
-			u8 *pTo[TAG_COUNT] = { auxbuf[0], auxbuf[1], auxbuf[2], auxbuf[3] };
+			u8 *auxbuf[TAG_COUNT];
+			const u8 **vector[TAG_COUNT];
+			u8 *pTo[TAG_COUNT];
 			int count1[TAG_COUNT] = { 0, 0, 0, 0 };
 #else
 			static u8 auxbuf[TAG_COUNT][(PACKET_SIZE - HEADER_SIZE) * AUX_COUNT];
 			u8 *pTo[TAG_COUNT] = { auxbuf[0], auxbuf[1], auxbuf[2] };
 			int count1[TAG_COUNT] = { 0, 0, 0 };
+			/* only the injector thread uses these, like auxbuf */
+			static const u8 *vector[TAG_COUNT][AUX_COUNT];
 #endif
 			int n;
 
+#ifdef __TDT__
+			for (n = 0; n < TAG_COUNT; n++)
+			{
+				auxbuf[n] = auxBuffer + (n * auxCount * PACKET_SIZE_WO_HEADER);
+				vector[n] = auxVector + (n * auxCount);
+				pTo[n] = auxbuf[n];
+			}
+#endif
+
 			/* sort the packets according to the tag,
 			   remove the TS merger tags and squeeze the
-			   packets to improve the performance */
+			   packets to improve the performance (in zero
+			   copy mode only the packet addresses are
+			   sorted, the tag is skipped by the stride) */
 			for (n = 0; n < count; n++)
 			{
 			 	/* Only the tag IDs of TS inputs are taken into account.
@@ -420,13 +545,18 @@ static int stream_injector(void *user_data)
 				int tag = (pFrom[0] >> 2) & 0xf;
 				/* only copy if the demux exists */
 	#if defined(SPARK7162)
-			if ((tag < TAG_COUNT)
-			&&  (internal->demux[internal->demux_tag[tag]] != NULL))
+			if ((tag >= TAG_COUNT)
+			||  (internal->demux[internal->demux_tag[tag]] == NULL))
 	#else
-			if ((tag < TAG_COUNT)
-			&&  (internal->demux[tag] != NULL))
+			if ((tag >= TAG_COUNT)
+			||  (internal->demux[tag] == NULL))
 	#endif
 			{
+				ptiStats.unrouted++;
+			}
+			else
+			{
+				ptiStats.injected[tag]++;
 #ifdef STREAMCHECK
 				// check for startbyte of all paket
 				if (pFrom[6] != 0x47)
@@ -497,23 +627,30 @@ static int stream_injector(void *user_data)
 					}
 				}
 #endif
+				if (held)
+				{
+					vector[tag][count1[tag]] = pFrom + HEADER_SIZE;
+				}
+				else
+				{
 #ifdef __TDT__
-				memmove(pTo[tag], pFrom + HEADER_SIZE, PACKET_SIZE_WO_HEADER);
-				pTo[tag] += PACKET_SIZE_WO_HEADER;
+					memmove(pTo[tag], pFrom + HEADER_SIZE, PACKET_SIZE_WO_HEADER);
+					pTo[tag] += PACKET_SIZE_WO_HEADER;
 #else
-				memmove(pTo[tag], pFrom + HEADER_SIZE,
-				PACKET_SIZE - HEADER_SIZE);
-				pTo[tag] += PACKET_SIZE - HEADER_SIZE;
+					memmove(pTo[tag], pFrom + HEADER_SIZE,
+					PACKET_SIZE - HEADER_SIZE);
+					pTo[tag] += PACKET_SIZE - HEADER_SIZE;
 #endif
+				}
 				count1[tag]++;
-				if (count1[tag] >= AUX_COUNT)
+				if (count1[tag] >= auxCount)
 				{
 					// printk("%d", tag);
 					/* inject the packets */
 	#if defined(SPARK7162)
-					demultiplex_dvb_packets(internal->demux[internal->demux_tag[tag]], auxbuf[tag], count1[tag]);
+					inject_packets(internal->demux[internal->demux_tag[tag]], held, auxbuf[tag], vector[tag], count1[tag]);
 	#else
-					demultiplex_dvb_packets(internal->demux[tag], auxbuf[tag], count1[tag]);
+					inject_packets(internal->demux[tag], held, auxbuf[tag], vector[tag], count1[tag]);
 	#endif
 					pTo[tag] = auxbuf[tag];
 					count1[tag] = 0;
@@ -528,20 +665,29 @@ static int stream_injector(void *user_data)
 			if ((count1[n] > 0)
 			&& (internal->demux[internal->demux_tag[n]] != NULL))
 			{
-				demultiplex_dvb_packets(internal->demux[internal->demux_tag[n]], auxbuf[n], count1[n]);
+				inject_packets(internal->demux[internal->demux_tag[n]], held, auxbuf[n], vector[n], count1[n]);
 			}
 	#else
 			if ((count1[n] > 0)
 			&& (internal->demux[n] != NULL))
 			{
-				demultiplex_dvb_packets(internal->demux[n], auxbuf[n], count1[n]);
+				inject_packets(internal->demux[n], held, auxbuf[n], vector[n], count1[n]);
 			}
 	#endif
 		}
 	}
 
-	/* increment the readIndex */
-	readIndex = (readIndex + 1) % QUEUE_SIZE;
+#ifdef __TDT__
+	/* the demux is done with the packets, let the DMA reuse the space */
+	if (held)
+	{
+		release_packets(offset, count, generation);
+	}
+#endif
+
+	/* release the entries, the producer may now reuse them */
+	smp_mb();
+	readIndex = (lastIndex + 1) % QUEUE_SIZE;
 	}
 
 	return 0;
@@ -555,11 +701,126 @@ static int stream_injector(void *user_data)
    lots of packets (presumably > 500) even if the buffer is not full.
    Therefore, it is important that the polling process always does its work
    on time. */
+static int work_queue_space(void)
+{
+	return (readIndex - writeIndex - 1 + QUEUE_SIZE) % QUEUE_SIZE;
+}
+
+static void queue_dma_work(int offset, int count, int held)
+{
+	int depth;
+
+	workQueue[writeIndex].offset = offset;
+	workQueue[writeIndex].count = count;
+	workQueue[writeIndex].held = held;
 #ifdef __TDT__
+	workQueue[writeIndex].generation = dmaGeneration;
+#endif
+	smp_wmb();
+	writeIndex = (writeIndex + 1) % QUEUE_SIZE;
+
+	depth = QUEUE_SIZE - 1 - work_queue_space();
+	if (depth > ptiStats.max_depth)
+	{
+		ptiStats.max_depth = depth;
+	}
+	wake_up_interruptible(&internal->queue);
+}
+
+/* Work out the packet rate of each tag once a second, from the timer */
+static void update_input_rates(void)
+{
+	static unsigned int lastInjected[TAG_COUNT];
+	static unsigned long lastSample = 0;
+	unsigned long elapsed = jiffies - lastSample;
+	unsigned int injected;
+	int n;
+
+	if (elapsed < HZ)
+	{
+		return;
+	}
+	for (n = 0; n < TAG_COUNT; n++)
+	{
+		injected = ptiStats.injected[n];
+		ptiStats.rate[n] = ((injected - lastInjected[n]) * HZ) / elapsed;
+		lastInjected[n] = injected;
+	}
+	lastSample = jiffies;
+}
+
+static void sample_iif_level(unsigned int pti_status)
+{
+	unsigned int level = PTI_IIF_FIFO_COUNT_BYTES(pti_status);
+
+	if (level > ptiStats.iif_peak)
+	{
+		ptiStats.iif_peak = level;
+	}
+}
+
+/* The injector is too slow and the work queue is full, the chunk is lost.
+   Count what was lost against each tag so recordings can be checked. */
+static void drop_dma_work(int offset, int count)
+{
+	static unsigned long lastReport = 0;
+	u8 *pFrom = (u8 *)&internal->back_buffer[offset];
+	int n, tag;
+
+#if LINUX_VERSION_CODE < KERNEL_VERSION(2,6,30)
+	dma_cache_inv((void*)pFrom, count * PACKET_SIZE);
+#else
+	invalidate_ioremap_region(0, internal->back_buffer, offset, count * PACKET_SIZE);
+#endif
+	for (n = 0; n < count; n++)
+	{
+		tag = (pFrom[0] >> 2) & 0xf;
+		if (tag < TAG_COUNT)
+		{
+			ptiStats.dropped[tag]++;
+		}
+		pFrom += PACKET_SIZE;
+	}
+
+	if (time_after(jiffies, lastReport + HZ))
+	{
+		printk("PTI: queue overflow, %d packets dropped\n", count);
+		lastReport = jiffies;
+	}
+}
+
+#ifdef __TDT__
+
+/* Give the packets the injector has finished with back to the PTI */
+static void process_pti_release(void)
+{
+	unsigned int pointer, count = 0;
+
+	spin_lock(&releaseLock);
+	/* The PTI must have acknowledged the previous update */
+	if (releaseCount && !*internal->pread)
+	{
+		pointer = releasePointer;
+		count = releaseCount;
+		releaseCount = 0;
+	}
+	spin_unlock(&releaseLock);
+
+	if (count)
+	{
+		/* Now update the read pointer in the DMA engine */
+		writel(pointer, internal->pti_io + PTI_DMA_0_READ);
+
+		/* Now tell the firmware how many packets we have read */
+		PtiWrite(internal->pread, count);
+	}
+}
+
 static void process_pti_dma(unsigned long data)
 {
 	unsigned int pti_wp, num_packets, pti_status;
 	bool buffer_round=0;
+	int held = zeroCopy && (demultiplex_dvb_vector != NULL);
 
 	/* Load the write pointers, so we know where we are in the buffers */
 	pti_wp = readl(internal->pti_io + PTI_DMA_0_WRITE);
@@ -569,11 +830,14 @@ static void process_pti_dma(unsigned long data)
 
 	/* Read status registers */
 	pti_status = readl(internal->pti_io + PTI_IIF_FIFO_COUNT);
+	sample_iif_level(pti_status);
+	update_input_rates();
 
 	/* Error if we overflow */
 	if (pti_status & PTI_IIF_FIFO_FULL)
 	{
 		internal->err_count++;
+		ptiStats.iif_overflows++;
 		printk(KERN_WARNING "%s: IIF Overflow\n",__FUNCTION__);
 	}
 
@@ -584,10 +848,14 @@ static void process_pti_dma(unsigned long data)
 			*internal->discard,*internal->pread,*internal->pwrite);
 
 		internal->err_count++;
+		ptiStats.pti_discards += *internal->discard;
+		/* work already queued is still consumed, but held space
+		   from before the reset must not be released again */
+		spin_lock(&releaseLock);
+		dmaGeneration++;
+		releaseCount = 0;
+		spin_unlock(&releaseLock);
 		stpti_reset_dma(internal);
-		//writeIndex = 0;
-		//readIndex = 0;
-		//the semaphore must by also resetet to 0, fix later
 		stpti_start_dma(internal);
 	}
 	else
@@ -610,11 +878,18 @@ static void process_pti_dma(unsigned long data)
 			buffer_round=1;
 		}
 
+		/* In zero copy mode a full work queue leaves the packets in the
+		   DMA buffer until the injector catches up */
+		if (num_packets && held && (work_queue_space() < (buffer_round ? 2 : 1)))
+		{
+			ptiStats.stalled++;
+		}
 		/* If we have some packets */
-		if (num_packets)
+		else if (num_packets)
 		{
-			/* And the PTI has acknowledged the updated the packets */
-			if (!*internal->pread)
+			/* And the PTI has acknowledged the updated the packets
+			   (in zero copy mode the space is released later) */
+			if (held || !*internal->pread)
 			{
 				/* Increment the loop counter */
 				internal->loop_count++;
@@ -622,36 +897,46 @@ static void process_pti_dma(unsigned long data)
 				/* Increment the packet_count, by the number of packets we have processed */
 				internal->packet_count+=num_packets;
 
-				/* Now update the read pointer in the DMA engine */
-				writel(pti_wp, internal->pti_io + PTI_DMA_0_READ);
+				if (!held)
+				{
+					/* Now update the read pointer in the DMA engine */
+					writel(pti_wp, internal->pti_io + PTI_DMA_0_READ);
 
-				/* Now tell the firmware how many packets we have read */
-				PtiWrite(internal->pread, num_packets);
+					/* Now tell the firmware how many packets we have read */
+					PtiWrite(internal->pread, num_packets);
+				}
 
 				/* notify the injector thread */
 				if (buffer_round)
 				{
 					unsigned int num_packets1 = (dma_0_buffer_top - dma_0_buffer_rp) / PACKET_SIZE;
-					workQueue[writeIndex].offset = dma_0_buffer_rp - dma_0_buffer_base;
-					workQueue[writeIndex].count = num_packets1;
-					writeIndex = (writeIndex + 1) % QUEUE_SIZE;
-					up(&workSem);
-
-					workQueue[writeIndex].offset = 0;
-					workQueue[writeIndex].count = num_packets-num_packets1;
-					writeIndex = (writeIndex + 1) % QUEUE_SIZE;
-					up(&workSem);
+					if (work_queue_space() >= 2)
+					{
+						queue_dma_work(dma_0_buffer_rp - dma_0_buffer_base, num_packets1, held);
+						queue_dma_work(0, num_packets-num_packets1, held);
+					}
+					else
+					{
+						drop_dma_work(dma_0_buffer_rp - dma_0_buffer_base, num_packets1);
+						drop_dma_work(0, num_packets-num_packets1);
+					}
+				}
+				else if (work_queue_space() >= 1)
+				{
+					queue_dma_work(dma_0_buffer_rp - dma_0_buffer_base, num_packets, held);
 				}
 				else
 				{
-					workQueue[writeIndex].offset = dma_0_buffer_rp - dma_0_buffer_base;
-					workQueue[writeIndex].count = num_packets;
-					writeIndex = (writeIndex + 1) % QUEUE_SIZE;
-					up(&workSem);
+					drop_dma_work(dma_0_buffer_rp - dma_0_buffer_base, num_packets);
 				}
 				dma_0_buffer_rp = pti_wp;
 			} // not read
 		} // num_packet
+
+		if (held)
+		{
+			process_pti_release();
+		}
 	} // discard
 
 	/* reschedule the timer */
@@ -677,11 +962,14 @@ static void process_pti_dma(unsigned long data)
 	/* Read status registers */
 	pti_status = readl(internal->pti_io + PTI_IIF_FIFO_COUNT);
 	dma_status = readl(internal->pti_io + PTI_DMA_0_STATUS);
+	sample_iif_level(pti_status);
+	update_input_rates();
 
 	/* Error if we overflow */
 	if (pti_status & PTI_IIF_FIFO_FULL)
 	{
 		internal->err_count++;
+		ptiStats.iif_overflows++;
 		printk(KERN_WARNING "%s: IIF Overflow\n",__FUNCTION__);
 	}
 
@@ -697,6 +985,7 @@ static void process_pti_dma(unsigned long data)
 		printk(KERN_WARNING "%s: Reseting DMA\n",__FUNCTION__);
 
 		internal->err_count++;
+		ptiStats.pti_discards += *internal->discard;
 		stpti_reset_dma(internal);
 		stpti_start_dma(internal);
 	}
@@ -771,10 +1060,14 @@ static void process_pti_dma(unsigned long data)
 				//printk("*");
 
 				/* notify the injector thread */
-				workQueue[writeIndex].offset = start_offset;
-				workQueue[writeIndex].count = num_packets;
-				writeIndex = (writeIndex + 1) % QUEUE_SIZE;
-				up(&workSem);
+				if (work_queue_space() >= 1)
+				{
+					queue_dma_work(start_offset, num_packets, 0);
+				}
+				else
+				{
+					drop_dma_work(start_offset, num_packets);
+				}
 			}  // not read
 		} // num_packet
 	} // discard
@@ -798,6 +1091,20 @@ void pti_hal_init ( struct stpti *pti , struct dvb_demux* demux, void (*_demulti
 		return;
 	}
 
+#ifdef __TDT__
+	auxBuffer = kmalloc(TAG_COUNT * auxCount * PACKET_SIZE_WO_HEADER, GFP_KERNEL);
+	auxVector = kmalloc(TAG_COUNT * auxCount * sizeof(const u8 *), GFP_KERNEL);
+	if ((auxBuffer == NULL) || (auxVector == NULL))
+	{
+		printk("%s: cannot allocate the aux buffers for %d packets\n", __func__, auxCount);
+		kfree(auxBuffer);
+		kfree(auxVector);
+		auxBuffer = NULL;
+		auxVector = NULL;
+		return;
+	}
+#endif
+
 	demultiplex_dvb_packets = _demultiplex_dvb_packets;
 	external = pti;
 
@@ -914,7 +1221,7 @@ void pti_hal_init ( struct stpti *pti , struct dvb_demux* demux, void (*_demulti
 	}
 
 	/* set up the processing thread */
-	sema_init(&workSem, 0);
+	init_waitqueue_head(&internal->queue);
 	kernel_thread(stream_injector, internal, 0);
 
 	/* schedule the polling process */
@@ -1161,11 +1468,62 @@ int pti_hal_get_new_session_handle(int source, struct dvb_demux * demux)
 	return source;
 }
 
+/* Total rate of the inputs in kbit/s, from the per tag packet rates */
+static unsigned int input_bitrate(void)
+{
+	unsigned int packets = 0;
+	int n;
+
+	for (n = 0; n < TAG_COUNT; n++)
+	{
+		packets += ptiStats.rate[n];
+	}
+	return (packets * 188 * 8) / 1000;
+}
+
+/* Called by the TS merger before each software injection, sleeps until
+   the PTI has room again. Bounded so a stopped PTI cannot hang the writer. */
 void paceSwtsByPti(void)
 {
+	unsigned int pti_status;
+	int waited;
+
+	if (!swtsPacing || (internal == NULL))
+	{
+		return;
+	}
+	for (waited = 0; waited < SWTS_PACE_MAX_MS; waited++)
+	{
+		pti_status = readl(internal->pti_io + PTI_IIF_FIFO_COUNT);
+		if (!(pti_status & PTI_IIF_FIFO_FULL)
+		&&  (PTI_IIF_FIFO_COUNT_BYTES(pti_status) < swtsIifLevel)
+		&&  ((QUEUE_SIZE - 1 - work_queue_space()) < (QUEUE_SIZE / 2))
+		&&  ((iifBitrate == 0) || (input_bitrate() < iifBitrate)))
+		{
+			break;
+		}
+		msleep(1);
+	}
+	if (waited)
+	{
+		ptiStats.swts_paced++;
+		ptiStats.swts_pace_ms += waited;
+	}
+}
+
+/* Packets per second the PTI received with the given tag, that is from
+   the given TS merger input, over the last second */
+unsigned int pti_hal_get_input_rate(int tag)
+{
+	if ((tag < 0) || (tag >= TAG_COUNT))
+	{
+		return 0;
+	}
+	return ptiStats.rate[tag];
 }
 
 EXPORT_SYMBOL(paceSwtsByPti);
+EXPORT_SYMBOL(pti_hal_get_input_rate);
 
 EXPORT_SYMBOL(pti_hal_descrambler_set);
 EXPORT_SYMBOL(pti_hal_descrambler_set_aes);
@@ -1186,14 +1544,69 @@ EXPORT_SYMBOL(pti_hal_get_session_handle);
 EXPORT_SYMBOL(pti_hal_get_new_session_handle);
 EXPORT_SYMBOL(pti_hal_init);
 
+/* Register the demux entry taking packets in place in the DMA buffer,
+   used instead of the copying one when the zeroCopy parameter is set */
+void pti_hal_set_packet_vector_handler(void (*_demultiplex_dvb_vector)(struct dvb_demux* demux, const u8 **packets, int count))
+{
+	demultiplex_dvb_vector = _demultiplex_dvb_vector;
+}
+EXPORT_SYMBOL(pti_hal_set_packet_vector_handler);
+
+/* Pass the packets of each tag to the demux in blocks of up to packets
+   instead of AUX_COUNT, for a demux that filters whole blocks. Only
+   honoured before pti_hal_init(), which sizes the aux buffers. */
+void pti_hal_set_packet_block(int packets)
+{
+#ifdef __TDT__
+	if ((packets > 0) && (packets <= AUX_COUNT_MAX) && (auxBuffer == NULL))
+	{
+		auxCount = packets;
+	}
+#endif
+}
+EXPORT_SYMBOL(pti_hal_set_packet_block);
+
+static int pti_read_proc(char *page, char **start, off_t off, int count, int *eof, void *data_unused)
+{
+	int len = 0;
+	int n;
+
+	if (off > 0)
+	{
+		*eof = 1;
+		return 0;
+	}
+
+	len += sprintf(page + len, "tag  injected   dropped  pkts/s\n");
+	for (n = 0; n < TAG_COUNT; n++)
+	{
+		len += sprintf(page + len, "%3d %9u %9u %7u\n", n, ptiStats.injected[n], ptiStats.dropped[n], ptiStats.rate[n]);
+	}
+	len += sprintf(page + len, "unrouted      %u\n", ptiStats.unrouted);
+	len += sprintf(page + len, "stalled       %u\n", ptiStats.stalled);
+	len += sprintf(page + len, "coalesced     %u\n", ptiStats.coalesced);
+	len += sprintf(page + len, "pti_discards  %u\n", ptiStats.pti_discards);
+	len += sprintf(page + len, "iif_overflows %u\n", ptiStats.iif_overflows);
+	len += sprintf(page + len, "iif_peak      %u bytes\n", ptiStats.iif_peak);
+	len += sprintf(page + len, "input_rate    %u kbit/s\n", input_bitrate());
+	len += sprintf(page + len, "swts_paced    %u (%u ms)\n", ptiStats.swts_paced, ptiStats.swts_pace_ms);
+	len += sprintf(page + len, "queue_depth   %u/%u (max %u)\n",
+		       QUEUE_SIZE - 1 - work_queue_space(), QUEUE_SIZE - 1, ptiStats.max_depth);
+
+	*eof = 1;
+	return len;
+}
+
 int __init pti_init(void)
 {
+	 create_proc_read_entry(PTI_PROC_FILENAME, 0, NULL, pti_read_proc, NULL);
 	 printk("pti loaded\n");
 	 return 0;
 }
 
 static void __exit pti_exit(void)
 {
+	 remove_proc_entry(PTI_PROC_FILENAME, NULL);
 	 printk("pti unloaded\n");
 }
 
@@ -1219,6 +1632,16 @@ MODULE_PARM_DESC(videoMem, "videoMem\n");
 #else
 #endif
 
+module_param(zeroCopy, int, 0444);
+MODULE_PARM_DESC(zeroCopy, "Demultiplex in place in the DMA buffer (1) or copy the packets out (0)");
+
+module_param(swtsPacing, int, 0644);
+MODULE_PARM_DESC(swtsPacing, "Hold software injection back while the PTI is behind (1) or not (0)");
+module_param(swtsIifLevel, int, 0644);
+MODULE_PARM_DESC(swtsIifLevel, "IIF fifo level in bytes above which software injection waits");
+module_param(iifBitrate, int, 0644);
+MODULE_PARM_DESC(iifBitrate, "Input rate in kbit/s above which software injection waits, 0 for no limit");
+
 MODULE_AUTHOR("Peter Bennett <peter.bennett@st.com>; adapted by TDT");
 MODULE_DESCRIPTION("STPTI DVB Driver");
 MODULE_LICENSE("GPL");
@@ -21,6 +21,8 @@
 #include "GammaCompositorPlane.h"
 #include "GammaBlitter.h"
 
+#include <STMCommon/stmswblitter.h>
+
 CGenericGammaDevice::CGenericGammaDevice(void): CDisplayDevice()
 {
   DEBUGF2(2,("CGenericGammaDevice::CGenericGammaDevice in\n"));
@@ -28,6 +30,7 @@ CGenericGammaDevice::CGenericGammaDevice(void): CDisplayDevice()
   m_pGammaReg       = 0;
   m_numPlanes       = 0;
   m_numAccelerators = 0;
+  m_pSWBlitter      = 0;
 
   for(unsigned i=0;i<CGAMMADEVICE_MAX_PLANES;i++)
   {
@@ -56,9 +59,12 @@ CGenericGammaDevice::~CGenericGammaDevice()
 
   for(unsigned i=0;i<m_numAccelerators;i++)
   {
-    delete m_graphicsAccelerators[i];
+    if(m_graphicsAccelerators[i] != m_pSWBlitter)
+      delete m_graphicsAccelerators[i];
   }
 
+  delete m_pSWBlitter;
+
   DEBUGF2(2,("CGenericGammaDevice::~CGenericGammaDevice() deleted graphics engines\n"));
 
   for (int i = 0; i < CDISPLAYDEVICE_MAX_OUTPUTS; i++)
@@ -90,6 +96,38 @@ bool CGenericGammaDevice::Create()
 }
 
 
+/*
+ * Used by the SoC devices when their hardware blitter cannot be created,
+ * so the blitter interface is still there with the drawing done by the CPU.
+ * Operations a working hardware blitter rejects are not passed on to it.
+ */
+bool CGenericGammaDevice::CreateSoftwareBlitter(void)
+{
+  CSTmSWBlitter *blitter;
+
+  for(unsigned i=0;i<N_ELEMENTS(m_graphicsAccelerators);i++)
+  {
+    m_graphicsAccelerators[i] = 0;
+  }
+  m_numAccelerators = 0;
+
+  blitter = new CSTmSWBlitter();
+  if(!blitter)
+  {
+    DEBUGF2(1,("CGenericGammaDevice::CreateSoftwareBlitter - failed to allocate blitter\n"));
+    return false;
+  }
+
+  DEBUGF2(1,("CGenericGammaDevice::CreateSoftwareBlitter - using the CPU blitter\n"));
+
+  m_pSWBlitter = blitter;
+  m_graphicsAccelerators[0] = blitter;
+  m_numAccelerators = 1;
+
+  return true;
+}
+
+
 CDisplayPlane* CGenericGammaDevice::GetPlane(stm_plane_id_t planenum) const
 {
   for(int i=0;i<(int)m_numPlanes;i++)
@@ -44,9 +44,14 @@ protected:
   CGAL *m_graphicsAccelerators[CGAMMADEVICE_MAX_ACCELERATORS];
   unsigned m_numAccelerators;
 
+  // Owned here, as the SoC destructors clear m_graphicsAccelerators
+  CGAL *m_pSWBlitter;
+
   // IO mapped pointer to the start of the Gamma register block
   ULONG* m_pGammaReg;
 
+  bool CreateSoftwareBlitter(void);
+
   void WriteDevReg(ULONG reg, ULONG val) { g_pIOS->WriteRegister(m_pGammaReg + (reg>>2), val); }
   ULONG ReadDevReg(ULONG reg) { return g_pIOS->ReadRegister(m_pGammaReg + (reg>>2)); }
 };
@@ -437,6 +437,79 @@ static int fill_rect(stm_display_blitter_t         *blitter,
 }
 
 
+static int fill_rects(stm_display_blitter_t         *blitter,
+                      const stm_blitter_operation_t *op,
+                      const stm_rect_t              *dstrects,
+                      int                            count)
+{
+  int ret=0;
+  CGAL*	pGAL = (CGAL*)(blitter->handle);
+
+  if(g_pIOS->DownSemaphore(blitter->lock) != 0)
+    return -1;
+
+  if(!pGAL->FillRects(*op, dstrects, count))
+    ret= -1;
+
+  g_pIOS->UpSemaphore(blitter->lock);
+
+  return ret;
+}
+
+
+static int copy_rects(stm_display_blitter_t         *blitter,
+                      const stm_blitter_operation_t *op,
+                      const stm_rect_t              *dstrects,
+                      const stm_point_t             *srcpoints,
+                      int                            count)
+{
+  int ret=0;
+  CGAL*	pGAL = (CGAL*)(blitter->handle);
+
+  if(g_pIOS->DownSemaphore(blitter->lock) != 0)
+    return -1;
+
+  /*
+   * Only plain copies can go down the batched path, anything else is
+   * queued one rectangle at a time as blit() would do.
+   */
+  if(op->ulFlags == 0
+     && (op->srcSurface.format == op->dstSurface.format)
+     && (op->srcSurface.format != SURF_CLUT1)
+     && (op->srcSurface.format != SURF_CLUT2)
+     && (op->srcSurface.format != SURF_CLUT4)
+     && (op->srcSurface.format != SURF_A1))
+  {
+    if(!pGAL->CopyRects(*op, dstrects, srcpoints, count))
+    {
+      DEBUGF2(1,("pGAL->CopyRects failed\n"));
+      ret = -1;
+    }
+  }
+  else
+  {
+    for(int i = 0; i < count; i++)
+    {
+      stm_rect_t srcrect = { srcpoints[i].x,
+                             srcpoints[i].y,
+                             srcpoints[i].x + (dstrects[i].right - dstrects[i].left),
+                             srcpoints[i].y + (dstrects[i].bottom - dstrects[i].top) };
+
+      if(!pGAL->CopyRectComplex(*op, dstrects[i], srcrect))
+      {
+        DEBUGF2(1,("pGAL->CopyRectComplex failed\n"));
+        ret = -1;
+        break;
+      }
+    }
+  }
+
+  g_pIOS->UpSemaphore(blitter->lock);
+
+  return ret;
+}
+
+
 static STMFBBDispSharedAreaPriv *get_shared_area(stm_display_blitter_t *blitter)
 {
   CGAL*	pGAL = (CGAL*)(blitter->handle);
@@ -500,7 +573,9 @@ const stm_display_blitter_ops_t stm_display_blitter_ops = {
   GetBlitLoad     : get_blt_load,
   GetSharedArea   : get_shared_area,
   HandleInterrupt : handle_blitter_interrupt,
-  Release         : release_blitter
+  Release         : release_blitter,
+  FillRects       : fill_rects,
+  CopyRects       : copy_rects
 };
 
 
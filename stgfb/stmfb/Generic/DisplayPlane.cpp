@@ -320,9 +320,13 @@ bool CDisplayPlane::GetNextNodeFromDisplayList(stm_plane_node &frame)
     if(!m_pNodeList[m_readerPos].isValid)
         return false;
 
-    m_ulStatus &= ~STM_PLANE_STATUS_QUEUE_FULL;
-
+    /*
+     * Read the node only after seeing it valid and hand the entry back to
+     * the writer only once it has been read, see AddToDisplayList.
+     */
+    g_pIOS->Barrier();
     frame = m_pNodeList[m_readerPos];
+    g_pIOS->Barrier();
     m_pNodeList[m_readerPos].isValid = false;
 
     m_readerPos++;
@@ -345,6 +349,8 @@ bool CDisplayPlane::PeekNextNodeFromDisplayList(const TIME64 &vsyncTime, stm_pla
     if(!m_pNodeList[m_readerPos].isValid)
         return false;
 
+    g_pIOS->Barrier();
+
     /*
      * Only return the next buffer if it is time to present it. This is
      * complicated by the fact that we have to program the hardware one vsync
@@ -370,8 +376,7 @@ bool CDisplayPlane::PopNextNodeFromDisplayList(void)
     if(!m_pNodeList[m_readerPos].isValid)
         return false;
 
-    m_ulStatus &= ~STM_PLANE_STATUS_QUEUE_FULL;
-
+    g_pIOS->Barrier();
     m_pNodeList[m_readerPos].isValid = false;
 
     m_readerPos++;
@@ -389,10 +394,13 @@ bool CDisplayPlane::AddToDisplayList(const stm_plane_node &newFrame)
     /*
      * This assumes that the only caller (QueueBuffer) has been locked
      * against re-enterancy. There is no need to lock this against the
-     * reader, that is the point of this scheme.
+     * reader, that is the point of this scheme: an entry belongs to the
+     * writer while it is not valid and to the reader once it is, so each
+     * side only ever writes the entries it owns.
      */
+    stm_plane_node * const entry = &m_pNodeList[m_writerPos];
 
-    if(m_pNodeList[m_writerPos].isValid)
+    if(entry->isValid)
     {
         /*
          * TODO, implement blocking stratergy
@@ -401,8 +409,16 @@ bool CDisplayPlane::AddToDisplayList(const stm_plane_node &newFrame)
         return false;
     }
 
-    m_pNodeList[m_writerPos] = newFrame;
-    m_pNodeList[m_writerPos].isValid = true;
+    /*
+     * Fill in the entry without touching its valid flag, then make it
+     * valid once the rest of it can be seen by the reader.
+     */
+    entry->dma_area     = newFrame.dma_area;
+    entry->info         = newFrame.info;
+    entry->nodeType     = newFrame.nodeType;
+    entry->useAltFields = newFrame.useAltFields;
+    g_pIOS->Barrier();
+    entry->isValid      = true;
 
     m_writerPos++;
     if(m_writerPos == m_ulNodeEntries)
@@ -410,17 +426,21 @@ bool CDisplayPlane::AddToDisplayList(const stm_plane_node &newFrame)
 
     /*
      * We have added a node to be displayed so we must be active and we
-     * automatically undo any paused state.
+     * automatically undo any paused state. The lock, which holds off the
+     * vsync handler, is only needed when that state changes; the barrier
+     * orders the test after the node was made valid, so a handler stopping
+     * the plane after the test has already seen the new node.
      */
-    g_pIOS->LockResource(m_lock);
-    m_isPaused = false;
-    m_isActive = true;
-    m_ulStatus &= ~STM_PLANE_STATUS_PAUSED;
-    m_ulStatus |= STM_PLANE_STATUS_ACTIVE;
-    if(m_pNodeList[m_writerPos].isValid)
-        m_ulStatus |= STM_PLANE_STATUS_QUEUE_FULL;
-
-    g_pIOS->UnlockResource(m_lock);
+    g_pIOS->Barrier();
+    if(!m_isActive || m_isPaused)
+    {
+        g_pIOS->LockResource(m_lock);
+        m_isPaused = false;
+        m_isActive = true;
+        m_ulStatus &= ~STM_PLANE_STATUS_PAUSED;
+        m_ulStatus |= STM_PLANE_STATUS_ACTIVE;
+        g_pIOS->UnlockResource(m_lock);
+    }
 
     g_pIOS->CheckDMAAreaGuards(&m_NodeListArea);
 
@@ -469,7 +489,7 @@ void CDisplayPlane::UpdateCurrentNode(const TIME64 &vsyncTime)
             if(m_previousNode.info.pCompletedCallback)
             {
                 m_previousNode.info.stats.vsyncTime = vsyncTime;
-                m_previousNode.info.stats.ulStatus |= m_ulStatus;
+                m_previousNode.info.stats.ulStatus |= GetStatus();
                 m_previousNode.info.pCompletedCallback(m_previousNode.info.pUserData,
                                                        &m_previousNode.info.stats);
             }
@@ -495,7 +515,7 @@ void CDisplayPlane::UpdateCurrentNode(const TIME64 &vsyncTime)
             if(m_currentNode.info.pCompletedCallback)
             {
                 m_currentNode.info.stats.vsyncTime = vsyncTime;
-                m_currentNode.info.stats.ulStatus |= m_ulStatus;
+                m_currentNode.info.stats.ulStatus |= GetStatus();
                 m_currentNode.info.pCompletedCallback(m_currentNode.info.pUserData,
                                                       &m_currentNode.info.stats);
             }
@@ -575,7 +595,7 @@ void CDisplayPlane::Pause(bool bFlushQueue)
     {
         if(frame.info.pCompletedCallback)
         {
-            frame.info.stats.ulStatus = m_ulStatus;
+            frame.info.stats.ulStatus = GetStatus();
             frame.info.pCompletedCallback(frame.info.pUserData, 0);
         }
 
@@ -651,7 +671,7 @@ void CDisplayPlane::Flush(void)
     {
         if(m_previousNode.info.pCompletedCallback)
         {
-            m_previousNode.info.stats.ulStatus |= m_ulStatus;
+            m_previousNode.info.stats.ulStatus |= GetStatus();
             m_previousNode.info.pCompletedCallback(m_previousNode.info.pUserData, 0);
         }
 
@@ -663,7 +683,7 @@ void CDisplayPlane::Flush(void)
     {
         if(m_currentNode.info.pCompletedCallback)
         {
-            m_currentNode.info.stats.ulStatus |= m_ulStatus;
+            m_currentNode.info.stats.ulStatus |= GetStatus();
             m_currentNode.info.pCompletedCallback(m_currentNode.info.pUserData, 0);
         }
 
@@ -679,7 +699,7 @@ void CDisplayPlane::Flush(void)
              * Note that this never got onto the display, so we do not preserve
              * anything in the stats status field.
              */
-            m_pendingNode.info.stats.ulStatus = m_ulStatus;
+            m_pendingNode.info.stats.ulStatus = GetStatus();
             m_pendingNode.info.pCompletedCallback(m_pendingNode.info.pUserData, 0);
         }
 
@@ -691,7 +711,7 @@ void CDisplayPlane::Flush(void)
     {
         if(frame.info.pCompletedCallback)
         {
-            frame.info.stats.ulStatus = m_ulStatus;
+            frame.info.stats.ulStatus = GetStatus();
             frame.info.pCompletedCallback(frame.info.pUserData, 0);
         }
 
@@ -47,7 +47,7 @@ public:
 
     stm_plane_id_t GetID(void)       const { return m_planeID; }
     ULONG          GetTimingID(void) const { return m_ulTimingID; }
-    ULONG          GetStatus(void)   const { return m_ulStatus; }
+    ULONG          GetStatus(void)   const;
 
     virtual bool LockUse(void *user);
     virtual void Unlock (void *user);
@@ -176,6 +176,20 @@ protected:
 };
 
 
+/*
+ * The queue full state is worked out from the node list rather than kept in
+ * m_ulStatus, so that neither the writer nor the vsync handler has to update
+ * the status when queueing or taking a node.
+ */
+inline ULONG CDisplayPlane::GetStatus(void) const
+{
+  if(m_pNodeList && m_pNodeList[m_writerPos].isValid)
+    return m_ulStatus | STM_PLANE_STATUS_QUEUE_FULL;
+
+  return m_ulStatus;
+}
+
+
 inline LONG CDisplayPlane::ValToFixedPoint(LONG val, int multiple) const
 {
     /*
@@ -37,6 +37,30 @@ public:
   virtual bool DrawRect          (const  stm_blitter_operation_t&, const stm_rect_t&) = 0;
   virtual bool CopyRect          (const  stm_blitter_operation_t&, const stm_rect_t&, const stm_point_t&) = 0;
   virtual bool CopyRectComplex   (const  stm_blitter_operation_t&, const stm_rect_t&, const stm_rect_t&)  = 0;
+
+  ////////////////////////////////////////////////////////////
+  // Batched drawing interfaces, one operation applied to a list of
+  // rectangles. Blitters that can queue a list more cheaply than one
+  // operation at a time override these.
+  virtual bool FillRects(const stm_blitter_operation_t &op, const stm_rect_t *dst, int count)
+  {
+    for(int i = 0; i < count; i++)
+    {
+      if(!FillRect(op, dst[i]))
+        return false;
+    }
+    return true;
+  }
+
+  virtual bool CopyRects(const stm_blitter_operation_t &op, const stm_rect_t *dst, const stm_point_t *src, int count)
+  {
+    for(int i = 0; i < count; i++)
+    {
+      if(!CopyRect(op, dst[i], src[i]))
+        return false;
+    }
+    return true;
+  }
 };
 
 #endif
@@ -24,6 +24,12 @@
  * The presentation timing can be adjusted on a per queue basis to be an integer
  * number of vsyncs early to allow for hardware programming that is only taken
  * into account on the next vsync.
+ *
+ * The queue is a heap ordered by presentation time, so entries do not have to
+ * be queued in time order and the entry due next is always at the top, which
+ * is all the vsync handler has to look at. Entries with no presentation time
+ * sort before all timed entries and entries with equal times keep the order
+ * they were queued in.
  */
 CMetaDataQueue::CMetaDataQueue(stm_meta_data_type_t type,
                                ULONG                ulQSize,
@@ -38,8 +44,8 @@ CMetaDataQueue::CMetaDataQueue(stm_meta_data_type_t type,
   m_pParent     = 0;
   m_bIsBusy     = false;
   m_bIsEnabled  = false;
-  m_ulWriterPos = 0;
-  m_ulReaderPos = 0;
+  m_ulCount     = 0;
+  m_ulSequence  = 0;
 
   g_pIOS->ZeroMemory(&m_QueueArea,sizeof(DMA_Area));
 
@@ -72,7 +78,7 @@ bool CMetaDataQueue::Create(void)
 
   DEBUGF2(2,("%s: queue size = %lu \n",__PRETTY_FUNCTION__,m_ulQSize));
 
-  g_pIOS->AllocateDMAArea(&m_QueueArea, (m_ulQSize * sizeof(stm_meta_data_t*)), 0, SDAAF_NONE);
+  g_pIOS->AllocateDMAArea(&m_QueueArea, (m_ulQSize * sizeof(QueueEntry)), 0, SDAAF_NONE);
 
   if(!m_QueueArea.pMemory)
   {
@@ -82,7 +88,7 @@ bool CMetaDataQueue::Create(void)
 
   g_pIOS->MemsetDMAArea(&m_QueueArea, 0, 0, m_QueueArea.ulDataSize);
 
-  m_pQueue = (stm_meta_data_s**)m_QueueArea.pData;
+  m_pQueue = (QueueEntry*)m_QueueArea.pData;
 
   DEXIT();
   return true;
@@ -151,7 +157,7 @@ stm_meta_data_result_t CMetaDataQueue::Queue(stm_meta_data_t *m)
     }
   }
 
-  DEBUGF2(3,(FENTRY "@ %p: type = %d m_ulWriterPos = %lu \n",__PRETTY_FUNCTION__,this,(int)m_type,m_ulWriterPos));
+  DEBUGF2(3,(FENTRY "@ %p: type = %d m_ulCount = %lu \n",__PRETTY_FUNCTION__,this,(int)m_type,m_ulCount));
 
   /*
    * Unlike queuing buffers on planes, we might have multiple writers so we
@@ -159,7 +165,7 @@ stm_meta_data_result_t CMetaDataQueue::Queue(stm_meta_data_t *m)
    */
   g_pIOS->LockResource(m_lock);
 
-  if(UNLIKELY(m_bIsBusy || (m_pQueue[m_ulWriterPos] != 0)))
+  if(UNLIKELY(m_bIsBusy || (m_ulCount == m_ulQSize)))
   {
     g_pIOS->UnlockResource(m_lock);
     DERROR("Queue busy or full\n");
@@ -168,9 +174,9 @@ stm_meta_data_result_t CMetaDataQueue::Queue(stm_meta_data_t *m)
 
   stm_meta_data_addref(m);
 
-  m_pQueue[m_ulWriterPos++] = m;
-  if(m_ulWriterPos == m_ulQSize)
-    m_ulWriterPos = 0;
+  m_pQueue[m_ulCount].m          = m;
+  m_pQueue[m_ulCount].ulSequence = m_ulSequence++;
+  SiftUp(m_ulCount++);
 
   g_pIOS->UnlockResource(m_lock);
 
@@ -185,21 +191,84 @@ void CMetaDataQueue::Flush(void)
 {
   DENTRY();
 
-  g_pIOS->LockResource(m_lock);
+  /*
+   * Wait for a range flush already walking the heap, it is short and
+   * Stop() relies on the queue being empty when we return.
+   */
+  for(;;)
+  {
+    g_pIOS->LockResource(m_lock);
+    if(!m_bIsBusy)
+      break;
+
+    g_pIOS->UnlockResource(m_lock);
+    g_pIOS->StallExecution(10);
+  }
   m_bIsBusy    = true;
   m_bIsEnabled = false;
   g_pIOS->UnlockResource(m_lock);
 
-  stm_meta_data_t *tmp;
-  while((tmp = m_pQueue[m_ulReaderPos])!= 0)
+  /*
+   * Neither Queue nor Pop touch the heap while we are busy, so the entries
+   * can be released without holding the lock.
+   */
+  while(m_ulCount > 0)
+  {
+    m_ulCount--;
+    stm_meta_data_release(m_pQueue[m_ulCount].m);
+    m_pQueue[m_ulCount].m = 0;
+  }
+
+  m_bIsBusy = false;
+  DEXIT();
+}
+
+
+/*
+ * Release the entries with presentation times in [startTime,endTime], leaving
+ * the rest of the queue as it is.
+ */
+void CMetaDataQueue::Flush(TIME64 startTime, TIME64 endTime)
+{
+  ULONG i,n;
+
+  DENTRY();
+
+  g_pIOS->LockResource(m_lock);
+  if(m_bIsBusy)
   {
-    m_pQueue[m_ulReaderPos++] = 0;
-    if(m_ulReaderPos == m_ulQSize)
-      m_ulReaderPos = 0;
+    g_pIOS->UnlockResource(m_lock);
+    DEXIT();
+    return;
+  }
+  m_bIsBusy = true;
+  g_pIOS->UnlockResource(m_lock);
 
-    stm_meta_data_release(tmp);
+  for(i=0,n=0;i<m_ulCount;i++)
+  {
+    if((m_pQueue[i].m->presentationTime >= startTime) &&
+       (m_pQueue[i].m->presentationTime <= endTime))
+    {
+      DEBUGF2(3,("%s: releasing entry @ %lld\n",__PRETTY_FUNCTION__,m_pQueue[i].m->presentationTime));
+      stm_meta_data_release(m_pQueue[i].m);
+    }
+    else
+    {
+      m_pQueue[n++] = m_pQueue[i];
+    }
   }
 
+  for(i=n;i<m_ulCount;i++)
+    m_pQueue[i].m = 0;
+
+  m_ulCount = n;
+
+  /*
+   * Re-establish the heap order over what is left
+   */
+  for(i=n/2;i>0;i--)
+    SiftDown(i-1);
+
   m_bIsBusy = false;
   DEXIT();
 }
@@ -216,12 +285,14 @@ stm_meta_data_t *CMetaDataQueue::Pop(void)
 
   g_pIOS->LockResource(m_lock);
 
-  if(!m_bIsEnabled || !(tmp = m_pQueue[m_ulReaderPos]))
+  if(!m_bIsEnabled || m_bIsBusy || (m_ulCount == 0))
   {
     g_pIOS->UnlockResource(m_lock);
     return 0;
   }
 
+  tmp = m_pQueue[0].m;
+
   if((tmp->presentationTime != 0LL) &&
      (tmp->presentationTime > (m_pParent->GetCurrentVSyncTime()+offset)))
   {
@@ -229,14 +300,58 @@ stm_meta_data_t *CMetaDataQueue::Pop(void)
     return 0;
   }
 
-  DEBUGF2(3,(FENTRY "@ %p: type = %d m_ulReaderPos = %lu presentation time = %lld\n",__PRETTY_FUNCTION__,this,(int)m_type,m_ulReaderPos,tmp->presentationTime));
+  DEBUGF2(3,(FENTRY "@ %p: type = %d m_ulCount = %lu presentation time = %lld\n",__PRETTY_FUNCTION__,this,(int)m_type,m_ulCount,tmp->presentationTime));
 
-  m_pQueue[m_ulReaderPos++] = 0;
-  if(m_ulReaderPos == m_ulQSize)
-    m_ulReaderPos = 0;
+  m_ulCount--;
+  m_pQueue[0] = m_pQueue[m_ulCount];
+  m_pQueue[m_ulCount].m = 0;
+  if(m_ulCount > 1)
+    SiftDown(0);
 
   g_pIOS->UnlockResource(m_lock);
 
   return tmp;
 }
 
+
+void CMetaDataQueue::SiftUp(ULONG pos)
+{
+  QueueEntry e = m_pQueue[pos];
+
+  while(pos > 0)
+  {
+    ULONG parent = (pos-1)/2;
+    if(!IsEarlier(e,m_pQueue[parent]))
+      break;
+
+    m_pQueue[pos] = m_pQueue[parent];
+    pos = parent;
+  }
+
+  m_pQueue[pos] = e;
+}
+
+
+void CMetaDataQueue::SiftDown(ULONG pos)
+{
+  QueueEntry e = m_pQueue[pos];
+
+  for(;;)
+  {
+    ULONG child = (pos*2)+1;
+    if(child >= m_ulCount)
+      break;
+
+    if(((child+1) < m_ulCount) && IsEarlier(m_pQueue[child+1],m_pQueue[child]))
+      child++;
+
+    if(!IsEarlier(m_pQueue[child],e))
+      break;
+
+    m_pQueue[pos] = m_pQueue[child];
+    pos = child;
+  }
+
+  m_pQueue[pos] = e;
+}
+
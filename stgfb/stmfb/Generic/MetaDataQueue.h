@@ -28,9 +28,20 @@ public:
   stm_meta_data_result_t Queue(stm_meta_data_t *);
   stm_meta_data_t       *Pop(void);
   void Flush(void);
+  void Flush(TIME64 startTime, TIME64 endTime);
 
 
 private:
+  /*
+   * Entries are held in a heap ordered by presentation time, the sequence
+   * number keeps entries with the same time in the order they were queued.
+   */
+  struct QueueEntry
+  {
+    stm_meta_data_t *m;
+    ULONG            ulSequence;
+  };
+
   stm_meta_data_type_t m_type;
 
   ULONG    m_lock;
@@ -41,11 +52,22 @@ private:
   volatile bool m_bIsBusy;
   volatile bool m_bIsEnabled;
 
-  ULONG    m_ulWriterPos;
-  ULONG    m_ulReaderPos;
+  ULONG    m_ulCount;
+  ULONG    m_ulSequence;
+
+  DMA_Area    m_QueueArea;
+  QueueEntry *m_pQueue;
+
+  bool IsEarlier(const QueueEntry &a, const QueueEntry &b) const
+  {
+    if(a.m->presentationTime != b.m->presentationTime)
+      return (a.m->presentationTime < b.m->presentationTime);
+
+    return ((LONG)(a.ulSequence - b.ulSequence) < 0);
+  }
 
-  DMA_Area m_QueueArea;
-  stm_meta_data_t **m_pQueue;
+  void SiftUp(ULONG pos);
+  void SiftDown(ULONG pos);
 };
 
 #endif /* _METADATA_QUEUE_H */
@@ -435,6 +435,8 @@ stm_meta_data_result_t COutput::QueueMetadata(stm_meta_data_t *) { return STM_ME
 
 void COutput::FlushMetadata(stm_meta_data_type_t) {}
 
+void COutput::FlushMetadataRange(stm_meta_data_type_t, TIME64, TIME64) {}
+
 void COutput::UpdateHW() {}
 
 void COutput::SetClockReference(stm_clock_ref_frequency_t refClock, int error_ppm) {}
@@ -666,6 +668,23 @@ static int flush_metadata(stm_display_output_t *output, stm_meta_data_type_t typ
 }
 
 
+static int flush_metadata_range(stm_display_output_t *output, stm_meta_data_type_t type, TIME64 startTime, TIME64 endTime)
+{
+  COutput *pOut =(COutput *)(output->handle);
+
+  DEBUGF2(3,("%s: output = %p\n",__FUNCTION__,output));
+
+  if(g_pIOS->DownSemaphore(output->lock) != 0)
+    return -1;
+
+  pOut->FlushMetadataRange(type, startTime, endTime);
+
+  g_pIOS->UpSemaphore(output->lock);
+
+  return 0;
+}
+
+
 static int enable_background(stm_display_output_t *output)
 {
   COutput *pOut =(COutput *)(output->handle);
@@ -874,7 +893,9 @@ stm_display_output_ops_t stm_display_output_ops = {
   GetDisplayStatus       : get_display_status,
   SetDisplayStatus       : set_display_status,
 
-  Release                : release_output
+  Release                : release_output,
+
+  FlushMetadataRange     : flush_metadata_range
 };
 
 } // extern "C"
@@ -57,6 +57,7 @@ public:
 
   virtual stm_meta_data_result_t QueueMetadata(stm_meta_data_t *);
   virtual void FlushMetadata(stm_meta_data_type_t);
+  virtual void FlushMetadataRange(stm_meta_data_type_t, TIME64 startTime, TIME64 endTime);
 
   virtual bool SetFilterCoefficients(const stm_display_filter_setup_t *);
 
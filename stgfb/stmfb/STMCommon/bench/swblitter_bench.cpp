@@ -0,0 +1,307 @@
+/***********************************************************************
+ *
+ * File: STMCommon/bench/swblitter_bench.cpp
+ * Copyright (c) 2026 STMicroelectronics Limited.
+ *
+ * This file is subject to the terms and conditions of the GNU General Public
+ * License.  See the file COPYING in the main directory of this archive for
+ * more details.
+ *
+ * Host regression test and benchmark for the CPU blitter. Each case runs
+ * an operation with CSTmSWBlitter and with a plain per pixel reference on
+ * a copy of the same memory, and checks that the whole of the memory is
+ * identical afterwards, so writes outside the rectangle are caught too.
+ * The benchmark then times full screen OSD fills, copies and blends.
+ *
+\***********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <stmdisplay.h>
+
+#include <Generic/IOS.h>
+#include <Generic/IDebug.h>
+
+#include <STMCommon/stmswblitter.h>
+
+/* The blitter is given a window, so never maps memory through the IOS */
+IOS    *g_pIOS    = 0;
+IDebug *g_pIDebug = 0;
+
+static const int   WIDTH      = 1280;
+static const int   HEIGHT     = 720;
+static const int   STRIDE     = WIDTH * 4;
+static const int   SURFACES   = 3;
+static const ULONG PHYS_BASE  = 0x40000000;
+static const ULONG ARENA_SIZE = STRIDE * HEIGHT * SURFACES;
+static const int   PASSES     = 10;
+
+static unsigned char *arena;
+static unsigned char *reference;
+
+static stm_blitter_surface_t Surface(int n, SURF_FMT format, int bpp)
+{
+  stm_blitter_surface_t surf;
+
+  memset(&surf, 0, sizeof(surf));
+  surf.ulMemory = PHYS_BASE + (n * STRIDE * HEIGHT);
+  surf.ulSize   = STRIDE * HEIGHT;
+  surf.ulWidth  = WIDTH;
+  surf.ulHeight = HEIGHT;
+  surf.ulStride = WIDTH * bpp;
+  surf.format   = format;
+  return surf;
+}
+
+static unsigned char *RefPixel(const stm_blitter_surface_t &surf, ULONG x, ULONG y, int bpp)
+{
+  return reference + (surf.ulMemory - PHYS_BASE) + (y * surf.ulStride) + (x * bpp);
+}
+
+static ULONG RefRead(const unsigned char *p, int bpp)
+{
+  ULONG v = 0;
+  for(int i = 0; i < bpp; i++)
+    v |= (ULONG)p[i] << (i * 8);
+  return v;
+}
+
+static void RefWrite(unsigned char *p, int bpp, ULONG v)
+{
+  for(int i = 0; i < bpp; i++)
+    p[i] = v >> (i * 8);
+}
+
+/* 565 to 8888 with the missing bits padded from the top of each channel */
+static ULONG Ref565ToARGB(ULONG v)
+{
+  ULONG r = (v >> 11) & 0x1f, g = (v >> 5) & 0x3f, b = v & 0x1f;
+  return 0xff000000 | (((r << 3) | (r >> 2)) << 16) | (((g << 2) | (g >> 4)) << 8) | ((b << 3) | (b >> 2));
+}
+
+static ULONG RefARGBTo565(ULONG v)
+{
+  return (((v >> 19) & 0x1f) << 11) | (((v >> 10) & 0x3f) << 5) | ((v >> 3) & 0x1f);
+}
+
+static ULONG RefBlend(ULONG s, ULONG d)
+{
+  ULONG a   = s >> 24;
+  ULONG out = (a + (((d >> 24) * (255 - a)) + 127) / 255) << 24;
+
+  for(int shift = 0; shift < 24; shift += 8)
+  {
+    ULONG sc = (s >> shift) & 0xff, dc = (d >> shift) & 0xff;
+    out |= (((sc * a) + (dc * (255 - a)) + 127) / 255) << shift;
+  }
+  return out;
+}
+
+/* As for the hardware the key is a range on each RGB component */
+static bool RefKeyed(ULONG s, ULONG low, ULONG high)
+{
+  for(int shift = 0; shift < 24; shift += 8)
+  {
+    ULONG c = (s >> shift) & 0xff;
+    if((c < ((low >> shift) & 0xff)) || (c > ((high >> shift) & 0xff)))
+      return false;
+  }
+  return true;
+}
+
+/*
+ * The reference for all the cases: a fill when src is 0, otherwise a copy
+ * of the same sized source, read in full before writing so overlapping
+ * copies have the memmove result.
+ */
+static void RefOperation(const stm_blitter_operation_t &op, const stm_rect_t &dst, const stm_point_t *src, int sbpp, int dbpp)
+{
+  ULONG w = dst.right - dst.left, h = dst.bottom - dst.top;
+  ULONG *srcpixels = new ULONG[w * h];
+
+  for(ULONG y = 0; y < h; y++)
+    for(ULONG x = 0; x < w; x++)
+      srcpixels[(y * w) + x] = src ? RefRead(RefPixel(op.srcSurface, src->x + x, src->y + y, sbpp), sbpp) : op.ulColour;
+
+  for(ULONG y = 0; y < h; y++)
+  {
+    for(ULONG x = 0; x < w; x++)
+    {
+      unsigned char *dp = RefPixel(op.dstSurface, dst.left + x, dst.top + y, dbpp);
+      ULONG s = srcpixels[(y * w) + x];
+      ULONG d = RefRead(dp, dbpp);
+      SURF_FMT sformat = src ? op.srcSurface.format : op.colourFormat;
+
+      if((op.ulFlags & STM_BLITTER_FLAGS_SRC_COLOR_KEY) && RefKeyed(s, op.ulColorKeyLow, op.ulColorKeyHigh))
+        continue;
+
+      if((sformat == SURF_RGB565) && (op.dstSurface.format == SURF_ARGB8888))
+        s = Ref565ToARGB(s);
+      else if((sformat == SURF_ARGB8888) && (op.dstSurface.format == SURF_RGB565))
+        s = RefARGBTo565(s);
+
+      if(op.ulFlags & STM_BLITTER_FLAGS_BLEND_SRC_ALPHA)
+        s = RefBlend(s, d);
+      else if(op.ulFlags & STM_BLITTER_FLAGS_XOR)
+        s ^= d;
+
+      RefWrite(dp, dbpp, s);
+    }
+  }
+
+  delete [] srcpixels;
+}
+
+struct TestCase
+{
+  const char *name;
+  SURF_FMT    srcFormat;
+  int         sbpp;
+  SURF_FMT    dstFormat;
+  int         dbpp;
+  ULONG       flags;
+  int         srcSurface; /* -1 for a fill */
+  stm_rect_t  dst;
+  stm_point_t src;
+};
+
+static const TestCase cases[] =
+{
+  { "fill ARGB8888",           SURF_ARGB8888, 4, SURF_ARGB8888, 4, STM_BLITTER_FLAGS_NONE, -1, { 3, 5, 1001, 700 }, { 0, 0 } },
+  { "fill RGB888",             SURF_RGB888,   3, SURF_RGB888,   3, STM_BLITTER_FLAGS_NONE, -1, { 1, 2, 999, 301 },  { 0, 0 } },
+  { "fill RGB565",             SURF_RGB565,   2, SURF_RGB565,   2, STM_BLITTER_FLAGS_NONE, -1, { 7, 9, 1277, 719 }, { 0, 0 } },
+  { "fill CLUT8",              SURF_CLUT8,    1, SURF_CLUT8,    1, STM_BLITTER_FLAGS_NONE, -1, { 5, 0, 1279, 10 },  { 0, 0 } },
+  { "fill ARGB8888 to RGB565", SURF_ARGB8888, 4, SURF_RGB565,   2, STM_BLITTER_FLAGS_NONE, -1, { 2, 2, 640, 360 },  { 0, 0 } },
+  { "fill XOR ARGB8888",       SURF_ARGB8888, 4, SURF_ARGB8888, 4, STM_BLITTER_FLAGS_XOR,  -1, { 0, 0, 500, 200 },  { 0, 0 } },
+  { "copy ARGB8888",           SURF_ARGB8888, 4, SURF_ARGB8888, 4, STM_BLITTER_FLAGS_NONE,  1, { 9, 4, 1200, 600 }, { 13, 17 } },
+  { "copy RGB888",             SURF_RGB888,   3, SURF_RGB888,   3, STM_BLITTER_FLAGS_NONE,  1, { 1, 1, 901, 501 },  { 2, 3 } },
+  { "copy overlap down right", SURF_ARGB8888, 4, SURF_ARGB8888, 4, STM_BLITTER_FLAGS_NONE,  0, { 20, 30, 820, 630 }, { 10, 10 } },
+  { "copy overlap up left",    SURF_RGB565,   2, SURF_RGB565,   2, STM_BLITTER_FLAGS_NONE,  0, { 10, 10, 811, 611 }, { 21, 33 } },
+  { "copy same row right",     SURF_ARGB8888, 4, SURF_ARGB8888, 4, STM_BLITTER_FLAGS_NONE,  0, { 40, 50, 600, 51 },  { 3, 50 } },
+  { "copy src colour key",     SURF_ARGB8888, 4, SURF_ARGB8888, 4, STM_BLITTER_FLAGS_SRC_COLOR_KEY, 1, { 0, 0, 700, 400 }, { 5, 5 } },
+  { "copy blend src alpha",    SURF_ARGB8888, 4, SURF_ARGB8888, 4, STM_BLITTER_FLAGS_BLEND_SRC_ALPHA, 1, { 4, 4, 1004, 504 }, { 0, 0 } },
+  { "copy RGB565 to ARGB8888", SURF_RGB565,   2, SURF_ARGB8888, 4, STM_BLITTER_FLAGS_NONE,  1, { 3, 3, 803, 403 },  { 1, 2 } },
+};
+
+static stm_blitter_operation_t Operation(const TestCase &c)
+{
+  stm_blitter_operation_t op;
+
+  memset(&op, 0, sizeof(op));
+  op.ulFlags      = c.flags;
+  op.dstSurface   = Surface(0, c.dstFormat, c.dbpp);
+  op.srcSurface   = Surface((c.srcSurface < 0) ? 0 : c.srcSurface, c.srcFormat, c.sbpp);
+  op.ulColour     = (c.sbpp == 4) ? 0x80a05a33 : (c.sbpp == 3) ? 0x00a05a33 : (c.sbpp == 2) ? 0xa5a3 : 0x5a;
+  op.colourFormat = c.srcFormat;
+  /* the key covers a range of blue values of the random source */
+  op.ulColorKeyLow  = 0x00000000;
+  op.ulColorKeyHigh = 0xffffff40;
+  return op;
+}
+
+static double Now(void)
+{
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return (double)t.tv_sec + ((double)t.tv_nsec / 1e9);
+}
+
+static bool Run(CSTmSWBlitter &blitter, const TestCase &c)
+{
+  stm_blitter_operation_t op = Operation(c);
+  bool ok;
+
+  for(ULONG i = 0; i < ARENA_SIZE; i++)
+    arena[i] = rand();
+
+  memcpy(reference, arena, ARENA_SIZE);
+
+  if(c.srcSurface < 0)
+  {
+    ok = blitter.FillRect(op, c.dst);
+    RefOperation(op, c.dst, 0, c.sbpp, c.dbpp);
+  }
+  else
+  {
+    ok = blitter.CopyRect(op, c.dst, c.src);
+    RefOperation(op, c.dst, &c.src, c.sbpp, c.dbpp);
+  }
+
+  if(!ok)
+  {
+    printf("%-26s FAILED, operation refused\n", c.name);
+    return false;
+  }
+
+  for(ULONG i = 0; i < ARENA_SIZE; i++)
+  {
+    if(arena[i] != reference[i])
+    {
+      printf("%-26s MISMATCH at byte %lu, %02x expected %02x\n", c.name, i, arena[i], reference[i]);
+      return false;
+    }
+  }
+
+  printf("%-26s ok\n", c.name);
+  return true;
+}
+
+static void Bench(CSTmSWBlitter &blitter, const TestCase &c)
+{
+  stm_blitter_operation_t op = Operation(c);
+  double start, swtime, reftime;
+
+  start = Now();
+  for(int pass = 0; pass < PASSES; pass++)
+  {
+    if(c.srcSurface < 0)
+      blitter.FillRect(op, c.dst);
+    else
+      blitter.CopyRect(op, c.dst, c.src);
+  }
+  swtime = (Now() - start) / PASSES;
+
+  start = Now();
+  for(int pass = 0; pass < PASSES; pass++)
+    RefOperation(op, c.dst, (c.srcSurface < 0) ? 0 : &c.src, c.sbpp, c.dbpp);
+  reftime = (Now() - start) / PASSES;
+
+  printf("%-26s reference %8.3f ms  blitter %8.3f ms  (%.2fx)\n", c.name,
+         reftime * 1000.0, swtime * 1000.0, reftime / swtime);
+}
+
+int main(void)
+{
+  static const TestCase osd[] =
+  {
+    { "OSD fill 1280x720",       SURF_ARGB8888, 4, SURF_ARGB8888, 4, STM_BLITTER_FLAGS_NONE, -1, { 0, 0, WIDTH, HEIGHT }, { 0, 0 } },
+    { "OSD copy 1280x720",       SURF_ARGB8888, 4, SURF_ARGB8888, 4, STM_BLITTER_FLAGS_NONE,  1, { 0, 0, WIDTH, HEIGHT }, { 0, 0 } },
+    { "OSD blend 1280x720",      SURF_ARGB8888, 4, SURF_ARGB8888, 4, STM_BLITTER_FLAGS_BLEND_SRC_ALPHA, 1, { 0, 0, WIDTH, HEIGHT }, { 0, 0 } },
+  };
+  int failures = 0;
+
+  arena     = (unsigned char *)malloc(ARENA_SIZE);
+  reference = (unsigned char *)malloc(ARENA_SIZE);
+  if(!arena || !reference)
+  {
+    printf("out of memory\n");
+    return 1;
+  }
+
+  CSTmSWBlitter blitter(PHYS_BASE, arena, ARENA_SIZE);
+
+  for(unsigned i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    failures += Run(blitter, cases[i]) ? 0 : 1;
+
+  printf("\n%d passes per operation\n", PASSES);
+  for(unsigned i = 0; i < sizeof(osd) / sizeof(osd[0]); i++)
+    Bench(blitter, osd[i]);
+
+  free(arena);
+  free(reference);
+
+  return (failures == 0) ? 0 : 1;
+}
@@ -286,14 +286,16 @@ CSTmBDispAQ::~CSTmBDispAQ()
 
 
 /*
- * This function commits the node offset at m_Shared->next_free to the
- * blitter for execution.
+ * This function commits the nNodes nodes from the offset at
+ * m_Shared->next_free to the blitter for execution. The nodes must have been
+ * reserved with ReserveNodes(), so they are contiguous in memory.
  */
-void CSTmBDispAQ::CommitBlitOperation(void)
+void CSTmBDispAQ::CommitBlitOperation(ULONG nNodes)
 {
-  unsigned long new_last_valid = m_Shared->nodes_phys + m_Shared->next_free;
+  ULONG last_node = m_Shared->next_free + ((nNodes - 1) * BLIT_NODE_SIZE);
+  unsigned long new_last_valid = m_Shared->nodes_phys + last_node;
 
-  DEBUGF2(3,("%s node offset = 0x%08lx\n",__PRETTY_FUNCTION__,m_Shared->next_free));
+  DEBUGF2(3,("%s node offset = 0x%08lx nodes = %lu\n",__PRETTY_FUNCTION__,m_Shared->next_free,nNodes));
 
   /* the following code serves two purposes - a) we need a memory barrier,
      which is accomplished by reading back the memory just written to, and
@@ -307,7 +309,7 @@ void CSTmBDispAQ::CommitBlitOperation(void)
   volatile struct stm_bdisp_aq_fast_blit_node * const node
     = (volatile struct stm_bdisp_aq_fast_blit_node *)(m_SharedAreaDMA.pData
                                                       + m_NodeOffset
-                                                      + m_Shared->next_free);
+                                                      + last_node);
   /*
    * Force cache refill of first word of node and hope the compiler doesn't
    * optimise it out.
@@ -316,7 +318,8 @@ void CSTmBDispAQ::CommitBlitOperation(void)
 
   DEBUGF2(3,("%s nip = 0x%08lx\n",__PRETTY_FUNCTION__,nip));
 
-  if (UNLIKELY (! ++m_Shared->num_ops_lo))
+  m_Shared->num_ops_lo += nNodes;
+  if (UNLIKELY (m_Shared->num_ops_lo < nNodes))
     ++m_Shared->num_ops_hi;
 
   /* signal to irq handler that we are in the process of updating
@@ -669,6 +672,41 @@ CSTmBDispAQ::GetNewNode(void)
 }
 
 
+/*
+ * Reserve up to nNodes nodes from m_Shared->next_free on, waiting for at
+ * least one to be free. The reservation stops at the end of the node list
+ * so the nodes are contiguous in memory, can be written in place and
+ * flushed from the cache in one go before a single CommitBlitOperation().
+ * Returns the number of nodes reserved, 0 if the wait was interrupted.
+ * Must be called with the lock held.
+ */
+int
+CSTmBDispAQ::ReserveNodes(int nNodes)
+{
+  ULONG ringSize = m_ulBufferNodes * BLIT_NODE_SIZE;
+  ULONG nFree;
+  ULONG nToEnd;
+
+  if(m_Shared->last_free == m_Shared->next_free)
+  {
+    /* doesn't need to be atomic, it's for statistics only anyway... */
+    m_Shared->num_wait_next++;
+
+    g_pIOS->SleepOnQueue(BLIT_NODE_QUEUE,
+                         &m_Shared->last_free,m_Shared->next_free,
+                         STMIOS_WAIT_COND_NOT_EQUAL);
+  }
+
+  nFree  = ((m_Shared->last_free + ringSize - m_Shared->next_free) % ringSize) / BLIT_NODE_SIZE;
+  nToEnd = (ringSize - m_Shared->next_free) / BLIT_NODE_SIZE;
+
+  if(nFree > nToEnd)
+    nFree = nToEnd;
+
+  return ((ULONG)nNodes < nFree) ? nNodes : nFree;
+}
+
+
 bool CSTmBDispAQ::FillRect(const stm_blitter_operation_t &op, const stm_rect_t &dst)
 {
   bool retval = false;
@@ -774,6 +812,85 @@ out:
 }
 
 
+/*
+ * Batched fills. Only the simple solid fill using the 64bit fast path is
+ * set up in place in the node list, a run of nodes at a time with one
+ * flush and one commit; other fills are queued one at a time.
+ */
+bool CSTmBDispAQ::FillRects(const stm_blitter_operation_t &op, const stm_rect_t *dst, int count)
+{
+  bool  retval = true;
+  int   done   = 0;
+  ULONG tty;
+
+  DEBUGF2(2, ("%s @ %p: colour %.8lx %d rects\n", __PRETTY_FUNCTION__, this, op.ulColour, count));
+
+  if (op.ulFlags != STM_BLITTER_FLAGS_NONE
+      || (op.colourFormat != op.dstSurface.format)
+      || (op.colourFormat == SURF_YCBCR422R)
+      || (op.colourFormat == SURF_YUYV))
+  {
+    return CSTmBlitter::FillRects(op, dst, count);
+  }
+
+  if(!SetBufferType(op.dstSurface,&tty))
+  {
+    DEBUGF2(1, ("%s invalid destination type\n",__PRETTY_FUNCTION__));
+    return false;
+  }
+
+  LOCK_ATOMIC;
+
+  while(done < count)
+  {
+    int nNodes = ReserveNodes(count - done);
+    int nUsed  = 0;
+
+    if(nNodes == 0)
+    {
+      retval = false;
+      break;
+    }
+
+    char * const pNodes = m_SharedAreaDMA.pData + m_NodeOffset + m_Shared->next_free;
+
+    for(int i = 0; i < nNodes; i++, done++)
+    {
+      if ((dst[done].left == dst[done].right) && (dst[done].top == dst[done].bottom))
+        continue;
+
+      stm_bdisp_aq_fast_blit_node * const pBlitNode
+        = reinterpret_cast<stm_bdisp_aq_fast_blit_node *>(pNodes + (nUsed * BLIT_NODE_SIZE));
+
+      pBlitNode->BLT_TTY  = tty;
+      pBlitNode->BLT_TBA  = op.dstSurface.ulMemory;
+      SetXY(dst[done].left, dst[done].top, &(pBlitNode->BLT_TXY));
+      pBlitNode->BLT_TSZ  = (((dst[done].bottom - dst[done].top) & 0x0FFF) << 16) | ((dst[done].right - dst[done].left) & 0x0FFF);
+      pBlitNode->BLT_S1XY = pBlitNode->BLT_TXY;
+      pBlitNode->BLT_S1TY = tty & ~BLIT_TY_BIG_ENDIAN;
+      pBlitNode->BLT_S1CF = op.ulColour;
+      pBlitNode->BLT_CIC  = BLIT_FAST_NODE_CIC;
+      pBlitNode->BLT_INS  = BLIT_INS_SRC1_MODE_DIRECT_FILL;
+
+      nUsed++;
+    }
+
+    if(nUsed)
+    {
+      if (!(m_SharedAreaDMA.ulFlags & SDAAF_UNCACHED))
+        g_pIOS->FlushCache(pNodes, nUsed * BLIT_NODE_SIZE);
+      CommitBlitOperation(nUsed);
+    }
+  }
+
+  UNLOCK_ATOMIC;
+
+  DEBUGF2(2, ("%s completed.\n",__PRETTY_FUNCTION__));
+
+  return retval;
+}
+
+
 bool CSTmBDispAQ::DrawRect(const stm_blitter_operation_t &op, const stm_rect_t &dst)
 {
   int nodesize;
@@ -902,22 +1019,12 @@ bool CSTmBDispAQ::DrawRect(const stm_blitter_operation_t &op, const stm_rect_t &
 }
 
 
-bool CSTmBDispAQ::CopyRect(const stm_blitter_operation_t &op,
-                           const stm_rect_t              &dst,
-                           const stm_point_t             &src)
+bool CSTmBDispAQ::CopyRectSetupFastNode(const stm_blitter_operation_t &op,
+                                        const stm_rect_t              &dst,
+                                        const stm_point_t             &src,
+                                        stm_bdisp_aq_fast_blit_node   *pBlitNode)
 {
   bool copyDirReversed;
-  bool retval = false;
-
-  DEBUGF2(2, ("%s @ %p: src x/y: %lu/%lu dst l/r/t/b: %lu/%lu/%lu/%lu\n",
-              __PRETTY_FUNCTION__, this,
-              src.x, src.y, dst.left, dst.right, dst.top, dst.bottom));
-
-  if ((dst.left == dst.right) && (dst.top == dst.bottom))
-    return false;
-
-  stm_bdisp_aq_fast_blit_node * const pBlitNode
-    = static_cast<stm_bdisp_aq_fast_blit_node *>(GetNewNode());
 
   pBlitNode->BLT_CIC = BLIT_FAST_NODE_CIC;
 
@@ -928,14 +1035,14 @@ bool CSTmBDispAQ::CopyRect(const stm_blitter_operation_t &op,
   if(!SetBufferType(op.srcSurface,&(pBlitNode->BLT_S1TY)))
   {
     DEBUGF2(1, ("%s invalid source type\n",__PRETTY_FUNCTION__));
-    goto out;
+    return false;
   }
 
   // Set target type
   if(!SetBufferType(op.dstSurface,&(pBlitNode->BLT_TTY)))
   {
     DEBUGF2(1, ("%s invalid destination type\n",__PRETTY_FUNCTION__));
-    goto out;
+    return false;
   }
 
   /* there is some problem when doing a fast blit of that surface type, just
@@ -980,6 +1087,29 @@ bool CSTmBDispAQ::CopyRect(const stm_blitter_operation_t &op,
   pBlitNode->BLT_TSZ = (((dst.bottom - dst.top) & 0x0FFF) << 16) |
                         ((dst.right - dst.left) & 0x0FFF);
 
+  return true;
+}
+
+
+bool CSTmBDispAQ::CopyRect(const stm_blitter_operation_t &op,
+                           const stm_rect_t              &dst,
+                           const stm_point_t             &src)
+{
+  bool retval = false;
+
+  DEBUGF2(2, ("%s @ %p: src x/y: %lu/%lu dst l/r/t/b: %lu/%lu/%lu/%lu\n",
+              __PRETTY_FUNCTION__, this,
+              src.x, src.y, dst.left, dst.right, dst.top, dst.bottom));
+
+  if ((dst.left == dst.right) && (dst.top == dst.bottom))
+    return false;
+
+  stm_bdisp_aq_fast_blit_node * const pBlitNode
+    = static_cast<stm_bdisp_aq_fast_blit_node *>(GetNewNode());
+
+  if(!CopyRectSetupFastNode(op, dst, src, pBlitNode))
+    goto out;
+
   if (!(m_SharedAreaDMA.ulFlags & SDAAF_UNCACHED))
     g_pIOS->FlushCache(pBlitNode, sizeof(stm_bdisp_aq_fast_blit_node));
   CommitBlitOperation();
@@ -995,6 +1125,69 @@ out:
 }
 
 
+/*
+ * Batched plain copies. The nodes are set up in place in the node list,
+ * as many at a time as ReserveNodes() gives us, and each run is flushed
+ * and committed once.
+ */
+bool CSTmBDispAQ::CopyRects(const stm_blitter_operation_t &op,
+                            const stm_rect_t              *dst,
+                            const stm_point_t             *src,
+                            int                            count)
+{
+  bool retval = true;
+  int  done   = 0;
+
+  DEBUGF2(2, ("%s @ %p: %d rects\n", __PRETTY_FUNCTION__, this, count));
+
+  LOCK_ATOMIC;
+
+  while(retval && (done < count))
+  {
+    int nNodes = ReserveNodes(count - done);
+    int nUsed  = 0;
+
+    if(nNodes == 0)
+    {
+      retval = false;
+      break;
+    }
+
+    char * const pNodes = m_SharedAreaDMA.pData + m_NodeOffset + m_Shared->next_free;
+
+    for(int i = 0; i < nNodes; i++, done++)
+    {
+      if ((dst[done].left == dst[done].right) && (dst[done].top == dst[done].bottom))
+        continue;
+
+      stm_bdisp_aq_fast_blit_node * const pBlitNode
+        = reinterpret_cast<stm_bdisp_aq_fast_blit_node *>(pNodes + (nUsed * BLIT_NODE_SIZE));
+
+      if(!CopyRectSetupFastNode(op, dst[done], src[done], pBlitNode))
+      {
+        retval = false;
+        break;
+      }
+
+      nUsed++;
+    }
+
+    if(nUsed)
+    {
+      if (!(m_SharedAreaDMA.ulFlags & SDAAF_UNCACHED))
+        g_pIOS->FlushCache(pNodes, nUsed * BLIT_NODE_SIZE);
+      CommitBlitOperation(nUsed);
+    }
+  }
+
+  UNLOCK_ATOMIC;
+
+  DEBUGF2(2, ("%s completed.\n",__PRETTY_FUNCTION__));
+
+  return retval;
+}
+
+
 void CSTmBDispAQ::FilteringSetup (int                      hsrcinc,
                                   int                      vsrcinc,
                                   union _BltNodeGroup0910 &filter,
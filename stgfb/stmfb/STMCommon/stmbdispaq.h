@@ -150,6 +150,10 @@ public:
   bool CopyRect       (const stm_blitter_operation_t&, const stm_rect_t&, const stm_point_t&);
   bool CopyRectComplex(const stm_blitter_operation_t&, const stm_rect_t&, const stm_rect_t&);
 
+  // Batched drawing functions
+  bool FillRects      (const stm_blitter_operation_t&, const stm_rect_t *, int);
+  bool CopyRects      (const stm_blitter_operation_t&, const stm_rect_t *, const stm_point_t *, int);
+
 protected:
   ULONG  m_drawOps;
   ULONG  m_copyOps;
@@ -163,7 +167,8 @@ private:
   bool SetPlaneMask     (stm_bdisp_aq_fast_blit_node *pBlitNodeCommon, const stm_blitter_operation_t &op, ULONG &pmk, ULONG cicupdate);
 
   void *GetNewNode(void);
-  void CommitBlitOperation(void);
+  int   ReserveNodes(int nNodes);
+  void CommitBlitOperation(ULONG nNodes = 1);
   void QueueBlitOperation(void *blitNode, int size);
   void QueueBlitOperation_locked(void *blitNode, int size);
 
@@ -192,6 +197,11 @@ private:
                            bool                          &bRequiresSpans,
                            bool                          &bCopyDirReversed);
 
+  bool CopyRectSetupFastNode(const stm_blitter_operation_t &op,
+                             const stm_rect_t              &dst,
+                             const stm_point_t             &src,
+                             stm_bdisp_aq_fast_blit_node   *pBlitNode);
+
   bool CopyRectFromRLE    (const stm_blitter_operation_t&, const stm_rect_t&);
 
   bool YCbCrNodePrepare (const stm_blitter_operation_t &op,
@@ -1571,6 +1571,21 @@ void CSTmDENC::FlushMetadata(stm_meta_data_type_t type)
 }
 
 
+/*
+ * Teletext is held in the teletext node ring rather than a metadata queue,
+ * so only the picture information can be flushed by time.
+ */
+void CSTmDENC::FlushMetadataRange(stm_meta_data_type_t type, TIME64 startTime, TIME64 endTime)
+{
+  DENTRY();
+
+  if(type == STM_METADATA_TYPE_PICTURE_INFO)
+    m_pPictureInfoQueue->Flush(startTime, endTime);
+
+  DEXIT();
+}
+
+
 void CSTmDENC::UpdateHW(stm_field_t sync)
 {
   stm_meta_data_t *m;
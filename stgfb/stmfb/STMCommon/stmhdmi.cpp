@@ -1530,3 +1530,9 @@ void CSTmHDMI::FlushMetadata(stm_meta_data_type_t type)
   m_pIFrameManager->FlushMetadata(type);
 }
 
+
+void CSTmHDMI::FlushMetadataRange(stm_meta_data_type_t type, TIME64 startTime, TIME64 endTime)
+{
+  m_pIFrameManager->FlushMetadataRange(type, startTime, endTime);
+}
+
@@ -27,7 +27,7 @@
  * on its transmission. However the processing of this slot is only done in
  * the hardware specific implementation that can support it.
  */
-static const int max_transmission_slots     = 6;
+static const int max_transmission_slots     = STM_IFRAME_MAX_SLOTS;
 static const int Gamut_transmission_slot    = 0; /* mutually exclusive with ISRC1 */
 static const int ISRC1_transmission_slot    = 0;
 static const int Audio_transmission_slot    = 1;
@@ -96,6 +96,9 @@ CSTmIFrameManager::CSTmIFrameManager(CDisplayDevice *pDev,
 
   m_bISRCTransmissionInProgress = false;
 
+  g_pIOS->ZeroMemory(m_slotFrames,sizeof(m_slotFrames));
+  m_ulSlotFramesValid = 0;
+
   DEXIT();
 }
 
@@ -157,9 +160,9 @@ void CSTmIFrameManager::SetDefaultAudioFrame(void)
   audio_frame.version = HDMI_AUDIO_INFOFRAME_VERSION;
   audio_frame.length  = HDMI_AUDIO_INFOFRAME_LENGTH;
   InfoFrameChecksum(&audio_frame);
-  WriteInfoFrame(Audio_transmission_slot,&audio_frame);
 
   g_pIOS->LockResource(m_ulLock);
+  UpdateTransmissionSlot(Audio_transmission_slot,&audio_frame);
   DisableTransmissionSlot(Audio_transmission_slot);
   g_pIOS->UnlockResource(m_ulLock);
 
@@ -234,9 +237,23 @@ bool CSTmIFrameManager::Start(const stm_mode_line_t* pModeLine, ULONG tvStandard
   m_nACPTransmissionFrameDelay = (int)((UTIME64)250000/(UTIME64)COutput::GetFieldOrFrameDurationFromMode(pModeLine));
   DEBUGF2(2,("CSTmIFrameManager::Start - ACP transmission delay = %d\n",m_nACPTransmissionFrameDelay));
 
+  /*
+   * The hardware has been reset so nothing we wrote to it before can be
+   * relied on. Build the AVI frame for the new mode here rather than at the
+   * first vsync, so it goes out with the first frame of the new mode.
+   */
+  g_pIOS->LockResource(m_ulLock);
+
+  m_ulSlotFramesValid = 0;
   m_pCurrentMode = pModeLine;
   m_ulTVStandard = tvStandard;
 
+  ProgramAVIFrame();
+  UpdateTransmissionSlot(AVI_transmission_slot,&m_AVIFrame);
+  m_bAVIFrameNeedsUpdate = false;
+
+  g_pIOS->UnlockResource(m_ulLock);
+
   DEXIT();
   return true;
 }
@@ -319,7 +336,7 @@ void CSTmIFrameManager::UpdateFrame(void)
   {
     DEBUGF2(3,("%s: Creating new AVI Frame\n",__PRETTY_FUNCTION__));
     ProgramAVIFrame();
-    WriteInfoFrame(AVI_transmission_slot,&m_AVIFrame);
+    UpdateTransmissionSlot(AVI_transmission_slot,&m_AVIFrame);
     m_bAVIFrameNeedsUpdate = false;
   }
 
@@ -331,8 +348,7 @@ void CSTmIFrameManager::UpdateFrame(void)
   if(m_pAudioQueue && ((m = m_pAudioQueue->Pop()) != 0))
   {
     stm_hdmi_info_frame_t *i = (stm_hdmi_info_frame_t*)&m->data[0];
-    InfoFrameChecksum(i);
-    WriteInfoFrame(Audio_transmission_slot,i);
+    UpdateTransmissionSlot(Audio_transmission_slot,i);
 
     DEBUGF2(3,("%s: Updated Audio Frame\n",__PRETTY_FUNCTION__));
 
@@ -376,13 +392,12 @@ void CSTmIFrameManager::UpdateFrame(void)
   if(m_nACPTransmissionCount == m_nACPTransmissionFrameDelay)
   {
     m_nACPTransmissionCount = 0;
-    WriteInfoFrame(Muxed_transmission_slot,&m_ACPFrame);
+    UpdateTransmissionSlot(Muxed_transmission_slot,&m_ACPFrame);
   }
   else if(m_pSPDQueue && ((m = m_pSPDQueue->Pop()) != 0))
   {
     stm_hdmi_info_frame_t *i = (stm_hdmi_info_frame_t*)&m->data[0];
-    InfoFrameChecksum(i);
-    WriteInfoFrame(Muxed_transmission_slot,i);
+    UpdateTransmissionSlot(Muxed_transmission_slot,i);
 
     DEBUGF2(4,("%s: Send SPD Frame\n",__PRETTY_FUNCTION__));
 
@@ -391,8 +406,7 @@ void CSTmIFrameManager::UpdateFrame(void)
   else if(m_pVendorQueue && ((m = m_pVendorQueue->Pop()) != 0))
   {
     stm_hdmi_info_frame_t *i = (stm_hdmi_info_frame_t*)&m->data[0];
-    InfoFrameChecksum(i);
-    WriteInfoFrame(Muxed_transmission_slot,i);
+    UpdateTransmissionSlot(Muxed_transmission_slot,i);
     stm_meta_data_release(m);
   }
   else
@@ -431,10 +445,10 @@ void CSTmIFrameManager::UpdateFrame(void)
     else
     {
       DEBUGF2(4,("%s: Sending new ISRC Frame\n",__PRETTY_FUNCTION__));
-      WriteInfoFrame(ISRC1_transmission_slot,&i->isrc1);
+      UpdateTransmissionSlot(ISRC1_transmission_slot,&i->isrc1);
 
       if(i->isrc1.version & HDMI_ISRC1_CONTINUED)
-        WriteInfoFrame(ISRC2_transmission_slot,&i->isrc2);
+        UpdateTransmissionSlot(ISRC2_transmission_slot,&i->isrc2);
       else
         DisableTransmissionSlot(ISRC2_transmission_slot);
 
@@ -453,8 +467,7 @@ void CSTmIFrameManager::UpdateFrame(void)
   if(m_pNTSCQueue && ((m = m_pNTSCQueue->Pop()) != 0))
   {
     stm_hdmi_info_frame_t *i = (stm_hdmi_info_frame_t*)&m->data[0];
-    InfoFrameChecksum(i);
-    WriteInfoFrame(NTSC_transmission_slot,i);
+    UpdateTransmissionSlot(NTSC_transmission_slot,i);
     stm_meta_data_release(m);
   }
   else
@@ -711,6 +724,38 @@ void CSTmIFrameManager::ProgramAVIFrame(void)
 }
 
 
+void CSTmIFrameManager::UpdateTransmissionSlot(int transmissionSlot,stm_hdmi_info_frame_t *frame)
+{
+  stm_hdmi_info_frame_t *last;
+  int i;
+
+  if(transmissionSlot >= max_transmission_slots)
+    return;
+
+  last = &m_slotFrames[transmissionSlot];
+
+  if((m_ulSlotFramesValid & (1L<<transmissionSlot)) &&
+     (last->type    == frame->type)    &&
+     (last->version == frame->version) &&
+     (last->length  == frame->length))
+  {
+    for(i=0;(i<(int)sizeof(frame->data)) && (last->data[i] == frame->data[i]);i++);
+
+    if(i == (int)sizeof(frame->data))
+    {
+      DEBUGF2(4,("%s: Slot %d unchanged\n",__PRETTY_FUNCTION__,transmissionSlot));
+      EnableTransmissionSlot(transmissionSlot);
+      return;
+    }
+  }
+
+  WriteInfoFrame(transmissionSlot,frame);
+
+  *last = *frame;
+  m_ulSlotFramesValid |= (1L<<transmissionSlot);
+}
+
+
 void CSTmIFrameManager::InfoFrameChecksum(stm_hdmi_info_frame_t *frame)
 {
 UCHAR sum;
@@ -783,6 +828,22 @@ stm_meta_data_result_t CSTmIFrameManager::QueueMetadata(stm_meta_data_t *m)
   /*
    * TODO, validate that some basics about each IFrame data is correct
    */
+  switch(m->type)
+  {
+    case STM_METADATA_TYPE_AUDIO_IFRAME:
+    case STM_METADATA_TYPE_SPD_IFRAME:
+    case STM_METADATA_TYPE_VENDOR_IFRAME:
+    case STM_METADATA_TYPE_NTSC_IFRAME:
+      /*
+       * Do the checksums now rather than in the vsync handler, which then
+       * only has to compare the frames it dequeues with what it last sent.
+       */
+      InfoFrameChecksum((stm_hdmi_info_frame_t*)&m->data[0]);
+      break;
+    default:
+      break;
+  }
+
   switch(m->type)
   {
     case STM_METADATA_TYPE_PICTURE_INFO:
@@ -925,6 +986,54 @@ void CSTmIFrameManager::FlushMetadata(stm_meta_data_type_t type)
 }
 
 
+
+/*
+ * Only the queued entries in the range are released, the frames already
+ * being transmitted carry on as they are.
+ */
+void CSTmIFrameManager::FlushMetadataRange(stm_meta_data_type_t type, TIME64 startTime, TIME64 endTime)
+{
+  CMetaDataQueue *queue;
+
+  DENTRY();
+
+  switch(type)
+  {
+    case STM_METADATA_TYPE_PICTURE_INFO:
+      queue = m_pPictureInfoQueue;
+      break;
+    case STM_METADATA_TYPE_AUDIO_IFRAME:
+      queue = m_pAudioQueue;
+      break;
+    case STM_METADATA_TYPE_ISRC_DATA:
+      queue = m_pISRCQueue;
+      break;
+    case STM_METADATA_TYPE_ACP_DATA:
+      queue = m_pACPQueue;
+      break;
+    case STM_METADATA_TYPE_SPD_IFRAME:
+      queue = m_pSPDQueue;
+      break;
+    case STM_METADATA_TYPE_VENDOR_IFRAME:
+      queue = m_pVendorQueue;
+      break;
+    case STM_METADATA_TYPE_COLOR_GAMUT_DATA:
+      queue = m_pGamutQueue;
+      break;
+    case STM_METADATA_TYPE_NTSC_IFRAME:
+      queue = m_pNTSCQueue;
+      break;
+    default:
+      queue = 0;
+      break;
+  }
+
+  if(queue)
+    queue->Flush(startTime, endTime);
+
+  DEXIT();
+}
+
 /******************************************************************************/
 
 /*
@@ -12,6 +12,8 @@
 #ifndef _STM_IFRAME_MANAGER_H
 #define _STM_IFRAME_MANAGER_H
 
+#define STM_IFRAME_MAX_SLOTS 6
+
 class CMetaDataQueue;
 class CSTmHDMI;
 class COutput;
@@ -36,6 +38,7 @@ public:
 
   stm_meta_data_result_t QueueMetadata(stm_meta_data_t *);
   void FlushMetadata(stm_meta_data_type_t);
+  void FlushMetadataRange(stm_meta_data_type_t, TIME64 startTime, TIME64 endTime);
 
   virtual void UpdateFrame(void);
   virtual void SendFirstInfoFrame(void) = 0;
@@ -106,10 +109,20 @@ protected:
   const stm_mode_line_t*m_pCurrentMode;
   ULONG                 m_ulTVStandard;
 
+  /*
+   * The last frame written to each transmission slot, so a frame that has
+   * not changed only needs its slot enabling again.
+   */
+  stm_hdmi_info_frame_t m_slotFrames[STM_IFRAME_MAX_SLOTS];
+  ULONG                 m_ulSlotFramesValid;
+
   virtual void WriteInfoFrame(int transmissionSlot,stm_hdmi_info_frame_t *) = 0;
   virtual void EnableTransmissionSlot(int transmissionSlot) = 0;
   virtual void DisableTransmissionSlot(int transmissionSlot) = 0;
 
+  void UpdateTransmissionSlot(int transmissionSlot,stm_hdmi_info_frame_t *);
+  void InvalidateTransmissionSlot(int transmissionSlot) { m_ulSlotFramesValid &= ~(1L<<transmissionSlot); }
+
   void ProgramAVIFrame(void);
   void InfoFrameChecksum(stm_hdmi_info_frame_t *);
   void PrintInfoFrame(stm_hdmi_info_frame_t *);
@@ -769,3 +769,14 @@ void CSTmMasterOutput::FlushMetadata(stm_meta_data_type_t type)
 
   DEXIT();
 }
+
+
+void CSTmMasterOutput::FlushMetadataRange(stm_meta_data_type_t type, TIME64 startTime, TIME64 endTime)
+{
+  DENTRY();
+
+  if((type == STM_METADATA_TYPE_PICTURE_INFO) && m_pDENC && m_bUsingDENC)
+    m_pDENC->FlushMetadataRange(type, startTime, endTime);
+
+  DEXIT();
+}
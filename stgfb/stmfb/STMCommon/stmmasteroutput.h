@@ -52,6 +52,7 @@ public:
 
   stm_meta_data_result_t QueueMetadata(stm_meta_data_t *);
   void FlushMetadata(stm_meta_data_type_t);
+  void FlushMetadataRange(stm_meta_data_type_t, TIME64 startTime, TIME64 endTime);
 
   bool  SetFilterCoefficients(const stm_display_filter_setup_t *);
 
@@ -0,0 +1,728 @@
+/***********************************************************************
+ *
+ * File: STMCommon/stmswblitter.cpp
+ * Copyright (c) 2026 STMicroelectronics Limited.
+ *
+ * This file is subject to the terms and conditions of the GNU General Public
+ * License.  See the file COPYING in the main directory of this archive for
+ * more details.
+ *
+\***********************************************************************/
+
+#include <stmdisplay.h>
+
+#include <Generic/IOS.h>
+#include <Generic/IDebug.h>
+
+#include "stmswblitter.h"
+
+
+/*
+ * Pixel format helpers. Pixels are handled as their raw value, read little
+ * endian from memory, or expanded to 32bit ARGB with the missing LSBs
+ * padded from the MSBs, matching the expansion the hardware uses.
+ */
+static int BytesPerPixel(SURF_FMT format)
+{
+  switch(format)
+  {
+    case SURF_CLUT8:
+    case SURF_A8:
+      return 1;
+    case SURF_RGB565:
+    case SURF_ARGB1555:
+    case SURF_ARGB4444:
+      return 2;
+    case SURF_RGB888:
+    case SURF_ARGB8565:
+      return 3;
+    case SURF_ARGB8888:
+    case SURF_BGRA8888:
+      return 4;
+    default:
+      return 0;
+  }
+}
+
+
+static inline bool HasARGB(SURF_FMT format)
+{
+  return (format != SURF_CLUT8) && (BytesPerPixel(format) != 0);
+}
+
+
+static inline ULONG ReadRaw(const UCHAR *p, int bpp)
+{
+  switch(bpp)
+  {
+    case 1:
+      return *p;
+    case 2:
+      return *(const USHORT *)p;
+    case 3:
+      return p[0] | (p[1] << 8) | (p[2] << 16);
+    default:
+      return *(const unsigned int *)p;
+  }
+}
+
+
+static inline void WriteRaw(UCHAR *p, int bpp, ULONG raw)
+{
+  switch(bpp)
+  {
+    case 1:
+      *p = raw;
+      break;
+    case 2:
+      *(USHORT *)p = raw;
+      break;
+    case 3:
+      p[0] = raw;
+      p[1] = raw >> 8;
+      p[2] = raw >> 16;
+      break;
+    default:
+      *(unsigned int *)p = raw;
+      break;
+  }
+}
+
+
+static inline ULONG Expand5(ULONG v) { return (v << 3) | (v >> 2); }
+static inline ULONG Expand6(ULONG v) { return (v << 2) | (v >> 4); }
+static inline ULONG Expand4(ULONG v) { return (v << 4) | v; }
+
+
+static ULONG ToARGB(ULONG raw, SURF_FMT format)
+{
+  switch(format)
+  {
+    case SURF_RGB565:
+      return 0xff000000 | (Expand5((raw >> 11) & 0x1f) << 16) | (Expand6((raw >> 5) & 0x3f) << 8) | Expand5(raw & 0x1f);
+    case SURF_ARGB8565:
+      return ((raw & 0xff0000) << 8) | (Expand5((raw >> 11) & 0x1f) << 16) | (Expand6((raw >> 5) & 0x3f) << 8) | Expand5(raw & 0x1f);
+    case SURF_ARGB1555:
+      return ((raw & 0x8000) ? 0xff000000 : 0) | (Expand5((raw >> 10) & 0x1f) << 16) | (Expand5((raw >> 5) & 0x1f) << 8) | Expand5(raw & 0x1f);
+    case SURF_ARGB4444:
+      return (Expand4((raw >> 12) & 0xf) << 24) | (Expand4((raw >> 8) & 0xf) << 16) | (Expand4((raw >> 4) & 0xf) << 8) | Expand4(raw & 0xf);
+    case SURF_RGB888:
+      return 0xff000000 | raw;
+    case SURF_A8:
+      return raw << 24;
+    case SURF_BGRA8888:
+      return (raw >> 24) | ((raw >> 8) & 0xff00) | ((raw << 8) & 0xff0000) | ((raw & 0xff) << 24);
+    case SURF_ARGB8888:
+    default:
+      return raw;
+  }
+}
+
+
+static ULONG FromARGB(ULONG argb, SURF_FMT format)
+{
+  ULONG a = argb >> 24;
+  ULONG r = (argb >> 16) & 0xff;
+  ULONG g = (argb >> 8) & 0xff;
+  ULONG b = argb & 0xff;
+
+  switch(format)
+  {
+    case SURF_RGB565:
+      return ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3);
+    case SURF_ARGB8565:
+      return (a << 16) | ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3);
+    case SURF_ARGB1555:
+      return ((a & 0x80) << 8) | ((r >> 3) << 10) | ((g >> 3) << 5) | (b >> 3);
+    case SURF_ARGB4444:
+      return ((a >> 4) << 12) | ((r >> 4) << 8) | ((g >> 4) << 4) | (b >> 4);
+    case SURF_RGB888:
+      return argb & 0x00ffffff;
+    case SURF_A8:
+      return a;
+    case SURF_BGRA8888:
+      return (argb >> 24) | ((argb >> 8) & 0xff00) | ((argb << 8) & 0xff0000) | ((argb & 0xff) << 24);
+    case SURF_ARGB8888:
+    default:
+      return argb;
+  }
+}
+
+
+/* x / 255 rounded, for x up to 255 * 255 */
+static inline ULONG Div255(ULONG x)
+{
+  x += 128;
+  return (x + (x >> 8)) >> 8;
+}
+
+
+/*
+ * The colour keys are ranges on each of the RGB components, as for the
+ * hardware. CLUT surfaces compare the index.
+ */
+static inline bool KeyMatch(ULONG raw, SURF_FMT format, ULONG low, ULONG high)
+{
+  if(!HasARGB(format))
+    return (raw >= low) && (raw <= high);
+
+  ULONG c = ToARGB(raw, format);
+
+  for(int shift = 0; shift < 24; shift += 8)
+  {
+    ULONG v = (c >> shift) & 0xff;
+    if((v < ((low >> shift) & 0xff)) || (v > ((high >> shift) & 0xff)))
+      return false;
+  }
+  return true;
+}
+
+
+/*
+ * Span kernels for the raw fast paths. These work a 32bit word at a time
+ * once the destination is word aligned, with the pixel value replicated
+ * across the word. Words are unsigned int so host builds with a 64bit
+ * ULONG get the same layout.
+ */
+static void FillSpan(UCHAR *d, ULONG raw, int bpp, ULONG count)
+{
+  switch(bpp)
+  {
+    case 1:
+    case 2:
+    {
+      ULONG word = (bpp == 1) ? (raw & 0xff) * 0x01010101 : (raw & 0xffff) * 0x00010001;
+      ULONG bytes = count * bpp;
+
+      while(((ULONG)d & 3) && bytes)
+      {
+        WriteRaw(d, bpp, raw);
+        d += bpp;
+        bytes -= bpp;
+      }
+      for(; bytes >= 16; bytes -= 16, d += 16)
+      {
+        ((unsigned int *)d)[0] = word;
+        ((unsigned int *)d)[1] = word;
+        ((unsigned int *)d)[2] = word;
+        ((unsigned int *)d)[3] = word;
+      }
+      for(; bytes >= 4; bytes -= 4, d += 4)
+        *(unsigned int *)d = word;
+      for(; bytes; bytes -= bpp, d += bpp)
+        WriteRaw(d, bpp, raw);
+      break;
+    }
+    case 3:
+    {
+      /* four pixels make three words */
+      ULONG w0 = (raw & 0xffffff) | (raw << 24);
+      ULONG w1 = ((raw >> 8) & 0xffff) | (raw << 16);
+      ULONG w2 = ((raw >> 16) & 0xff) | (raw << 8);
+
+      while(((ULONG)d & 3) && count)
+      {
+        WriteRaw(d, 3, raw);
+        d += 3;
+        count--;
+      }
+      for(; count >= 4; count -= 4, d += 12)
+      {
+        ((unsigned int *)d)[0] = w0;
+        ((unsigned int *)d)[1] = w1;
+        ((unsigned int *)d)[2] = w2;
+      }
+      for(; count; count--, d += 3)
+        WriteRaw(d, 3, raw);
+      break;
+    }
+    default:
+    {
+      unsigned int *p = (unsigned int *)d;
+
+      for(; count >= 4; count -= 4, p += 4)
+      {
+        p[0] = raw;
+        p[1] = raw;
+        p[2] = raw;
+        p[3] = raw;
+      }
+      for(; count; count--)
+        *p++ = raw;
+      break;
+    }
+  }
+}
+
+
+/* Copy bytes, coping with overlap like memmove */
+static void CopySpan(UCHAR *d, const UCHAR *s, ULONG bytes)
+{
+  bool words = (((ULONG)d & 3) == ((ULONG)s & 3));
+
+  if((d <= s) || (d >= (s + bytes)))
+  {
+    if(words)
+    {
+      while(((ULONG)d & 3) && bytes)
+      {
+        *d++ = *s++;
+        bytes--;
+      }
+      for(; bytes >= 16; bytes -= 16, d += 16, s += 16)
+      {
+        ULONG a = ((const unsigned int *)s)[0];
+        ULONG b = ((const unsigned int *)s)[1];
+        ULONG c = ((const unsigned int *)s)[2];
+        ULONG e = ((const unsigned int *)s)[3];
+        ((unsigned int *)d)[0] = a;
+        ((unsigned int *)d)[1] = b;
+        ((unsigned int *)d)[2] = c;
+        ((unsigned int *)d)[3] = e;
+      }
+      for(; bytes >= 4; bytes -= 4, d += 4, s += 4)
+        *(unsigned int *)d = *(const unsigned int *)s;
+    }
+    while(bytes--)
+      *d++ = *s++;
+  }
+  else
+  {
+    d += bytes;
+    s += bytes;
+    if(words)
+    {
+      while(((ULONG)d & 3) && bytes)
+      {
+        *--d = *--s;
+        bytes--;
+      }
+      for(; bytes >= 4; bytes -= 4)
+      {
+        d -= 4;
+        s -= 4;
+        *(unsigned int *)d = *(const unsigned int *)s;
+      }
+    }
+    while(bytes--)
+      *--d = *--s;
+  }
+}
+
+
+CSTmSWBlitter::CSTmSWBlitter(void)
+{
+  DEBUGF2(2, ("%s mapping surfaces per operation\n", __PRETTY_FUNCTION__));
+
+  m_ulPhysicalBase = 0;
+  m_pVirtualBase   = 0;
+  m_ulSize         = 0;
+}
+
+
+CSTmSWBlitter::CSTmSWBlitter(ULONG ulPhysicalBase, void *pVirtualBase, ULONG ulSize)
+{
+  DEBUGF2(2, ("%s phys = %#08lx virt = %p size = %lu\n", __PRETTY_FUNCTION__, ulPhysicalBase, pVirtualBase, ulSize));
+
+  m_ulPhysicalBase = ulPhysicalBase;
+  m_pVirtualBase   = static_cast<UCHAR *>(pVirtualBase);
+  m_ulSize         = ulSize;
+}
+
+
+CSTmSWBlitter::~CSTmSWBlitter() {}
+
+
+/*
+ * The physical addresses of the first pixel of the rectangle and the byte
+ * after its last pixel.
+ */
+static bool RectExtent(const stm_blitter_surface_t &surf, const stm_rect_t &rect, ULONG &first, ULONG &last)
+{
+  int bpp = BytesPerPixel(surf.format);
+
+  if(bpp == 0)
+  {
+    DEBUGF2(1, ("%s unsupported surface format %d\n", __PRETTY_FUNCTION__, surf.format));
+    return false;
+  }
+
+  if((rect.right <= rect.left) || (rect.bottom <= rect.top))
+    return false;
+
+  first = surf.ulMemory + (rect.top * surf.ulStride) + (rect.left * bpp);
+  last  = surf.ulMemory + ((rect.bottom - 1) * surf.ulStride) + (rect.right * bpp);
+
+  return (last > first);
+}
+
+
+/*
+ * Return where the physical range is mapped, or 0 if it lies outside the
+ * memory window. Without a window the range is mapped here and mapping
+ * is set, for UnmapRects to release once the operation is done.
+ */
+UCHAR *CSTmSWBlitter::MapExtent(ULONG first, ULONG last, void **mapping) const
+{
+  *mapping = 0;
+
+  if(m_ulSize != 0)
+  {
+    if((first < m_ulPhysicalBase) || (last > (m_ulPhysicalBase + m_ulSize)))
+    {
+      DEBUGF2(1, ("%s rectangle outside the blitter memory\n", __PRETTY_FUNCTION__));
+      return 0;
+    }
+
+    return m_pVirtualBase + (first - m_ulPhysicalBase);
+  }
+
+  if(!(*mapping = g_pIOS->MapMemory(first, last - first)))
+  {
+    DEBUGF2(1, ("%s failed to map %#08lx size %lu\n", __PRETTY_FUNCTION__, first, last - first));
+    return 0;
+  }
+
+  return static_cast<UCHAR *>(*mapping);
+}
+
+
+/*
+ * Map the top left pixels of the destination and, for copies, the source
+ * rectangles. A source on the destination surface shares one mapping with
+ * it, so the overlap checks of the copies compare consistent addresses.
+ */
+bool CSTmSWBlitter::MapRects(const stm_blitter_operation_t &op,
+                             const stm_rect_t              &dst,
+                             const stm_rect_t              *src,
+                             UCHAR                        **pDst,
+                             UCHAR                        **pSrc,
+                             void                          *mappings[2]) const
+{
+  ULONG dfirst, dlast, sfirst, slast;
+
+  mappings[0] = mappings[1] = 0;
+
+  if(!RectExtent(op.dstSurface, dst, dfirst, dlast))
+    return false;
+
+  if(!src)
+    return ((*pDst = MapExtent(dfirst, dlast, &mappings[0])) != 0);
+
+  if(!RectExtent(op.srcSurface, *src, sfirst, slast))
+    return false;
+
+  if(op.srcSurface.ulMemory == op.dstSurface.ulMemory)
+  {
+    ULONG  first = (sfirst < dfirst) ? sfirst : dfirst;
+    ULONG  last  = (slast > dlast) ? slast : dlast;
+    UCHAR *p     = MapExtent(first, last, &mappings[0]);
+
+    if(!p)
+      return false;
+
+    *pDst = p + (dfirst - first);
+    *pSrc = p + (sfirst - first);
+    return true;
+  }
+
+  if(!(*pDst = MapExtent(dfirst, dlast, &mappings[0]))
+     || !(*pSrc = MapExtent(sfirst, slast, &mappings[1])))
+  {
+    UnmapRects(mappings);
+    return false;
+  }
+
+  return true;
+}
+
+
+void CSTmSWBlitter::UnmapRects(void *mappings[2]) const
+{
+  for(int i = 0; i < 2; i++)
+  {
+    if(mappings[i])
+      g_pIOS->UnMapMemory(mappings[i]);
+  }
+}
+
+
+/*
+ * The general per pixel path, for fills (src == 0) and copies with colour
+ * keys, blending, XOR, plane masks, format conversion or rescaling. The
+ * source is stepped through in 16.16 fixed point, picking the nearest
+ * pixel when the sizes differ.
+ */
+bool CSTmSWBlitter::PixelOperation(const stm_blitter_operation_t &op,
+                                   const stm_rect_t              &dst,
+                                   const stm_rect_t              *src,
+                                   ULONG                          validOps)
+{
+  const ULONG blendOps = (STM_BLITTER_FLAGS_BLEND_SRC_ALPHA | STM_BLITTER_FLAGS_BLEND_SRC_ALPHA_PREMULT);
+  SURF_FMT dstFormat = op.dstSurface.format;
+  SURF_FMT srcFormat = src ? op.srcSurface.format : op.colourFormat;
+  int      dbpp      = BytesPerPixel(dstFormat);
+  int      sbpp      = BytesPerPixel(srcFormat);
+  bool     convert   = (srcFormat != dstFormat);
+  ULONG    ga        = (op.ulFlags & STM_BLITTER_FLAGS_GLOBAL_ALPHA) ? (op.ulGlobalAlpha & 0xff) : 0xff;
+  UCHAR   *pSrc     = 0;
+  UCHAR   *pDst     = 0;
+  void    *mappings[2];
+  ULONG    width, height;
+  ULONG    xstep = 0x10000, ystep = 0x10000;
+  int      xdir = 1, ydir = 1;
+
+  if(op.ulFlags & ~validOps)
+  {
+    DEBUGF2(1, ("%s operation flags not handled 0x%lx\n", __PRETTY_FUNCTION__, op.ulFlags));
+    return false;
+  }
+
+  if((op.ulFlags & STM_BLITTER_FLAGS_XOR) && (op.ulFlags & blendOps))
+  {
+    DEBUGF2(1, ("%s XOR and Blend is mutually exclusive\n", __PRETTY_FUNCTION__));
+    return false;
+  }
+
+  if(sbpp == 0 || ((convert || (op.ulFlags & blendOps)) && (!HasARGB(srcFormat) || !HasARGB(dstFormat))))
+  {
+    DEBUGF2(1, ("%s unsupported format combination %d -> %d\n", __PRETTY_FUNCTION__, srcFormat, dstFormat));
+    return false;
+  }
+
+  if(!MapRects(op, dst, src, &pDst, &pSrc, mappings))
+    return false;
+
+  width  = dst.right - dst.left;
+  height = dst.bottom - dst.top;
+
+  if(src)
+  {
+    xstep = ((src->right - src->left) << 16) / width;
+    ystep = ((src->bottom - src->top) << 16) / height;
+
+    /* work backwards through an overlapping copy on the same surface */
+    if((op.srcSurface.ulMemory == op.dstSurface.ulMemory) && (xstep == 0x10000) && (ystep == 0x10000))
+    {
+      if(dst.top > src->top)
+        ydir = -1;
+      else if((dst.top == src->top) && (dst.left > src->left))
+        xdir = -1;
+    }
+  }
+
+  ULONG colour = src ? 0 : op.ulColour;
+
+  for(ULONG j = 0; j < height; j++)
+  {
+    ULONG y = (ydir > 0) ? j : (height - 1 - j);
+    UCHAR *d = pDst + (y * op.dstSurface.ulStride);
+    const UCHAR *s = src ? pSrc + (((y * ystep) >> 16) * op.srcSurface.ulStride) : 0;
+
+    for(ULONG i = 0; i < width; i++)
+    {
+      ULONG x = (xdir > 0) ? i : (width - 1 - i);
+      ULONG sraw = src ? ReadRaw(s + (((x * xstep) >> 16) * sbpp), sbpp) : colour;
+      UCHAR *dp = d + (x * dbpp);
+      ULONG draw, out;
+
+      if((op.ulFlags & STM_BLITTER_FLAGS_SRC_COLOR_KEY)
+         && KeyMatch(sraw, srcFormat, op.ulColorKeyLow, op.ulColorKeyHigh))
+        continue;
+
+      draw = ReadRaw(dp, dbpp);
+
+      if((op.ulFlags & STM_BLITTER_FLAGS_DST_COLOR_KEY)
+         && !KeyMatch(draw, dstFormat, op.ulColorKeyLow, op.ulColorKeyHigh))
+        continue;
+
+      if(op.ulFlags & blendOps)
+      {
+        ULONG sc = ToARGB(sraw, srcFormat);
+        ULONG dc = ToARGB(draw, dstFormat);
+        ULONG a  = Div255((sc >> 24) * ga);
+        ULONG sf = (op.ulFlags & STM_BLITTER_FLAGS_BLEND_SRC_ALPHA) ? a : ga;
+        ULONG oc = a + Div255((dc >> 24) * (255 - a));
+
+        oc <<= 24;
+        for(int shift = 0; shift < 24; shift += 8)
+        {
+          ULONG c = Div255((((sc >> shift) & 0xff) * sf) + (((dc >> shift) & 0xff) * (255 - a)));
+          oc |= ((c > 0xff) ? 0xff : c) << shift;
+        }
+        out = FromARGB(oc, dstFormat);
+      }
+      else
+      {
+        out = convert ? FromARGB(ToARGB(sraw, srcFormat), dstFormat) : sraw;
+
+        if(op.ulFlags & STM_BLITTER_FLAGS_XOR)
+          out ^= draw;
+      }
+
+      if(op.ulFlags & STM_BLITTER_FLAGS_PLANE_MASK)
+        out = (out & op.ulPlanemask) | (draw & ~op.ulPlanemask);
+
+      WriteRaw(dp, dbpp, out);
+    }
+  }
+
+  UnmapRects(mappings);
+
+  return true;
+}
+
+
+bool CSTmSWBlitter::FillRect(const stm_blitter_operation_t &op, const stm_rect_t &dst)
+{
+  DEBUGF2(2, ("%s @ %p: colour %.8lx l/r/t/b: %lu/%lu/%lu/%lu\n",
+              __PRETTY_FUNCTION__, this,
+              op.ulColour, dst.left, dst.right, dst.top, dst.bottom));
+
+  if ((dst.left == dst.right) && (dst.top == dst.bottom))
+    return true;
+
+  if (op.ulFlags != STM_BLITTER_FLAGS_NONE)
+    return PixelOperation(op, dst, 0, SWBLIT_VALID_DRAW_OPS);
+
+  /*
+   * Simple solid fill, the colour is converted once and written a word at
+   * a time.
+   */
+  int    bpp  = BytesPerPixel(op.dstSurface.format);
+  ULONG  raw  = op.ulColour;
+  UCHAR *pDst = 0;
+  void  *mappings[2];
+
+  if(op.colourFormat != op.dstSurface.format)
+  {
+    if(!HasARGB(op.colourFormat) || !HasARGB(op.dstSurface.format))
+    {
+      DEBUGF2(1, ("%s invalid source colour format\n", __PRETTY_FUNCTION__));
+      return false;
+    }
+    raw = FromARGB(ToARGB(op.ulColour, op.colourFormat), op.dstSurface.format);
+  }
+
+  if(!MapRects(op, dst, 0, &pDst, 0, mappings))
+    return false;
+
+  for(ULONG y = dst.top; y < dst.bottom; y++, pDst += op.dstSurface.ulStride)
+    FillSpan(pDst, raw, bpp, dst.right - dst.left);
+
+  UnmapRects(mappings);
+
+  return true;
+}
+
+
+bool CSTmSWBlitter::DrawRect(const stm_blitter_operation_t &op, const stm_rect_t &dst)
+{
+  DEBUGF2(2, ("%s @ %p: colour %.8lx l/r/t/b: %lu/%lu/%lu/%lu\n",
+              __PRETTY_FUNCTION__, this,
+              op.ulColour, dst.left, dst.right, dst.top, dst.bottom));
+
+  if ((dst.left == dst.right) || (dst.top == dst.bottom))
+    return true;
+
+  /* the same four lines as the hardware draws, without overlaps */
+  stm_rect_t top    = { dst.left,      dst.top,        dst.right, dst.top + 1    };
+  stm_rect_t bottom = { dst.left,      dst.bottom - 1, dst.right, dst.bottom     };
+  stm_rect_t left   = { dst.left,      dst.top + 1,    dst.left + 1, dst.bottom - 1 };
+  stm_rect_t right  = { dst.right - 1, dst.top + 1,    dst.right, dst.bottom - 1 };
+
+  if(!FillRect(op, top))
+    return false;
+
+  if((dst.bottom - dst.top) < 2)
+    return true;
+
+  if(!FillRect(op, bottom))
+    return false;
+
+  if((dst.bottom - dst.top) > 2)
+  {
+    if(!FillRect(op, left))
+      return false;
+
+    if(((dst.right - dst.left) > 1) && !FillRect(op, right))
+      return false;
+  }
+
+  return true;
+}
+
+
+bool CSTmSWBlitter::CopyRect(const stm_blitter_operation_t &op,
+                             const stm_rect_t              &dst,
+                             const stm_point_t             &src)
+{
+  stm_rect_t srcrect = { src.x,
+                         src.y,
+                         src.x + (dst.right - dst.left),
+                         src.y + (dst.bottom - dst.top) };
+
+  DEBUGF2(2, ("%s @ %p: src x/y: %lu/%lu dst l/r/t/b: %lu/%lu/%lu/%lu\n",
+              __PRETTY_FUNCTION__, this,
+              src.x, src.y, dst.left, dst.right, dst.top, dst.bottom));
+
+  if ((dst.left == dst.right) && (dst.top == dst.bottom))
+    return false;
+
+  if ((op.ulFlags != STM_BLITTER_FLAGS_NONE) || (op.srcSurface.format != op.dstSurface.format))
+    return PixelOperation(op, dst, &srcrect, SWBLIT_VALID_COPY_OPS);
+
+  /*
+   * Plain copy, a row at a time. Rows of an overlapping copy within the
+   * same surface are done bottom up when moving down.
+   */
+  int    bpp   = BytesPerPixel(op.dstSurface.format);
+  UCHAR *pDst  = 0;
+  UCHAR *pSrc  = 0;
+  ULONG  bytes = (dst.right - dst.left) * bpp;
+  ULONG  rows  = dst.bottom - dst.top;
+  void  *mappings[2];
+
+  if(!MapRects(op, dst, &srcrect, &pDst, &pSrc, mappings))
+    return false;
+
+  if((op.srcSurface.ulMemory == op.dstSurface.ulMemory) && (dst.top > src.y))
+  {
+    pDst += (rows - 1) * op.dstSurface.ulStride;
+    pSrc += (rows - 1) * op.srcSurface.ulStride;
+    for(; rows; rows--, pDst -= op.dstSurface.ulStride, pSrc -= op.srcSurface.ulStride)
+      CopySpan(pDst, pSrc, bytes);
+  }
+  else
+  {
+    for(; rows; rows--, pDst += op.dstSurface.ulStride, pSrc += op.srcSurface.ulStride)
+      CopySpan(pDst, pSrc, bytes);
+  }
+
+  UnmapRects(mappings);
+
+  return true;
+}
+
+
+bool CSTmSWBlitter::CopyRectComplex(const stm_blitter_operation_t &op,
+                                    const stm_rect_t              &dst,
+                                    const stm_rect_t              &src)
+{
+  DEBUGF2(2, ("%s @ %p: src l/r/t/b: %lu/%lu/%lu/%lu dst l/r/t/b: %lu/%lu/%lu/%lu\n",
+              __PRETTY_FUNCTION__, this,
+              src.left, src.right, src.top, src.bottom,
+              dst.left, dst.right, dst.top, dst.bottom));
+
+  if ((dst.left == dst.right) || (dst.top == dst.bottom))
+    return false;
+
+  if (((src.right - src.left) == (dst.right - dst.left))
+      && ((src.bottom - src.top) == (dst.bottom - dst.top)))
+  {
+    stm_point_t srcLocation = { src.left, src.top };
+    return CopyRect(op, dst, srcLocation);
+  }
+
+  return PixelOperation(op, dst, &src, SWBLIT_VALID_COPY_OPS);
+}
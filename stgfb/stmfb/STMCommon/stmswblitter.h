@@ -0,0 +1,96 @@
+/***********************************************************************
+ *
+ * File: STMCommon/stmswblitter.h
+ * Copyright (c) 2026 STMicroelectronics Limited.
+ *
+ * This file is subject to the terms and conditions of the GNU General Public
+ * License.  See the file COPYING in the main directory of this archive for
+ * more details.
+ *
+\***********************************************************************/
+
+#ifndef _STM_SW_BLITTER_H
+#define _STM_SW_BLITTER_H
+
+#include <Generic/GAL.h>
+
+#define SWBLIT_VALID_DRAW_OPS  (0                                            \
+                                | STM_BLITTER_FLAGS_GLOBAL_ALPHA             \
+                                | STM_BLITTER_FLAGS_BLEND_SRC_ALPHA          \
+                                | STM_BLITTER_FLAGS_BLEND_SRC_ALPHA_PREMULT  \
+                                | STM_BLITTER_FLAGS_XOR                      \
+                                | STM_BLITTER_FLAGS_PLANE_MASK               \
+                                | STM_BLITTER_FLAGS_DST_COLOR_KEY            \
+                               )
+
+#define SWBLIT_VALID_COPY_OPS  (0                                            \
+                                | STM_BLITTER_FLAGS_SRC_COLOR_KEY            \
+                                | STM_BLITTER_FLAGS_DST_COLOR_KEY            \
+                                | STM_BLITTER_FLAGS_GLOBAL_ALPHA             \
+                                | STM_BLITTER_FLAGS_BLEND_SRC_ALPHA          \
+                                | STM_BLITTER_FLAGS_BLEND_SRC_ALPHA_PREMULT  \
+                                | STM_BLITTER_FLAGS_XOR                      \
+                                | STM_BLITTER_FLAGS_PLANE_MASK               \
+                               )
+
+/*
+ * A blitter running on the CPU. It implements the drawing operations for
+ * the RGB, alpha and 8bit CLUT surface formats, as a fallback for
+ * operations the hardware cannot do and so that drawing can be run and
+ * checked in host builds without a blitter.
+ *
+ * Surfaces are given by their physical address, as for the hardware. The
+ * blitter can be given one window of memory, the physical base address and
+ * size of the surface memory and where it is mapped, and then refuses
+ * operations on surfaces outside it. Without a window, as created by the
+ * devices when no hardware blitter is available, each operation maps the
+ * memory it touches through the IOS for its duration.
+ */
+class CSTmSWBlitter : public CGAL
+{
+public:
+  CSTmSWBlitter(void);
+  CSTmSWBlitter(ULONG ulPhysicalBase, void *pVirtualBase, ULONG ulSize);
+  ~CSTmSWBlitter();
+
+  // Operations are complete when the drawing calls return
+  bool IsEngineBusy(void)              { return false; }
+  int  SyncChip(bool WaitNextOnly)     { return 0; }
+
+  bool HandleBlitterInterrupt(void)    { return false; }
+
+  STMFBBDispSharedAreaPriv *GetSharedArea (void) { return 0; }
+
+  ULONG GetBlitLoad (void)             { return 0; }
+
+  // Drawing functions
+  bool FillRect       (const stm_blitter_operation_t&, const stm_rect_t&);
+  bool DrawRect       (const stm_blitter_operation_t&, const stm_rect_t&);
+  bool CopyRect       (const stm_blitter_operation_t&, const stm_rect_t&, const stm_point_t&);
+  bool CopyRectComplex(const stm_blitter_operation_t&, const stm_rect_t&, const stm_rect_t&);
+
+private:
+  ULONG  m_ulPhysicalBase;
+  UCHAR *m_pVirtualBase;
+  ULONG  m_ulSize;
+
+  UCHAR *MapExtent(ULONG first, ULONG last, void **mapping) const;
+
+  bool MapRects(const stm_blitter_operation_t &op,
+                const stm_rect_t              &dst,
+                const stm_rect_t              *src,
+                UCHAR                        **pDst,
+                UCHAR                        **pSrc,
+                void                          *mappings[2]) const;
+  void UnmapRects(void *mappings[2]) const;
+
+  bool PixelOperation(const stm_blitter_operation_t &op,
+                      const stm_rect_t              &dst,
+                      const stm_rect_t              *src,
+                      ULONG                          validOps);
+
+  CSTmSWBlitter(const CSTmSWBlitter&);
+  CSTmSWBlitter& operator=(const CSTmSWBlitter&);
+};
+
+#endif // _STM_SW_BLITTER_H
@@ -178,6 +178,7 @@ void CSTmV29IFrames::UpdateFrame(void)
     {
       stm_hdmi_info_frame_t *i = (stm_hdmi_info_frame_t*)&m->data[0];
       WriteInfoFrameHelper(0,i);
+      InvalidateTransmissionSlot(0);
 
       /*
        * Only enable the slot in field mode if the output is transmitting HDMI.
@@ -332,6 +333,7 @@ void CSTmV29IFrames::ProcessInfoFrameComplete(ULONG interruptStatus)
   {
     stm_hdmi_info_frame_t *i = (stm_hdmi_info_frame_t*)&m->data[0];
     WriteInfoFrameHelper(0,i);
+    InvalidateTransmissionSlot(0);
     stm_meta_data_release(m);
   }
   /*
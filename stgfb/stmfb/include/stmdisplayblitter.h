@@ -207,6 +207,12 @@ typedef struct
 
   void (*Release)(stm_display_blitter_t *);
 
+  /*
+   * Added after Release so the existing slots keep their offsets
+   */
+  int (*FillRects)     (stm_display_blitter_t *, const stm_blitter_operation_t *, const stm_rect_t *, int);
+  int (*CopyRects)     (stm_display_blitter_t *, const stm_blitter_operation_t *, const stm_rect_t *, const stm_point_t *, int);
+
 } stm_display_blitter_ops_t;
 
 
@@ -283,6 +289,55 @@ static inline int stm_display_blitter_fill_rect(stm_display_blitter_t   *b,
 }
 
 
+/*
+ * int stm_display_blitter_fill_rects(stm_display_blitter_t   *b,
+ *                                    stm_blitter_operation_t *o,
+ *                                    stm_rect_t              *d,
+ *                                    int                      n)
+ *
+ * Queue fills of n rectangles with the same operation on the blitter. This
+ * is cheaper than n calls to stm_display_blitter_fill_rect as the blitter
+ * can queue the whole list at once. The call does not wait for the
+ * operations to complete.
+ *
+ * Returns -1 if the device lock cannot be obtained or an operation could
+ * not be queued, otherwise it returns 0.
+ *
+ */
+static inline int stm_display_blitter_fill_rects(stm_display_blitter_t   *b,
+                                                 stm_blitter_operation_t *o,
+                                                 stm_rect_t              *d,
+                                                 int                      n)
+{
+  return b->ops->FillRects(b, o, d, n);
+}
+
+
+/*
+ * int stm_display_blitter_copy_rects(stm_display_blitter_t   *b,
+ *                                    stm_blitter_operation_t *o,
+ *                                    stm_rect_t              *d,
+ *                                    stm_point_t             *s,
+ *                                    int                      n)
+ *
+ * Queue copies of n rectangles with the same operation on the blitter, the
+ * rectangle d[i] is copied from the same size area at s[i] in the source
+ * surface. The call does not wait for the operations to complete.
+ *
+ * Returns -1 if the device lock cannot be obtained or an operation could
+ * not be queued, otherwise it returns 0.
+ *
+ */
+static inline int stm_display_blitter_copy_rects(stm_display_blitter_t   *b,
+                                                 stm_blitter_operation_t *o,
+                                                 stm_rect_t              *d,
+                                                 stm_point_t             *s,
+                                                 int                      n)
+{
+  return b->ops->CopyRects(b, o, d, s, n);
+}
+
+
 /*
  * int stm_display_blitter_sync(stm_display_blitter_t *b)
  *
@@ -67,8 +67,9 @@ static irqreturn_t stmcore_vsync_interrupt(int irq, void* data)
     // This was a vtimer callback interrupt (and the main driver has already handled it)
     return IRQ_HANDLED;
 
-  wake_up_interruptible(&runtime->vsync_wait_queue);
+  /* Count first, so a woken waiter sees this vsync */
   atomic_inc (&runtime->vsync_count);
+  wake_up_interruptible(&runtime->vsync_wait_queue);
 
   stm_display_update(pd->device, runtime->main_output);
 
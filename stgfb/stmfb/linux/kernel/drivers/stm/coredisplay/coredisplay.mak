@@ -26,6 +26,7 @@ STM_COMMON := $(addprefix $(SRC_TOPDIR)/STMCommon/,                            \
 			stmfsynth.cpp                                          \
 			stmvtg.cpp                                             \
 			stmblitter.cpp                                         \
+			stmswblitter.cpp                                       \
 			stmteletext.cpp)
 
 STM_HDMI_COMMON := $(addprefix $(SRC_TOPDIR)/STMCommon/,                       \
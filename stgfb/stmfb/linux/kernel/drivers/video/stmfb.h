@@ -398,6 +398,27 @@ struct stmfbio_plane_pan
 	unsigned long baseaddr;
 };
 
+/*
+ * Flip to a new frame giving the areas it changed. The plane is panned to
+ * baseaddr, as for STMFBIO_PAN_PLANE, and once the new frame is on the
+ * display the damaged areas are copied with the blitter from it into the
+ * buffer displayed before. That buffer then holds the new frame too and
+ * can be drawn into as the next back buffer by redrawing only what
+ * changes. No rectangles means the whole frame changed. The copies are queued on the blitter, sync it
+ * before drawing into the buffer with the CPU. If the copy could not be
+ * queued (EIO, or EINTR when a signal interrupted it) the flip has still
+ * been done, but the previous buffer must be redrawn in full.
+ */
+#define STMFBIO_MAX_DAMAGE_RECTS 16
+
+struct stmfbio_damage
+{
+	__u32 layerid; /* must be 0 (for now) */
+	unsigned long baseaddr;
+	__u32 num_rects;
+	struct stmfbio_plane_rect rects[STMFBIO_MAX_DAMAGE_RECTS];
+};
+
 struct stmfbio_var_screeninfo_ex
 {
   /*
@@ -753,6 +774,7 @@ typedef volatile struct
                                                             upon next node interrupt, not necessarily LNA */
 #define STMFBIO_GET_BLTLOAD             _IOR ('B', 0x1a, unsigned long)
 #define STMFBIO_BLITTER_KICK            _IOW ('B', 0x1a, unsigned long)
+#define STMFBIO_DAMAGE_FLIP             _IOW ('B', 0x1b, struct stmfbio_damage)
 #define STMFBIO_BLT                     _IOW ('B', 0x3,  STMFBIO_BLT_DATA)
 #define STMFBIO_SET_BLITTER_PALETTE     _IOW ('B', 0x4,  STMFBIO_PALETTE)
 #define STMFBIO_SYNC_BLITTER            _IO  ('B', 0x5)
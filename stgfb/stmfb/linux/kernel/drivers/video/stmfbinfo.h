@@ -78,6 +78,13 @@ struct stmfb_info {
   /* framebuffer plane buffer descriptor for the current display setup */
   stm_display_buffer_t   current_buffer_setup;
 
+  /* damage flip statistics */
+  unsigned long          damage_flips;         /* flips through STMFBIO_DAMAGE_FLIP                        */
+  unsigned long          damage_full_copies;   /* flips that copied the whole frame                        */
+  unsigned long          damage_rects;         /* rectangles copied                                        */
+  unsigned long long     damage_pixels;        /* pixels copied                                            */
+  unsigned long          damage_last_pixels;   /* pixels copied by the last flip                           */
+
   /*
    * Linux framebuffer stuff
    */
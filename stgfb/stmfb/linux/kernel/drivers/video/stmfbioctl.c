@@ -926,6 +926,161 @@ exit:
 }
 
 
+#define DAMAGE_AREA(r) (((r).right - (r).left) * ((r).bottom - (r).top))
+
+/*
+ * Join damaged rectangles whose bounding box is no bigger than the two of
+ * them apart, so overlapping areas are copied once. Returns the number of
+ * rectangles left.
+ */
+static int stmfbio_merge_damage(stm_rect_t *rects, int n)
+{
+  stm_rect_t box;
+  int        merged;
+  int        a, b;
+
+  do
+  {
+    merged = 0;
+    for(a = 0; a < n; a++)
+    {
+      for(b = a+1; b < n; b++)
+      {
+        box.left   = min(rects[a].left,   rects[b].left);
+        box.top    = min(rects[a].top,    rects[b].top);
+        box.right  = max(rects[a].right,  rects[b].right);
+        box.bottom = max(rects[a].bottom, rects[b].bottom);
+
+        if(DAMAGE_AREA(box) <= DAMAGE_AREA(rects[a]) + DAMAGE_AREA(rects[b]))
+        {
+          rects[a] = box;
+          rects[b--] = rects[--n];
+          merged = 1;
+        }
+      }
+    }
+  } while(merged);
+
+  return n;
+}
+
+
+static int stmfbio_damage_flip(struct stmfb_info *i, const struct stmfbio_damage *damage)
+{
+  struct stmcore_display_pipeline_data *pd = *((struct stmcore_display_pipeline_data **)i->platformDevice->dev.platform_data);
+  const struct stmfbio_plane_config *c = &i->current_planeconfig;
+  struct stmfbio_plane_pan pan;
+  stm_blitter_operation_t  op = {0};
+  stm_rect_t               rects[STMFBIO_MAX_DAMAGE_RECTS];
+  stm_point_t              points[STMFBIO_MAX_DAMAGE_RECTS];
+  unsigned long            previous;
+  unsigned long            pixels;
+  int                      n, r, ret;
+  int                      vsyncs;
+
+  if (damage->layerid != 0 || damage->num_rects > STMFBIO_MAX_DAMAGE_RECTS)
+    return -EINVAL;
+
+  if (!i->pBlitter)
+    return -ENODEV;
+
+  if (i->current_planeconfig_valid != 1)
+    return -ESPIPE;
+
+  previous = c->baseaddr;
+
+  pan.layerid  = damage->layerid;
+  pan.activate = STMFBIO_ACTIVATE_IMMEDIATE;
+  pan.baseaddr = damage->baseaddr;
+
+  if ((ret = stmfb_set_plane_pan (&pan, i)) != 0)
+    return ret;
+
+  if (damage->baseaddr == previous)
+    return 0;
+
+  /*
+   * The pan only takes the new address to the plane on the next vsync and
+   * the hardware reads it from the one after, until then previous is still
+   * being displayed. Wait for both before copying into it. The timeout is
+   * for a display that is not running, where there is nothing to tear.
+   * The pan cannot be undone, so a signal only cuts the wait short, the
+   * copy is still done rather than leave previous a frame behind.
+   */
+  vsyncs = atomic_read (&pd->display_runtime->vsync_count);
+  wait_event_interruptible_timeout (pd->display_runtime->vsync_wait_queue,
+                                    (atomic_read (&pd->display_runtime->vsync_count) - vsyncs) >= 2,
+                                    HZ/5);
+
+  /*
+   * Clip the damage to the plane. When most of the frame changed a single
+   * copy of all of it is cheaper than the pieces.
+   */
+  pixels = 0;
+  for (n = 0, r = 0; r < damage->num_rects; r++)
+  {
+    const struct stmfbio_plane_rect *d = &damage->rects[r];
+
+    if (d->x >= c->source.w || d->y >= c->source.h || !d->dim.w || !d->dim.h)
+      continue;
+
+    rects[n].left   = d->x;
+    rects[n].top    = d->y;
+    rects[n].right  = (d->dim.w > c->source.w - d->x) ? c->source.w : d->x + d->dim.w;
+    rects[n].bottom = (d->dim.h > c->source.h - d->y) ? c->source.h : d->y + d->dim.h;
+    n++;
+  }
+
+  n = stmfbio_merge_damage (rects, n);
+
+  for (r = 0; r < n; r++)
+    pixels += DAMAGE_AREA (rects[r]);
+
+  if (damage->num_rects == 0 || pixels > (c->source.w * c->source.h / 4) * 3)
+  {
+    rects[0].left   = 0;
+    rects[0].top    = 0;
+    rects[0].right  = c->source.w;
+    rects[0].bottom = c->source.h;
+    pixels = c->source.w * c->source.h;
+    n = 1;
+    i->damage_full_copies++;
+  }
+
+  i->damage_flips++;
+  i->damage_last_pixels = pixels;
+
+  if (n == 0)
+    return 0;
+
+  for (r = 0; r < n; r++)
+  {
+    points[r].x = rects[r].left;
+    points[r].y = rects[r].top;
+  }
+
+  op.ulFlags = STM_BLITTER_FLAGS_NONE;
+
+  op.srcSurface.ulMemory = damage->baseaddr;
+  op.srcSurface.ulSize   = c->pitch * c->source.h;
+  op.srcSurface.ulWidth  = c->source.w;
+  op.srcSurface.ulHeight = c->source.h;
+  op.srcSurface.ulStride = c->pitch;
+  op.srcSurface.format   = c->format;
+
+  op.dstSurface          = op.srcSurface;
+  op.dstSurface.ulMemory = previous;
+
+  if (stm_display_blitter_copy_rects (i->pBlitter, &op, rects, points, n) < 0)
+    return -EIO;
+
+  i->damage_rects  += n;
+  i->damage_pixels += pixels;
+
+  return 0;
+}
+
+
 int stmfb_ioctl(struct fb_info* fb, u_int cmd, u_long arg)
 {
   struct stmfb_info* i = (struct stmfb_info* )fb;
@@ -1121,6 +1276,34 @@ int stmfb_ioctl(struct fb_info* fb, u_int cmd, u_long arg)
       }
       break;
 
+    case STMFBIO_DAMAGE_FLIP:
+      {
+      struct stmfbio_damage damage;
+      int                   ret;
+
+      if (copy_from_user (&damage, (void *) arg, sizeof (damage)))
+        return -EFAULT;
+
+      if (down_interruptible (&i->framebufferLock))
+        return -ERESTARTSYS;
+
+      i->fbdev_api_suspended = 1;
+
+      ret = stmfbio_damage_flip (i, &damage);
+
+      up (&i->framebufferLock);
+
+      /*
+       * Not restarted, by then the pan has been done and a second call
+       * would find nothing to copy.
+       */
+      if (ret == -EIO && signal_pending (current))
+        return -EINTR;
+
+      return ret;
+      }
+      break;
+
     case STMFBIO_GET_VAR_SCREENINFO_EX:
     {
       DPRINTK("STMFBIO_GET_VAR_SCREENINFO_EX\n");
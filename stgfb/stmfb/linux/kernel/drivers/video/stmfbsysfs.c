@@ -77,9 +77,29 @@ static ssize_t show_cea861(struct device           *device,
         return __show_cea861(display_modes, num_modes, STM_WSS_OFF, buf);
 }
 
+static ssize_t show_damage(struct device           *device,
+                           struct device_attribute *attr,
+                           char                    *buf)
+{
+        struct stmfb_info *info = dev_get_drvdata(device);
+        unsigned long frame = 0;
+
+        if (info->current_planeconfig_valid)
+                frame = info->current_planeconfig.source.w
+                        * info->current_planeconfig.source.h;
+
+        return snprintf(buf, PAGE_SIZE,
+                        "flips %lu\nfull copies %lu\nrects %lu\n"
+                        "pixels %llu\nlast pixels %lu\nframe pixels %lu\n",
+                        info->damage_flips, info->damage_full_copies,
+                        info->damage_rects, info->damage_pixels,
+                        info->damage_last_pixels, frame);
+}
+
 static struct device_attribute stmfb_device_attrs[] = {
         /*__ATTR(bits_per_pixel, S_IRUGO|S_IWUSR, show_bpp, store_bpp), (R/W EXAMPLE) */
         __ATTR(_ST_cea861, S_IRUGO, show_cea861, NULL),
+        __ATTR(_ST_damage, S_IRUGO, show_damage, NULL),
 };
 
 
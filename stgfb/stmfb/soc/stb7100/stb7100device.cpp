@@ -282,7 +282,7 @@ bool CSTb7100Device::Create()
   if(!CreateOutputs(sharedPlane))
     return false;
 
-  if(!CreateGraphics())
+  if(!CreateGraphics() && !CreateSoftwareBlitter())
     return false;
 
 
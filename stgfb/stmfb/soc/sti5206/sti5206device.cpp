@@ -113,7 +113,7 @@ bool CSTi5206Device::Create()
   if(!CreateOutputs())
     return false;
 
-  if(!CreateGraphics())
+  if(!CreateGraphics() && !CreateSoftwareBlitter())
     return false;
 
   if(!CGenericGammaDevice::Create())
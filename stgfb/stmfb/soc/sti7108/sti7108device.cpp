@@ -113,7 +113,7 @@ bool CSTi7108Device::Create()
   if(!CreateOutputs())
     return false;
 
-  if(!CreateGraphics())
+  if(!CreateGraphics() && !CreateSoftwareBlitter())
     return false;
 
   if(!CGenericGammaDevice::Create())
@@ -140,7 +140,7 @@ bool CSTi7111Device::Create()
   if(!CreateOutputs())
     return false;
 
-  if(!CreateGraphics())
+  if(!CreateGraphics() && !CreateSoftwareBlitter())
     return false;
 
   if(!CGenericGammaDevice::Create())